@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests warpx.do_comm_overlap.
+# inputs_3d is run on several boxes with the guard cell exchanges overlapped with the
+# field push (warpx.do_comm_overlap = 1) and without (warpx.do_comm_overlap = 0).
+# Both perform the same operations on each cell, so that the fields must be identical.
+
+import glob
+import os
+import sys
+
+import numpy as np
+import yt
+
+yt.funcs.mylog.setLevel(50)
+
+max_step = 50
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz']
+
+def run(executable, overlap):
+    prefix = 'diags/comm_overlap_{}/plt'.format(overlap)
+    cmd = ('./{} inputs_3d max_step={} amr.n_cell=16 16 128 amr.max_grid_size=16 '
+           'amr.blocking_factor=8 warpx.do_comm_overlap={} '
+           'diag1.intervals={} diag1.file_prefix={} diag1.fields_to_plot={}').format(
+        executable, max_step, overlap, max_step, prefix, ' '.join(fields))
+    assert os.system(cmd) == 0
+    ds = yt.load('{}{:06d}'.format(prefix, max_step))
+    return ds.covering_grid(level=0, left_edge=ds.domain_left_edge,
+                            dims=ds.domain_dimensions)
+
+def main():
+    executables = glob.glob('*.ex')
+    assert len(executables) == 1
+    blocking = run(executables[0], 0)
+    overlapped = run(executables[0], 1)
+    for field in fields:
+        a = blocking[('mesh', field)].v
+        b = overlapped[('mesh', field)].v
+        print(field + ': max |blocking| = ' + str(np.max(np.abs(a))) +
+              ', max |overlapped - blocking| = ' + str(np.max(np.abs(b - a))))
+        assert np.array_equal(a, b)
+    # the fields are non-zero
+    assert np.max(np.abs(blocking[('mesh', 'Ey')].v)) > 0.
+    print('Passed')
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests the DFT and TimeSeries diagnostics and the binary output of the FieldProbe.
+# inputs_3d is run once with a Full diagnostic written at every step, used as reference:
+# - The DFT written at the last step must be the sum over all the steps of the instantaneous
+#   fields times exp(-2 i pi f t) dt.
+# - The TimeSeries files must contain one record for each sampled step (and not the last step
+#   twice), equal to the instantaneous fields.
+# - A FieldProbe buffered in memory and written to a binary file must give the same data as
+#   the same FieldProbe written to a text file at each output step.
+
+import glob
+import os
+import sys
+
+import numpy as np
+import yt
+
+yt.funcs.mylog.setLevel(50)
+
+max_step = 20
+ts_interval = 2
+probe_interval = 2
+frequencies = [4.7e12, 1.e13]
+fields = ['Ey', 'Bx']
+probe = ('probe_geometry=Line x_probe=1.e-6 y_probe=1.e-6 z_probe=-400.e-6 '
+         'x1_probe=1.e-6 y1_probe=1.e-6 z1_probe=400.e-6 resolution=41 intervals={}'
+         ).format(probe_interval)
+args = ('max_step={0} amr.n_cell=16 16 128 amr.max_grid_size=32 amr.blocking_factor=16 '
+        'diagnostics.diags_names=inst dft ts '
+        'inst.intervals=1 inst.diag_type=Full inst.fields_to_plot={1} inst.file_prefix=diags/inst '
+        'dft.intervals={0} dft.diag_type=DFT dft.fields_to_plot={1} dft.file_prefix=diags/dft '
+        'dft.frequencies={2} '
+        'ts.intervals={3} ts.diag_type=TimeSeries ts.fields_to_plot={1} ts.file_prefix=diags/ts '
+        'ts.buffer_size=3 '
+        'warpx.reduced_diags_names=probe_txt probe_bin '
+        'probe_txt.type=FieldProbe {4} '
+        'probe_bin.type=FieldProbe probe_bin.buffer_size=4 {5}'
+        ).format(max_step, ' '.join(fields), ' '.join(str(f) for f in frequencies), ts_interval,
+                 ' '.join('probe_txt.' + p for p in probe.split()),
+                 ' '.join('probe_bin.' + p for p in probe.split()))
+
+def load(prefix, step):
+    ds = yt.load('diags/{}{:06d}'.format(prefix, step))
+    return ds, ds.covering_grid(level=0, left_edge=ds.domain_left_edge,
+                                dims=ds.domain_dimensions)
+
+def check_dft(inst, times):
+    _, dft = load('dft', max_step)
+    dt = times[1] - times[0]
+    for field in fields:
+        for ifreq, f in enumerate(frequencies):
+            expected = sum(inst[step][field] * np.exp(-2.j*np.pi*f*times[step]) * dt
+                           for step in range(max_step+1))
+            scale = np.max(np.abs(expected))
+            a = (dft[('mesh', '{}_dft{}_re'.format(field, ifreq))].v +
+                 1.j*dft[('mesh', '{}_dft{}_im'.format(field, ifreq))].v)
+            print('{} at {} Hz: max |expected| = {}, max |dft - expected| = {}'.format(
+                field, f, scale, np.max(np.abs(a - expected))))
+            assert scale > 0.
+            assert np.allclose(a, expected, rtol=1.e-9, atol=1.e-9*scale)
+
+def check_time_series(inst, times):
+    header = {}
+    records = []
+    with open('diags/ts.idx') as f:
+        for line in f:
+            if line.startswith('#'):
+                words = line[1:].split()
+                if words:
+                    header[words[0]] = words[1:]
+            else:
+                step, time, offset = line.split()
+                records.append((int(step), float(time), int(offset)))
+    real_size = int(header['real_size'][0])
+    ncells = [int(n) for n in header['ncells']]
+    names = header['fields']
+    assert names == fields
+
+    # one record per sampled step, the last step only once
+    steps = [r[0] for r in records]
+    print('TimeSeries steps: ' + str(steps))
+    assert steps == list(range(0, max_step+1, ts_interval))
+
+    data = np.fromfile('diags/ts.bin', dtype='f{}'.format(real_size))
+    npts = np.prod(ncells)
+    assert data.size == len(records) * len(fields) * npts
+    for step, time, offset in records:
+        assert np.isclose(time, times[step], rtol=1.e-12)
+        start = offset // real_size
+        for n, field in enumerate(fields):
+            sample = data[start + n*npts: start + (n+1)*npts].reshape(ncells, order='F')
+            assert np.array_equal(sample, inst[step][field])
+
+def read_probe_text(path):
+    # one line per probe point and output step: step, time, x, y, z and the fields
+    values = np.atleast_2d(np.loadtxt(path))
+    out = {}
+    for step in np.unique(values[:, 0]).astype(int):
+        out[step] = values[values[:, 0] == step, 2:]
+    return out
+
+def read_probe_binary(path, noutputs):
+    out = {}
+    with open(path, 'rb') as f:
+        while True:
+            head = f.read(16)
+            if not head:
+                break
+            step, nprobes = np.frombuffer(head, dtype=np.int64)
+            np.frombuffer(f.read(8), dtype=np.float64)
+            out[int(step)] = np.frombuffer(f.read(8*nprobes*noutputs),
+                                           dtype=np.float64).reshape(nprobes, noutputs)
+    return out
+
+def sort_by_position(values):
+    return values[np.lexsort((values[:, 2], values[:, 1], values[:, 0]))]
+
+def check_field_probe():
+    text = read_probe_text('diags/reducedfiles/probe_txt.txt')
+    noutputs = next(iter(text.values())).shape[1]
+    binary = read_probe_binary('diags/reducedfiles/probe_bin.bin', noutputs)
+    print('FieldProbe steps: text ' + str(sorted(text)) + ', binary ' + str(sorted(binary)))
+    assert sorted(binary) == sorted(text)
+    assert set(range(probe_interval, max_step+1, probe_interval)) <= set(text)
+    for step in text:
+        a = sort_by_position(text[step])
+        b = sort_by_position(binary[step])
+        assert a.shape == b.shape and a.shape[0] == 41
+        assert np.allclose(b, a, rtol=1.e-12, atol=1.e-12*np.max(np.abs(a)))
+    # the buffered probe only writes the header to the text file
+    with open('diags/reducedfiles/probe_bin.txt') as f:
+        assert all(line.startswith('#') for line in f)
+
+def main():
+    executables = glob.glob('*.ex')
+    assert len(executables) == 1
+    cmd = './{} inputs_3d {}'.format(executables[0], args)
+    assert os.system(cmd) == 0
+
+    inst = []
+    times = []
+    for step in range(max_step+1):
+        ds, data = load('inst', step)
+        inst.append({field: data[('mesh', field)].v for field in fields})
+        times.append(float(ds.current_time))
+
+    check_dft(inst, times)
+    check_time_series(inst, times)
+    check_field_probe()
+    print('Passed')
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests the static part of the checkpoints (<diag>.split_static_data = 1).
+# - The same run with two different BoxArrays must write the same static directory, whose
+#   name is a hash of the content of the static data.
+# - The checkpoints must not contain the static data.
+# - A restart reading the static data must give the same fields as the original run.
+
+import glob
+import os
+import sys
+
+import numpy as np
+import yt
+
+yt.funcs.mylog.setLevel(50)
+
+max_step = 10
+chk_step = 5
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz']
+# non-uniform permittivity, so that the static data does not only hold one value
+common = ('max_step={} diagnostics.diags_names=diag1 chk '
+          'diag1.intervals={} diag1.diag_type=Full diag1.fields_to_plot={} '
+          'chk.intervals={} chk.diag_type=Full chk.format=checkpoint chk.split_static_data=1 '
+          "'macroscopic.epsilon_function(x,y,z)=8.8541878128e-12*(1.5+0.5*cos(2*pi*z/wavelength))'"
+          ).format(max_step, max_step, ' '.join(fields), chk_step)
+
+def run(executable, name, options):
+    cmd = ('./{} inputs_3d {} diag1.file_prefix=diags/{}/plt chk.file_prefix=diags/{}/chk {}').format(
+        executable, common, name, name, options)
+    assert os.system(cmd) == 0
+
+def load(name):
+    ds = yt.load('diags/{}/plt{:06d}'.format(name, max_step))
+    return ds.covering_grid(level=0, left_edge=ds.domain_left_edge,
+                            dims=ds.domain_dimensions)
+
+def static_dirs(name):
+    return sorted(os.path.basename(d) for d in glob.glob('diags/{}/chk_static_*'.format(name)))
+
+def main():
+    executables = glob.glob('*.ex')
+    assert len(executables) == 1
+    run(executables[0], 'large_boxes', 'amr.max_grid_size=512')
+    run(executables[0], 'small_boxes', 'amr.max_grid_size=64')
+
+    # the hash of the static data does not depend on the BoxArray
+    print('static directories: ' + str(static_dirs('large_boxes')) + ' ' + str(static_dirs('small_boxes')))
+    assert len(static_dirs('large_boxes')) == 1
+    assert static_dirs('large_boxes') == static_dirs('small_boxes')
+    static_dir = glob.glob('diags/large_boxes/chk_static_*')[0]
+    assert os.path.isfile(os.path.join(static_dir, 'WarpXStaticHeader'))
+    assert glob.glob(os.path.join(static_dir, 'Level_0', 'epsilon*'))
+
+    # the checkpoints only reference the static data
+    chk = 'diags/large_boxes/chk{:05d}'.format(chk_step)
+    with open(os.path.join(chk, 'StaticData')) as f:
+        assert f.read().strip() == os.path.basename(static_dir)
+    assert not glob.glob(os.path.join(chk, 'Level_0', 'epsilon*'))
+
+    # restart in the same directory, the static data is read and not written again
+    restart_options = 'amr.max_grid_size=512 amr.restart={} diag1.file_prefix=diags/restart/plt'.format(chk)
+    cmd = ('./{} inputs_3d {} chk.file_prefix=diags/large_boxes/chk {}').format(
+        executables[0], common, restart_options)
+    assert os.system(cmd) == 0
+    assert len(static_dirs('large_boxes')) == 1
+
+    original = load('large_boxes')
+    restarted = load('restart')
+    for field in fields:
+        a = original[('mesh', field)].v
+        b = restarted[('mesh', field)].v
+        print(field + ': max |original| = ' + str(np.max(np.abs(a))) +
+              ', max |restarted - original| = ' + str(np.max(np.abs(b - a))))
+        assert np.array_equal(a, b)
+    print('Passed')
+
+if __name__ == '__main__':
+    sys.exit(main())
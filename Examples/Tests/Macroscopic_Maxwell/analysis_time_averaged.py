@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests the TimeAveraged diagnostics.
+# - The mean and root mean square written at the end of the window must be those of the
+#   instantaneous fields written at every step of the window by a Full diagnostic.
+# - A run restarted in the middle of the window must write the same averages, the
+#   accumulated fields being stored in the checkpoint.
+
+import glob
+import os
+import sys
+
+import numpy as np
+import yt
+
+yt.funcs.mylog.setLevel(50)
+
+max_step = 20
+chk_step = 10
+fields = ['Ey', 'Bx']
+common = ('max_step={} amr.n_cell=16 16 128 amr.max_grid_size=32 amr.blocking_factor=16 '
+          'diagnostics.diags_names=inst avg chk '
+          'inst.intervals=1 inst.diag_type=Full inst.fields_to_plot={} '
+          'avg.intervals={} avg.diag_type=TimeAveraged avg.fields_to_plot={} avg.averages=mean rms '
+          'chk.intervals={} chk.diag_type=Full chk.format=checkpoint chk.file_prefix=diags/chk'
+          ).format(max_step, ' '.join(fields), max_step, ' '.join(fields), chk_step)
+
+def load(prefix, step):
+    ds = yt.load('diags/{}{:06d}'.format(prefix, step))
+    return ds.covering_grid(level=0, left_edge=ds.domain_left_edge,
+                            dims=ds.domain_dimensions)
+
+def main():
+    executables = glob.glob('*.ex')
+    assert len(executables) == 1
+    cmd = './{} inputs_3d {} inst.file_prefix=diags/inst avg.file_prefix=diags/avg'.format(
+        executables[0], common)
+    assert os.system(cmd) == 0
+    cmd = ('./{} inputs_3d {} amr.restart=diags/chk{:05d} inst.file_prefix=diags/restart_inst '
+           'avg.file_prefix=diags/restart_avg').format(executables[0], common, chk_step)
+    assert os.system(cmd) == 0
+
+    averages = load('avg', max_step)
+    restarted = load('restart_avg', max_step)
+    for field in fields:
+        # the window is the steps since the previous output, at step 0
+        inst = np.array([load('inst', step)[('mesh', field)].v for step in range(1, max_step+1)])
+        mean = np.mean(inst, axis=0)
+        rms = np.sqrt(np.mean(inst**2, axis=0))
+        scale = np.max(np.abs(inst))
+        for name, expected in [(field + '_mean', mean), (field + '_rms', rms)]:
+            a = averages[('mesh', name)].v
+            b = restarted[('mesh', name)].v
+            print(name + ': max |expected| = ' + str(np.max(np.abs(expected))) +
+                  ', max |average - expected| = ' + str(np.max(np.abs(a - expected))) +
+                  ', max |restarted - average| = ' + str(np.max(np.abs(b - a))))
+            assert np.allclose(a, expected, rtol=1.e-12, atol=1.e-12*scale)
+            assert np.allclose(b, a, rtol=1.e-12, atol=1.e-12*scale)
+    print('Passed')
+
+if __name__ == '__main__':
+    sys.exit(main())
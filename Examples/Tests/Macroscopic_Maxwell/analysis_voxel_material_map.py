@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests macroscopic.use_material_map.
+# A voxel map of three materials, smaller than the domain, is written with the raw and the
+# rle encodings, and inputs_3d is run on several boxes with sigma and epsilon given per
+# material. Each cell must take the properties of the material of the voxel containing its
+# center, or of the closest boundary voxel outside of the map.
+
+import glob
+import os
+import sys
+
+import numpy as np
+import yt
+
+from write_voxel_map import write_voxel_map
+
+yt.funcs.mylog.setLevel(50)
+
+n_cell = np.array([16, 16, 128])
+prob_lo = np.array([-32.e-6, -32.e-6, -512.e-6])
+prob_hi = np.array([32.e-6, 32.e-6, 512.e-6])
+map_lo = np.array([-24.e-6, -28.e-6, -400.e-6])
+map_hi = np.array([24.e-6, 28.e-6, 400.e-6])
+n_voxel = np.array([6, 7, 25])
+eps0 = 8.8541878128e-12
+# vacuum, sapphire, niobium
+epsilon = [eps0, 9.3*eps0, eps0]
+sigma = [0., 0., 1.e3]
+
+def expected(ids, field):
+    dx = (prob_hi - prob_lo)/n_cell
+    index = []
+    for idim in range(3):
+        pos = prob_lo[idim] + (np.arange(n_cell[idim]) + 0.5)*dx[idim]
+        voxel_size = (map_hi[idim] - map_lo[idim])/n_voxel[idim]
+        v = np.floor((pos - map_lo[idim])/voxel_size).astype(int)
+        index.append(np.clip(v, 0, n_voxel[idim] - 1))
+    cell_ids = ids[np.ix_(index[0], index[1], index[2])]
+    return np.array(field)[cell_ids]
+
+def run(executable, encoding):
+    filename = 'voxel_map_{}.vmap'.format(encoding)
+    prefix = 'diags/voxel_map_{}/plt'.format(encoding)
+    cmd = ('./{} inputs_3d max_step=1 amr.n_cell={} amr.max_grid_size=16 amr.blocking_factor=8 '
+           'macroscopic.use_material_map=1 material_map.file={} '
+           'material_map.materials=vacuum sapphire niobium '
+           'material_map.sapphire.epsilon={} material_map.niobium.sigma={} '
+           'diag1.intervals=1 diag1.file_prefix={} diag1.fields_to_plot=sigma epsilon').format(
+        executable, ' '.join(str(n) for n in n_cell), filename, epsilon[1], sigma[2], prefix)
+    assert os.system(cmd) == 0
+    ds = yt.load('{}{:06d}'.format(prefix, 1))
+    return ds.covering_grid(level=0, left_edge=ds.domain_left_edge,
+                            dims=ds.domain_dimensions)
+
+def main():
+    executables = glob.glob('*.ex')
+    assert len(executables) == 1
+    rng = np.random.default_rng(seed=1)
+    ids = rng.integers(0, 3, size=n_voxel).astype(np.uint8)
+    # long runs along x, as in circuits
+    ids[:, 2:5, :] = 1
+    for encoding in ['raw', 'rle']:
+        write_voxel_map('voxel_map_{}.vmap'.format(encoding), ids, map_lo, map_hi, encoding)
+    for encoding in ['raw', 'rle']:
+        data = run(executables[0], encoding)
+        for name, values in [('epsilon', epsilon), ('sigma', sigma)]:
+            a = data[('mesh', name)].v
+            b = expected(ids, values)
+            print(encoding + ' ' + name + ': max |expected| = ' + str(np.max(np.abs(b))) +
+                  ', max |' + name + ' - expected| = ' + str(np.max(np.abs(a - b))))
+            assert np.allclose(a, b, rtol=1.e-10, atol=0.)
+    print('Passed')
+
+if __name__ == '__main__':
+    sys.exit(main())
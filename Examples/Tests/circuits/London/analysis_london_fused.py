@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests london.fused_update.
+# inputs_london_skin is run with the London current advanced in a separate pass
+# (london.fused_update = 0) and in the macroscopic E-update loop (london.fused_update = 1).
+# Both perform the same operations on each edge, so that the fields must be identical.
+
+import glob
+import os
+import sys
+
+import numpy as np
+import yt
+
+yt.funcs.mylog.setLevel(50)
+
+max_step = 200
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz']
+
+def run(executable, fused):
+    prefix = 'diags/london_fused_{}/plt'.format(fused)
+    cmd = ('./{} inputs_london_skin max_step={} london.fused_update={} '
+           'diag1.intervals={} diag1.file_prefix={} diag1.fields_to_plot={}').format(
+        executable, max_step, fused, max_step, prefix, ' '.join(fields))
+    assert os.system(cmd) == 0
+    ds = yt.load('{}{:06d}'.format(prefix, max_step))
+    return ds.covering_grid(level=0, left_edge=ds.domain_left_edge,
+                            dims=ds.domain_dimensions)
+
+def main():
+    executables = glob.glob('*.ex')
+    assert len(executables) == 1
+    separate = run(executables[0], 0)
+    fused = run(executables[0], 1)
+    for field in fields:
+        a = separate[('mesh', field)].v
+        b = fused[('mesh', field)].v
+        print(field + ': max |separate| = ' + str(np.max(np.abs(a))) +
+              ', max |fused - separate| = ' + str(np.max(np.abs(b - a))))
+        assert np.array_equal(a, b)
+    # the London current is non-zero
+    assert np.max(np.abs(separate[('mesh', 'jy')].v)) > 0.
+    print('Passed')
+
+if __name__ == '__main__':
+    sys.exit(main())
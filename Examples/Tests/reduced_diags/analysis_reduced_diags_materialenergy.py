@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests the reduced diagnostics `MaterialEnergy`.
+# The energies and the loss of each material are computed from the cell-centered
+# fields of the plotfile and the macroscopic properties of the input file, and compared
+# with the values of the reduced diagnostics at the same step.
+
+import sys
+
+import numpy as np
+import scipy.constants as scc
+import yt
+
+yt.funcs.mylog.setLevel(50)
+
+filename = sys.argv[1]
+ds = yt.load(filename)
+ad = ds.covering_grid(level=0, left_edge=ds.domain_left_edge, dims=ds.domain_dimensions)
+dV = np.prod((ds.domain_right_edge - ds.domain_left_edge).v / ds.domain_dimensions)
+
+# Properties of the input file, at the cell centers
+z = ad[('index', 'z')].v
+mu = scc.mu_0
+eps = scc.epsilon_0 * (1. + 3.*(z < 0.))
+sigma = 100. * (z < -64.e-6)
+materials = {'lossy': z < -64.e-6,
+             'dielectric': (z >= -64.e-6) & (z < 0.),
+             'background': z >= 0.}
+
+E2 = sum(ad[('mesh', f)].v**2 for f in ['Ex', 'Ey', 'Ez'])
+B2 = sum(ad[('mesh', f)].v**2 for f in ['Bx', 'By', 'Bz'])
+
+# Columns: step, time, then for each material the electric energy, magnetic energy and loss
+data = np.genfromtxt('./diags/reducedfiles/ME.txt')
+total = 0.5 * np.sum(eps*E2 + B2/mu) * dV
+for imat, (name, cells) in enumerate(materials.items()):
+    expected = [np.sum(0.5*eps*E2*cells)*dV, np.sum(0.5*B2/mu*cells)*dV, np.sum(sigma*E2*cells)*dV]
+    for icol, (col, value) in enumerate(zip(['WE', 'WM', 'loss'], expected)):
+        result = data[-1, 2 + 3*imat + icol]
+        print(name + '_' + col + ': ' + str(result) + ', expected ' + str(value))
+        # the losses of the lossless materials are zero
+        scale = total if col != 'loss' else max(value, 1.e-300)
+        assert abs(result - value) <= 1.e-9*scale
+print('Passed')
@@ -0,0 +1,36 @@
+#!/usr/bin/env python3
+
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests the reduced diagnostics `PoyntingFlux`.
+# The setup is a Gaussian plane pulse propagating along +z in a periodic domain.
+# By the end of the simulation, the pulse has crossed each of the two ports
+# (at z = 0 and on the upper face of the domain) exactly once, so that the energy
+# that flowed through each port is the electromagnetic energy of the pulse.
+
+import numpy as np
+import scipy.constants as scc
+
+# Parameters of the input file
+E0 = 1.e5
+L = 16.e-6
+Lx = 32.e-6
+Ly = 32.e-6
+
+# Energy of the pulse: the electric and magnetic energies are equal
+energy_theory = scc.epsilon_0 * E0**2 * Lx * Ly * L * np.sqrt(np.pi/2.)
+
+# Columns: step, time, then for each port the instantaneous and the averaged power
+data = np.genfromtxt("./diags/reducedfiles/PF.txt")
+time = data[-1,1]
+tolerance = 0.02
+for iport, name in enumerate(['mid', 'top']):
+    energy = data[-1,3+2*iport] * time
+    error = abs(energy - energy_theory) / energy_theory
+    print(name + ': energy through the port = ' + str(energy) + ' J, theory = '
+          + str(energy_theory) + ' J, relative error = ' + str(error))
+    assert error < tolerance
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests the lossy compression of plotfiles (<diag>.compression = lossy).
+# The same fields are written by a plain plotfile diagnostic and by a quantized one,
+# which must differ by at most <diag>.quantization_tolerance and hold multiples of the
+# quantization step.
+
+import glob
+import os
+import sys
+
+import numpy as np
+import yt
+
+yt.funcs.mylog.setLevel(50)
+
+max_step = 5
+tolerance = 1.e-2
+# largest power of 2 not greater than twice the tolerance
+step = 2.**np.floor(np.log2(2.*tolerance))
+fields = ['Bx', 'By', 'Bz', 'Ex', 'Ey', 'Ez', 'jx', 'jy', 'jz', 'rho']
+
+def load(prefix):
+    ds = yt.load('diags/{}{:06d}'.format(prefix, max_step))
+    # yt 4.0+ has rounding issues with our domain data
+    if 'force_periodicity' in dir(ds): ds.force_periodicity()
+    return ds.covering_grid(level=0, left_edge=ds.domain_left_edge,
+                            dims=ds.domain_dimensions)
+
+def main():
+    executables = glob.glob('*.ex')
+    assert len(executables) == 1
+    cmd = ('./{} inputs max_step={} diagnostics.diags_names=plain lossy '
+           'plain.intervals={} plain.diag_type=Full plain.fields_to_plot={} '
+           'lossy.intervals={} lossy.diag_type=Full lossy.fields_to_plot={} '
+           'lossy.compression=lossy lossy.quantization_tolerance={}').format(
+        executables[0], max_step, max_step, ' '.join(fields),
+        max_step, ' '.join(fields), tolerance)
+    assert os.system(cmd) == 0
+
+    plain = load('plain')
+    lossy = load('lossy')
+    quantized = False
+    for field in fields:
+        a = plain[('mesh', field)].v
+        b = lossy[('mesh', field)].v
+        error = np.max(np.abs(b - a))
+        print(field + ': max |plain| = ' + str(np.max(np.abs(a))) +
+              ', max |lossy - plain| = ' + str(error))
+        assert error <= tolerance
+        assert np.array_equal(b, np.round(b/step)*step)
+        quantized = quantized or not np.array_equal(a, b)
+    # the tolerance is small enough for the fields to be written, large enough to change them
+    assert quantized
+    print('Passed')
+
+if __name__ == '__main__':
+    sys.exit(main())
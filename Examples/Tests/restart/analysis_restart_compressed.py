@@ -0,0 +1,15 @@
+#!/usr/bin/env python3
+
+# This script checks the restart from a compressed checkpoint
+# (chk.compression = lossless): the fields and particles after the restart
+# must be the same as in the original run.
+
+import sys
+
+filename = sys.argv[1]
+
+# Check restart data v. original data
+sys.path.insert(0, '../../../../warpx/Examples/')
+from analysis_default_restart import check_restart
+
+check_restart(filename)
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests the separable grid excitations (warpx.H_excitation_separable = 1).
+# inputs_regression_3d_LLG_filter excites the waveguide with the space-time function
+# Hx(x,y,z,t) = f(x,y,z) g(t), and inputs_3d_LLG_filter_separable with the same f and g
+# given separately. Only the order of the floating-point operations differs, so that the
+# fields must agree to round-off.
+
+import glob
+import os
+import sys
+
+import numpy as np
+import yt
+
+yt.funcs.mylog.setLevel(50)
+
+max_step = 3
+fields = ['Ex', 'Ey', 'Ez', 'Hx', 'Hy', 'Hz', 'Mx_xface', 'My_xface', 'Mz_xface']
+
+def run(executable, inputs, prefix):
+    cmd = './{} {} max_step={} plt.intervals={} plt.file_prefix={}'.format(
+        executable, inputs, max_step, max_step, prefix)
+    assert os.system(cmd) == 0
+    ds = yt.load('{}{:06d}'.format(prefix, max_step))
+    return ds.covering_grid(level=0, left_edge=ds.domain_left_edge,
+                            dims=ds.domain_dimensions)
+
+def main():
+    executables = glob.glob('*.ex')
+    assert len(executables) == 1
+    full = run(executables[0], 'inputs_regression_3d_LLG_filter', 'diags/LLG_filter_full/plt')
+    separable = run(executables[0], 'inputs_3d_LLG_filter_separable', 'diags/LLG_filter_separable/plt')
+    for field in fields:
+        a = full[('mesh', field)].v
+        b = separable[('mesh', field)].v
+        print(field + ': max |full| = ' + str(np.max(np.abs(a))) +
+              ', max |separable - full| = ' + str(np.max(np.abs(b - a))))
+        assert np.allclose(a, b, rtol=1.e-12, atol=1.e-12 * np.max(np.abs(a)))
+    # the excitation is applied
+    assert np.max(np.abs(full[('mesh', 'Hx')].v)) > 0.
+    print('Passed')
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,476 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+/* Microbenchmarks of the field solver kernels (build with WarpX_KERNEL_BENCHMARKS=ON).
+ *
+ * A WarpX instance is set up for a field-only macroscopic simulation (the parameters of
+ * SetDefaultParameters can be overwritten with an inputs file or on the command line), and the
+ * kernels are called kernel_bench.n_repeat times without time stepping. The synthetic MultiFabs
+ * of the inline LLG kernels use the boxes and distribution mapping of the simulation, so the
+ * size and the tiling are set with amr.n_cell, amr.max_grid_size and fabarray.mfiter_tile_size.
+ *
+ * For each kernel, the minimum time per call over all the repetitions is reported, with the
+ * number of cells updated per second and the bandwidth achieved with the compulsory memory
+ * traffic of the kernel (each array element read or written once), compared to the bandwidth
+ * of a STREAM triad a = b + s*c on MultiFabs of the same size.
+ *
+ * On CPUs, the first_touch kernel times the same update of E as MacroscopicEvolveE on two sets of
+ * fields, one set to zero serially after its allocation and one with ThreadPlacement::FirstTouch
+ * (warpx.numa_first_touch = 1), which shows the effect of the NUMA placement of the pages on the
+ * machine used (none if all the threads of a rank run on the same NUMA node).
+ */
+
+#include "WarpX.H"
+
+#include "Evolve/WarpXDtType.H"
+#include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceAlgorithms/CartesianYeeAlgorithm.H"
+#include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#include "Initialization/WarpXAMReXInit.H"
+#include "Parallelization/ThreadPlacement.H"
+#include "Utils/MPIInitHelpers.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXUtil.H"
+
+#include <AMReX.H>
+#include <AMReX_Array4.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_DistributionMapping.H>
+#include <AMReX_FabArrayBase.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuControl.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_Loop.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#if defined(AMREX_USE_MPI)
+#  include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace amrex;
+
+namespace
+{
+    /** Parameters of a periodic, uniform, field-only macroscopic simulation with 128^3 cells,
+     *  used unless they are given in the inputs */
+    void SetDefaultParameters ()
+    {
+        ParmParse pp_geometry("geometry");
+        std::string dims = "3";
+        pp_geometry.queryAdd("dims", dims);
+        if (!pp_geometry.contains("prob_lo")) {
+            pp_geometry.addarr("prob_lo", std::vector<Real>{-64.e-6_rt, -64.e-6_rt, -64.e-6_rt});
+        }
+        if (!pp_geometry.contains("prob_hi")) {
+            pp_geometry.addarr("prob_hi", std::vector<Real>{64.e-6_rt, 64.e-6_rt, 64.e-6_rt});
+        }
+
+        ParmParse pp_amr("amr");
+        if (!pp_amr.contains("n_cell")) {
+            pp_amr.addarr("n_cell", std::vector<int>{128, 128, 128});
+        }
+        int max_level = 0;
+        pp_amr.queryAdd("max_level", max_level);
+
+        ParmParse pp_boundary("boundary");
+        const std::vector<std::string> periodic(3, "periodic");
+        if (!pp_boundary.contains("field_lo")) pp_boundary.addarr("field_lo", periodic);
+        if (!pp_boundary.contains("field_hi")) pp_boundary.addarr("field_hi", periodic);
+
+        ParmParse pp("");
+        int max_step = 0;
+        pp.queryAdd("max_step", max_step);
+
+        ParmParse pp_algo("algo");
+        std::string medium = "macroscopic";
+        pp_algo.queryAdd("em_solver_medium", medium);
+        std::string sigma_method = "laxwendroff";
+        pp_algo.queryAdd("macroscopic_sigma_method", sigma_method);
+
+        ParmParse pp_macroscopic("macroscopic");
+        Real sigma = 1.e3_rt;
+        pp_macroscopic.queryAdd("sigma", sigma);
+        Real epsilon = PhysConst::ep0;
+        pp_macroscopic.queryAdd("epsilon", epsilon);
+        Real mu = PhysConst::mu0;
+        pp_macroscopic.queryAdd("mu", mu);
+#ifdef WARPX_MAG_LLG
+        std::string constant = "constant";
+        std::string Ms_style = constant, alpha_style = constant, gamma_style = constant;
+        pp_macroscopic.queryAdd("mag_Ms_init_style", Ms_style);
+        pp_macroscopic.queryAdd("mag_alpha_init_style", alpha_style);
+        pp_macroscopic.queryAdd("mag_gamma_init_style", gamma_style);
+        Real Ms = 1.4e5_rt, alpha = 0.005_rt, gamma = -1.759e11_rt;
+        pp_macroscopic.queryAdd("mag_Ms", Ms);
+        pp_macroscopic.queryAdd("mag_alpha", alpha);
+        pp_macroscopic.queryAdd("mag_gamma", gamma);
+
+        // required by WarpX with LLG; M is not evolved by the solver in the benchmarks,
+        // so no normalization of its magnitude is needed
+        ParmParse pp_warpx("warpx");
+        int M_normalization = 0;
+        pp_warpx.queryAdd("mag_M_normalization", M_normalization);
+#endif
+    }
+
+    /** Minimum time of one call of kernel over n_repeat calls, after one warm-up call.
+     *  The time of a call is the maximum over the MPI ranks. */
+    template <typename F>
+    Real TimeKernel (int n_repeat, F&& kernel)
+    {
+        kernel();
+        Gpu::synchronize();
+        Real best = std::numeric_limits<Real>::max();
+        for (int i = 0; i < n_repeat; ++i) {
+            ParallelDescriptor::Barrier();
+            const auto start = static_cast<Real>(amrex::second());
+            kernel();
+            Gpu::synchronize();
+            auto elapsed = static_cast<Real>(amrex::second()) - start;
+            ParallelDescriptor::ReduceRealMax(elapsed);
+            best = std::min(best, elapsed);
+        }
+        return best;
+    }
+
+    /** Print the time, cell update rate, bandwidth and fraction of the STREAM bandwidth
+     *  of a kernel that moves bytes_per_cell bytes for each of the ncells cells */
+    void Report (std::string const& name, Long ncells, Real bytes_per_cell,
+                 Real time, Real stream_bandwidth)
+    {
+        const Real cells_per_second = static_cast<Real>(ncells) / time;
+        const Real bandwidth = cells_per_second * bytes_per_cell;
+        Print() << std::left << std::setw(34) << name << std::right
+                << std::setw(12) << std::setprecision(4) << time * 1.e3_rt << " ms"
+                << std::setw(12) << cells_per_second * 1.e-9_rt << " Gcell/s"
+                << std::setw(12) << bandwidth * 1.e-9_rt << " GB/s"
+                << std::setw(10) << 100._rt * bandwidth / stream_bandwidth << " % of STREAM\n";
+    }
+}
+
+// The kernels are in named functions, since GPU lambdas cannot be defined inside
+// the lambdas passed to TimeKernel
+namespace KernelBenchmarks
+{
+    /** a = b + s*c */
+    void StreamTriad (MultiFab& a, MultiFab const& b, MultiFab const& c)
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(a, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            Array4<Real> const& aa = a.array(mfi);
+            Array4<Real const> const& bb = b.const_array(mfi);
+            Array4<Real const> const& cc = c.const_array(mfi);
+            ParallelFor(mfi.tilebox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                aa(i,j,k) = bb(i,j,k) + 0.5_rt * cc(i,j,k);
+            });
+        }
+    }
+
+#ifdef WARPX_MAG_LLG
+    /** Interpolate in (staggering in_stag) to out (staggering out_stag), as for H_eff
+     *  in MacroscopicEvolveHM_2nd */
+    void FaceAvgToFace (MultiFab& out, MultiFab& in, IntVect in_stag, IntVect out_stag)
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(out, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            Array4<Real> const& out_arr = out.array(mfi);
+            Array4<Real> const& in_arr = in.array(mfi);
+            ParallelFor(mfi.tilebox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                out_arr(i,j,k) = MacroscopicProperties::face_avg_to_face(i, j, k, 0, in_stag, out_stag, in_arr);
+            });
+        }
+    }
+
+    /** Three components of M from a and b, as in the second-order LLG iterations */
+    void UpdateM (MultiFab& M, MultiFab& a, MultiFab& b)
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(M, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            Array4<Real> const& M_arr = M.array(mfi);
+            Array4<Real> const& a_arr = a.array(mfi);
+            Array4<Real> const& b_arr = b.array(mfi);
+            ParallelFor(mfi.tilebox(), 3, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                M_arr(i,j,k,n) = MacroscopicProperties::updateM_field(i, j, k, n, a_arr, b_arr);
+            });
+        }
+    }
+
+    /** Laplacian of the three components of M on the x-faces, with the Ms of the neighbors,
+     *  as for the exchange term of H_eff */
+    void LaplacianMag (MultiFab& lapM, MultiFab& M, MultiFab& Ms,
+                       Gpu::DeviceVector<Real> const& d_coefs_x,
+                       Gpu::DeviceVector<Real> const& d_coefs_y,
+                       Gpu::DeviceVector<Real> const& d_coefs_z)
+    {
+        Real const * const AMREX_RESTRICT coefs_x = d_coefs_x.dataPtr();
+        Real const * const AMREX_RESTRICT coefs_y = d_coefs_y.dataPtr();
+        Real const * const AMREX_RESTRICT coefs_z = d_coefs_z.dataPtr();
+        const int n_coefs_x = static_cast<int>(d_coefs_x.size());
+        const int n_coefs_y = static_cast<int>(d_coefs_y.size());
+        const int n_coefs_z = static_cast<int>(d_coefs_z.size());
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(lapM, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            Array4<Real> const& out = lapM.array(mfi);
+            Array4<Real> const& M_arr = M.array(mfi);
+            Array4<Real> const& Ms_arr = Ms.array(mfi);
+            ParallelFor(mfi.tilebox(), 3, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                out(i,j,k,n) = CartesianYeeAlgorithm::Laplacian_Mag(M_arr, coefs_x, coefs_y, coefs_z,
+                    n_coefs_x, n_coefs_y, n_coefs_z,
+                    Ms_arr(i-1,j,k), Ms_arr(i+1,j,k), Ms_arr(i,j-1,k), Ms_arr(i,j+1,k),
+                    Ms_arr(i,j,k-1), Ms_arr(i,j,k+1), i, j, k, n, 0);
+            });
+        }
+    }
+#endif
+
+#ifndef AMREX_USE_GPU
+    /** Set mf to zero, including the guard cells, from the calling thread only, as a serial
+     *  initialization does, so that all its pages are on the NUMA node of this thread */
+    void SerialFirstTouch (MultiFab& mf)
+    {
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            Array4<Real> const& arr = mf.array(mfi);
+            LoopOnCpu(mfi.fabbox(), mf.nComp(), [=] (int i, int j, int k, int n) noexcept {
+                arr(i,j,k,n) = 0._rt;
+            });
+        }
+    }
+
+    /** Lax-Wendroff update of the three components of E from the curl of B, J, sigma and
+     *  epsilon, with the memory traffic of MacroscopicEvolveE. All the fields are cell-centered,
+     *  which does not change the traffic. */
+    void MacroscopicEUpdate (MultiFab& E, MultiFab const& B, MultiFab const& J,
+                             MultiFab const& sigma, MultiFab const& epsilon,
+                             Real dt, GpuArray<Real,AMREX_SPACEDIM> const& inv_dx)
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(E, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            Array4<Real> const& Ea = E.array(mfi);
+            Array4<Real const> const& Ba = B.const_array(mfi);
+            Array4<Real const> const& Ja = J.const_array(mfi);
+            Array4<Real const> const& sig = sigma.const_array(mfi);
+            Array4<Real const> const& eps = epsilon.const_array(mfi);
+            ParallelFor(mfi.tilebox(), [=] (int i, int j, int k) noexcept {
+                const Real fac = 0.5_rt * dt * sig(i,j,k) / eps(i,j,k);
+                const Real alpha = (1._rt - fac) / (1._rt + fac);
+                const Real beta = dt / (eps(i,j,k) * (1._rt + fac));
+                Ea(i,j,k,0) = alpha * Ea(i,j,k,0) + beta * (
+                    inv_dx[1] * (Ba(i,j+1,k,2) - Ba(i,j,k,2))
+                  - inv_dx[2] * (Ba(i,j,k+1,1) - Ba(i,j,k,1)) - Ja(i,j,k,0));
+                Ea(i,j,k,1) = alpha * Ea(i,j,k,1) + beta * (
+                    inv_dx[2] * (Ba(i,j,k+1,0) - Ba(i,j,k,0))
+                  - inv_dx[0] * (Ba(i+1,j,k,2) - Ba(i,j,k,2)) - Ja(i,j,k,1));
+                Ea(i,j,k,2) = alpha * Ea(i,j,k,2) + beta * (
+                    inv_dx[0] * (Ba(i+1,j,k,1) - Ba(i,j,k,1))
+                  - inv_dx[1] * (Ba(i,j+1,k,0) - Ba(i,j,k,0)) - Ja(i,j,k,2));
+            });
+        }
+    }
+#endif
+
+    void Run (WarpX& warpx)
+    {
+        ParmParse pp_bench("kernel_bench");
+        int n_repeat = 10;
+        pp_bench.query("n_repeat", n_repeat);
+        std::vector<std::string> kernels = {"stream_triad",
+#ifdef WARPX_MAG_LLG
+                                            "face_avg_to_face", "updateM_field", "Laplacian_Mag",
+#endif
+                                            "EvolveB", "MacroscopicEvolveE",
+#ifndef AMREX_USE_GPU
+                                            "first_touch",
+#endif
+                                            };
+        pp_bench.queryarr("kernels", kernels);
+        auto const run = [&kernels] (std::string const& name) {
+            return std::find(kernels.begin(), kernels.end(), name) != kernels.end();
+        };
+
+        const int lev = 0;
+        const BoxArray& ba = warpx.boxArray(lev);
+        const DistributionMapping& dm = warpx.DistributionMap(lev);
+        const Long ncells = ba.numPts();
+        const Real dt = warpx.getdt(lev);
+        constexpr auto real_size = static_cast<Real>(sizeof(Real));
+
+        Print() << "\nKernel benchmarks:    | " << ncells << " cells in " << ba.size() << " boxes, tile size "
+                << FabArrayBase::mfiter_tile_size << ", " << n_repeat << " calls per kernel\n";
+#ifdef AMREX_USE_GPU
+        Print() << "                      | GPU, " << ParallelDescriptor::NProcs() << " MPI ranks\n";
+#else
+        Print() << "                      | CPU, " << ParallelDescriptor::NProcs() << " MPI ranks x "
+                << OpenMP::get_max_threads() << " OpenMP threads\n";
+#endif
+        Print() << "                      | sizeof(Real) = " << sizeof(Real) << " bytes\n\n";
+
+        // STREAM triad, used as the reference bandwidth
+        MultiFab a(ba, dm, 1, 0), b(ba, dm, 1, 0), c(ba, dm, 1, 0);
+        a.setVal(0._rt);
+        b.setVal(1._rt);
+        c.setVal(2._rt);
+        const Real t_stream = TimeKernel(n_repeat, [&] () { StreamTriad(a, b, c); });
+        const Real stream_bandwidth = static_cast<Real>(ncells) * 3._rt * real_size / t_stream;
+        if (run("stream_triad")) {
+            Report("STREAM triad", ncells, 3._rt * real_size, t_stream, stream_bandwidth);
+        }
+
+#ifdef WARPX_MAG_LLG
+        // Synthetic face-centered fields with the staggering of M_xface and M_yface
+        const IntVect Mxface_stag(AMREX_D_DECL(1,0,0));
+        const IntVect Myface_stag(AMREX_D_DECL(0,1,0));
+        const BoxArray ba_x = amrex::convert(ba, Mxface_stag);
+        const BoxArray ba_y = amrex::convert(ba, Myface_stag);
+        const Long nfaces = ba_x.numPts();
+
+        if (run("face_avg_to_face")) {
+            // H_y (read) interpolated to the x-faces (written)
+            MultiFab Hy(ba_y, dm, 1, 1), Hy_on_x(ba_x, dm, 1, 0);
+            Hy.setVal(1._rt);
+            const Real t = TimeKernel(n_repeat, [&] () {
+                FaceAvgToFace(Hy_on_x, Hy, Myface_stag, Mxface_stag);
+            });
+            Report("face_avg_to_face", nfaces, 2._rt * real_size, t, stream_bandwidth);
+        }
+
+        if (run("updateM_field")) {
+            // a and b (3 components read), M (3 components written)
+            MultiFab am(ba_x, dm, 3, 0), bm(ba_x, dm, 3, 0), M(ba_x, dm, 3, 0);
+            am.setVal(0.1_rt);
+            bm.setVal(1._rt);
+            const Real t = TimeKernel(n_repeat, [&] () { UpdateM(M, am, bm); });
+            Report("updateM_field", nfaces, 9._rt * real_size, t, stream_bandwidth);
+        }
+
+        if (run("Laplacian_Mag")) {
+            // M (3 components read), Ms (read), Laplacian (3 components written)
+            const auto dx = warpx.Geom(lev).CellSizeArray();
+            std::array<Real,3> cell_size = {AMREX_D_DECL(dx[0], dx[1], dx[2])};
+            Vector<Real> h_coefs_x, h_coefs_y, h_coefs_z;
+            CartesianYeeAlgorithm::InitializeStencilCoefficients(cell_size, h_coefs_x, h_coefs_y, h_coefs_z);
+            Gpu::DeviceVector<Real> d_coefs_x(h_coefs_x.size()), d_coefs_y(h_coefs_y.size()), d_coefs_z(h_coefs_z.size());
+            Gpu::copyAsync(Gpu::hostToDevice, h_coefs_x.begin(), h_coefs_x.end(), d_coefs_x.begin());
+            Gpu::copyAsync(Gpu::hostToDevice, h_coefs_y.begin(), h_coefs_y.end(), d_coefs_y.begin());
+            Gpu::copyAsync(Gpu::hostToDevice, h_coefs_z.begin(), h_coefs_z.end(), d_coefs_z.begin());
+            Gpu::synchronize();
+
+            MultiFab M(ba_x, dm, 3, 1), Ms(ba_x, dm, 1, 1), lapM(ba_x, dm, 3, 0);
+            M.setVal(1._rt);
+            Ms.setVal(1.4e5_rt);
+            const Real t = TimeKernel(n_repeat, [&] () {
+                LaplacianMag(lapM, M, Ms, d_coefs_x, d_coefs_y, d_coefs_z);
+            });
+            Report("Laplacian_Mag", nfaces, 7._rt * real_size, t, stream_bandwidth);
+        }
+#endif
+
+        // The field pushes of the simulation, on its own fields
+        if (run("EvolveB")) {
+            // B (3 read, 3 written) and E (3 read)
+            const Real t = TimeKernel(n_repeat, [&] () {
+                warpx.EvolveB(lev, PatchType::fine, dt, DtType::Full);
+            });
+            Report("EvolveB (EvolveBCartesian)", ncells, 9._rt * real_size, t, stream_bandwidth);
+        }
+
+        if (run("MacroscopicEvolveE")) {
+            // E (3 read, 3 written), B or H (3 read), J (3 read), sigma and epsilon, and mu for B
+#ifdef WARPX_MAG_LLG
+            const Real bytes_per_cell = 14._rt * real_size;
+#else
+            const Real bytes_per_cell = 15._rt * real_size;
+#endif
+            const Real t = TimeKernel(n_repeat, [&] () {
+                warpx.MacroscopicEvolveE(lev, PatchType::fine, dt);
+            });
+            Report("MacroscopicEvolveE (Cartesian)", ncells, bytes_per_cell, t, stream_bandwidth);
+        }
+
+#ifndef AMREX_USE_GPU
+        if (run("first_touch")) {
+            // Both sets are allocated before either is touched, so that the second one does not
+            // reuse pages of the arena already placed by the first one
+            MultiFab E_s(ba, dm, 3, 0), B_s(ba, dm, 3, 1), J_s(ba, dm, 3, 0), sig_s(ba, dm, 1, 0), eps_s(ba, dm, 1, 0);
+            MultiFab E_t(ba, dm, 3, 0), B_t(ba, dm, 3, 1), J_t(ba, dm, 3, 0), sig_t(ba, dm, 1, 0), eps_t(ba, dm, 1, 0);
+            for (MultiFab* mf : {&E_s, &B_s, &J_s, &sig_s, &eps_s}) SerialFirstTouch(*mf);
+            for (MultiFab* mf : {&E_t, &B_t, &J_t, &sig_t, &eps_t}) ThreadPlacement::FirstTouch(*mf);
+            for (MultiFab* mf : {&B_s, &J_s, &B_t, &J_t}) mf->setVal(1._rt);
+            for (MultiFab* mf : {&sig_s, &sig_t}) mf->setVal(1.e3_rt);
+            for (MultiFab* mf : {&eps_s, &eps_t}) mf->setVal(PhysConst::ep0);
+
+            const auto inv_dx = warpx.Geom(lev).InvCellSizeArray();
+            // E (3 read, 3 written), B (3 read), J (3 read), sigma and epsilon
+            const Real bytes_per_cell = 14._rt * real_size;
+            const Real t_serial = TimeKernel(n_repeat, [&] () {
+                MacroscopicEUpdate(E_s, B_s, J_s, sig_s, eps_s, dt, inv_dx);
+            });
+            Report("E update, serial first touch", ncells, bytes_per_cell, t_serial, stream_bandwidth);
+            const Real t_threads = TimeKernel(n_repeat, [&] () {
+                MacroscopicEUpdate(E_t, B_t, J_t, sig_t, eps_t, dt, inv_dx);
+            });
+            Report("E update, numa_first_touch = 1", ncells, bytes_per_cell, t_threads, stream_bandwidth);
+        }
+#endif
+        Print() << "\n";
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    utils::warpx_mpi_init(argc, argv);
+
+    warpx_amrex_init(argc, argv);
+
+#ifndef WARPX_DIM_3D
+    amrex::Abort(Utils::TextMsg::Err("The kernel benchmarks are only implemented in 3D"));
+#endif
+
+    SetDefaultParameters();
+
+    ParseGeometryInput();
+
+    ConvertLabParamsToBoost();
+    ReadBCParams();
+
+    {
+        WarpX warpx;
+
+        warpx.InitData();
+
+        KernelBenchmarks::Run(warpx);
+    }
+
+    Finalize();
+#if defined(AMREX_USE_MPI)
+    MPI_Finalize();
+#endif
+}
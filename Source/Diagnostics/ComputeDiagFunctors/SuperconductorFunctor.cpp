@@ -0,0 +1,23 @@
+#include "SuperconductorFunctor.H"
+
+#include "FieldSolver/London/London.H"
+#include "Utils/CoarsenIO.H"
+#include "WarpX.H"
+
+#include <AMReX_BoxArray.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_MultiFab.H>
+
+SuperconductorFunctor::SuperconductorFunctor(const int lev, const amrex::IntVect crse_ratio)
+    : ComputeDiagFunctor(1, crse_ratio), m_lev(lev)
+{}
+
+void
+SuperconductorFunctor::operator()(amrex::MultiFab& mf_dst, int dcomp, const int /*i_buffer*/) const
+{
+    auto& warpx = WarpX::GetInstance();
+    amrex::MultiFab sc_mf(amrex::convert(warpx.boxArray(m_lev), amrex::IntVect::TheNodeVector()),
+                          warpx.DistributionMap(m_lev), 1, warpx.getngEB());
+    warpx.getLondon().FillSuperconductor(sc_mf, m_lev);
+    CoarsenIO::Coarsen( mf_dst, sc_mf, dcomp, 0, nComp(), mf_dst.nGrowVect(), m_crse_ratio);
+}
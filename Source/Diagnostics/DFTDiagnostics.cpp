@@ -0,0 +1,151 @@
+#include "DFTDiagnostics.H"
+
+#include "Diagnostics/ParticleDiag/ParticleDiag.H"
+#include "FlushFormats/FlushFormat.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX.H>
+#include <AMReX_Array4.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_Box.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Vector.H>
+
+#include <cmath>
+#include <string>
+
+using namespace amrex::literals;
+
+DFTDiagnostics::DFTDiagnostics (int i, std::string name)
+    : FullDiagnostics(i, name)
+{
+    ReadDFTParameters();
+}
+
+void
+DFTDiagnostics::ReadDFTParameters ()
+{
+    amrex::ParmParse pp_diag_name(m_diag_name);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_format == "plotfile" || m_format == "openpmd",
+        "<diag>.format must be plotfile or openpmd for DFT diagnostics");
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        !m_plot_raw_fields, "<diag>.plot_raw_fields is not supported for DFT diagnostics");
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_pfield_varnames.empty(),
+        "<diag>.particle_fields_to_plot is not supported for DFT diagnostics");
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        !WarpX::GetInstance().do_moving_window,
+        "DFT diagnostics are not supported with a moving window");
+
+    getArrWithParser(pp_diag_name, "frequencies", m_frequencies);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        !m_frequencies.empty(), "<diag>.frequencies must contain at least one frequency");
+
+    const int nfreq = static_cast<int>(m_frequencies.size());
+    m_phase_cos.resize(nfreq);
+    m_phase_sin.resize(nfreq);
+
+    for (const auto& var : m_varnames) {
+        for (int ifreq = 0; ifreq < nfreq; ++ifreq) {
+            m_dft_varnames.push_back(var + "_dft" + std::to_string(ifreq) + "_re");
+            m_dft_varnames.push_back(var + "_dft" + std::to_string(ifreq) + "_im");
+        }
+    }
+}
+
+void
+DFTDiagnostics::InitializeBufferData (int i_buffer, int lev)
+{
+    FullDiagnostics::InitializeBufferData(i_buffer, lev);
+
+    if (static_cast<int>(m_mf_dft.size()) < nmax_lev) m_mf_dft.resize(nmax_lev);
+    // Keep the accumulated transform if the output buffer is re-initialized
+    if (m_mf_dft[lev].ok()) return;
+    const amrex::MultiFab& mf = m_mf_output[i_buffer][lev];
+    m_mf_dft[lev] = amrex::MultiFab(mf.boxArray(), mf.DistributionMap(),
+                                    static_cast<int>(m_dft_varnames.size()), 0);
+    m_mf_dft[lev].setVal(0._rt);
+}
+
+bool
+DFTDiagnostics::DoComputeAndPack (int /*step*/, bool /*force_flush*/)
+{
+    // The transform is accumulated at every step, and only once per step, including
+    // when the last step is flushed again at the end of the simulation (where step is
+    // the number of completed steps, instead of this number minus one in the time loop).
+    const int istep = WarpX::GetInstance().getistep(0);
+    if (istep == m_last_accumulated_step) return false;
+    m_last_accumulated_step = istep;
+    return true;
+}
+
+void
+DFTDiagnostics::UpdateBufferData ()
+{
+    WARPX_PROFILE("DFTDiagnostics::UpdateBufferData()");
+
+    auto & warpx = WarpX::GetInstance();
+    const amrex::Real t = warpx.gett_new(0);
+    const amrex::Real dt = warpx.getdt(0);
+
+    // Phase factors, computed once on the host for all frequencies
+    const int nfreq = static_cast<int>(m_frequencies.size());
+    amrex::Vector<amrex::Real> h_cos(nfreq), h_sin(nfreq);
+    for (int ifreq = 0; ifreq < nfreq; ++ifreq) {
+        const double phase = 2.*MathConst::pi*static_cast<double>(m_frequencies[ifreq])
+                             *static_cast<double>(t);
+        h_cos[ifreq] = static_cast<amrex::Real>(std::cos(phase)) * dt;
+        h_sin[ifreq] = static_cast<amrex::Real>(std::sin(phase)) * dt;
+    }
+    amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, h_cos.begin(), h_cos.end(), m_phase_cos.begin());
+    amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, h_sin.begin(), h_sin.end(), m_phase_sin.begin());
+    amrex::Real const* const phase_cos = m_phase_cos.dataPtr();
+    amrex::Real const* const phase_sin = m_phase_sin.dataPtr();
+
+    const int nvar = static_cast<int>(m_varnames.size());
+    for (int lev = 0; lev < nlev_output; ++lev) {
+        const amrex::MultiFab& mf_field = m_mf_output[0][lev];
+        amrex::MultiFab& mf_dft = m_mf_dft[lev];
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (amrex::MFIter mfi(mf_dft, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const amrex::Box& bx = mfi.tilebox();
+            amrex::Array4<amrex::Real const> const& F = mf_field.const_array(mfi);
+            amrex::Array4<amrex::Real> const& dft = mf_dft.array(mfi);
+            amrex::ParallelFor(bx, nvar,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                    const amrex::Real f = F(i,j,k,n);
+                    for (int ifreq = 0; ifreq < nfreq; ++ifreq) {
+                        const int comp = 2*(n*nfreq + ifreq);
+                        dft(i,j,k,comp)   += f*phase_cos[ifreq];
+                        dft(i,j,k,comp+1) -= f*phase_sin[ifreq];
+                    }
+                });
+        }
+    }
+    amrex::Gpu::synchronize();
+}
+
+void
+DFTDiagnostics::Flush (int i_buffer)
+{
+    auto & warpx = WarpX::GetInstance();
+
+    // No particles are written
+    const amrex::Vector<ParticleDiag> no_particles;
+    m_flush_format->WriteToFile(
+        m_dft_varnames, m_mf_dft, m_geom_output[i_buffer], warpx.getistep(),
+        warpx.gett_new(0), no_particles, nlev_output, m_file_prefix,
+        m_file_min_digits, false, false);
+}
@@ -435,10 +435,10 @@ Diagnostics::InitBaseData ()
     }
     // Construct Flush class.
     if        (m_format == "plotfile"){
-        m_flush_format = std::make_unique<FlushFormatPlotfile>() ;
+        m_flush_format = std::make_unique<FlushFormatPlotfile>(m_diag_name) ;
     } else if (m_format == "checkpoint"){
         // creating checkpoint format
-        m_flush_format = std::make_unique<FlushFormatCheckpoint>() ;
+        m_flush_format = std::make_unique<FlushFormatCheckpoint>(m_diag_name) ;
     } else if (m_format == "ascent"){
         m_flush_format = std::make_unique<FlushFormatAscent>();
     } else if (m_format == "sensei"){
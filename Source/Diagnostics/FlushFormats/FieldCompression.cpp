@@ -0,0 +1,410 @@
+#include "FieldCompression.H"
+
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXProfilerWrapper.H"
+
+#include <AMReX.H>
+#include <AMReX_Array4.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_DistributionMapping.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_IndexType.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_NFiles.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+using namespace amrex;
+using namespace amrex::literals;
+
+namespace
+{
+    const std::string compressed_version {"WarpXCompressedMultiFab_V1"};
+
+    /** Unsigned integer with the size of amrex::Real, to manipulate its bits */
+    using Word = std::conditional_t<sizeof(amrex::Real) == 8, std::uint64_t, std::uint32_t>;
+    static_assert(sizeof(Word) == sizeof(amrex::Real), "Unsupported size of amrex::Real");
+
+    // Run-length encoding: a control byte c < 128 is followed by c+1 literal bytes,
+    // a control byte c >= 128 is followed by one byte repeated c-128+min_run times.
+    constexpr int min_run = 3;
+    constexpr int max_run = 127 + min_run;
+    constexpr int max_literal = 128;
+
+    void RunLengthEncode (const unsigned char* in, long n, amrex::Vector<char>& out)
+    {
+        long i = 0;
+        long literal_start = 0;
+        auto flush_literal = [&] (long end) {
+            while (literal_start < end) {
+                const long len = std::min(end - literal_start, static_cast<long>(max_literal));
+                out.push_back(static_cast<char>(len - 1));
+                out.insert(out.end(), in + literal_start, in + literal_start + len);
+                literal_start += len;
+            }
+        };
+        while (i < n) {
+            long run = 1;
+            while (i + run < n && run < max_run && in[i + run] == in[i]) ++run;
+            if (run >= min_run) {
+                flush_literal(i);
+                out.push_back(static_cast<char>(128 + run - min_run));
+                out.push_back(static_cast<char>(in[i]));
+                i += run;
+                literal_start = i;
+            } else {
+                i += run;
+            }
+        }
+        flush_literal(n);
+    }
+
+    bool RunLengthDecode (const amrex::Vector<char>& in, unsigned char* out, long n)
+    {
+        long i = 0;
+        long o = 0;
+        const long nin = static_cast<long>(in.size());
+        while (i < nin) {
+            const int c = static_cast<unsigned char>(in[i++]);
+            if (c < 128) {
+                const long len = c + 1;
+                if (i + len > nin || o + len > n) return false;
+                std::memcpy(out + o, in.dataPtr() + i, len);
+                i += len;
+                o += len;
+            } else {
+                const long run = c - 128 + min_run;
+                if (i >= nin || o + run > n) return false;
+                std::memset(out + o, static_cast<unsigned char>(in[i++]), run);
+                o += run;
+            }
+        }
+        return o == n;
+    }
+
+    /** Name of the data file file_number, as written by NFilesIter */
+    std::string DataFileName (const std::string& name, int file_number)
+    {
+        return amrex::Concatenate(name + "_Z_D_", file_number, 5);
+    }
+
+    /** Write the header of the compressed MultiFab mf, on the I/O processor */
+    void WriteHeader (const amrex::MultiFab& mf, const std::string& name,
+                      const amrex::Vector<int>& file_numbers,
+                      const amrex::Vector<amrex::Long>& offsets,
+                      const amrex::Vector<amrex::Long>& sizes)
+    {
+        const std::string header_file = name + "_Z_H";
+        std::ofstream ofs(header_file, std::ios::out|std::ios::trunc);
+        if (!ofs.good()) { amrex::FileOpenFailed(header_file); }
+        ofs << compressed_version << "\n";
+        ofs << mf.nComp() << "\n" << mf.nGrowVect() << "\n" << mf.ixType() << "\n";
+        mf.boxArray().writeOn(ofs);
+        ofs << "\n";
+        for (int i = 0; i < mf.size(); ++i) {
+            ofs << file_numbers[i] << " " << offsets[i] << " " << sizes[i] << "\n";
+        }
+        if (!ofs.good()) { amrex::Abort("FieldCompression: problem writing " + header_file); }
+    }
+
+    /** Write the compressed FABs of this rank with AsyncOut. As VisMF::AsyncWrite, the
+     *  ranks writing to the same file take turns in a background thread. */
+    void WriteCompressedAsync (const amrex::MultiFab& mf, const std::string& name,
+                               const amrex::Vector<int>& local_index,
+                               amrex::Vector<amrex::Vector<char>>&& compressed)
+    {
+        const int nboxes = mf.size();
+        const int nlocal = static_cast<int>(local_index.size());
+        const int io_proc = ParallelDescriptor::IOProcessorNumber();
+
+        // The I/O processor needs the sizes of all the FABs to compute their offsets
+        amrex::Vector<amrex::Long> sizes(nboxes, 0);
+        for (int il = 0; il < nlocal; ++il) {
+            sizes[local_index[il]] = static_cast<amrex::Long>(compressed[il].size());
+        }
+        ParallelDescriptor::ReduceLongSum(sizes.dataPtr(), nboxes, io_proc);
+
+        if (ParallelDescriptor::IOProcessor()) {
+            const int nprocs = ParallelDescriptor::NProcs();
+            const amrex::DistributionMapping& dm = mf.DistributionMap();
+            amrex::Vector<amrex::Long> rank_size(nprocs, 0);
+            for (int i = 0; i < nboxes; ++i) rank_size[dm[i]] += sizes[i];
+
+            // The ranks of a file write in the order of their spot
+            amrex::Vector<amrex::Vector<int>> file_ranks;
+            for (int rank = 0; rank < nprocs; ++rank) {
+                const auto info = amrex::AsyncOut::GetWriteInfo(rank);
+                if (info.ifile >= static_cast<int>(file_ranks.size())) {
+                    file_ranks.resize(info.ifile + 1);
+                }
+                file_ranks[info.ifile].resize(info.nspots, -1);
+                file_ranks[info.ifile][info.ispot] = rank;
+            }
+            amrex::Vector<int> rank_file(nprocs, 0);
+            amrex::Vector<amrex::Long> rank_offset(nprocs, 0);
+            for (int ifile = 0; ifile < static_cast<int>(file_ranks.size()); ++ifile) {
+                amrex::Long offset = 0;
+                for (const int rank : file_ranks[ifile]) {
+                    if (rank < 0) continue;
+                    rank_file[rank] = ifile;
+                    rank_offset[rank] = offset;
+                    offset += rank_size[rank];
+                }
+            }
+
+            // Each rank writes its FABs in the order of their index
+            amrex::Vector<int> file_numbers(nboxes);
+            amrex::Vector<amrex::Long> offsets(nboxes);
+            for (int i = 0; i < nboxes; ++i) {
+                file_numbers[i] = rank_file[dm[i]];
+                offsets[i] = rank_offset[dm[i]];
+                rank_offset[dm[i]] += sizes[i];
+            }
+            WriteHeader(mf, name, file_numbers, offsets, sizes);
+        }
+
+        const auto info = amrex::AsyncOut::GetWriteInfo(ParallelDescriptor::MyProc());
+        const std::string data_file = DataFileName(name, info.ifile);
+        auto data = std::make_shared<amrex::Vector<amrex::Vector<char>>>(std::move(compressed));
+        amrex::AsyncOut::Submit([data, data_file, info] ()
+        {
+            // Wait for the previous rank of the file, the first one creates it
+            amrex::AsyncOut::Wait();
+            const auto mode = (info.ispot == 0) ? std::ios::trunc : std::ios::app;
+            std::ofstream ofs(data_file, std::ios::out|std::ios::binary|mode);
+            if (!ofs.good()) { amrex::FileOpenFailed(data_file); }
+            for (const auto& buf : *data) {
+                ofs.write(buf.dataPtr(), static_cast<std::streamsize>(buf.size()));
+            }
+            if (!ofs.good()) { amrex::Abort("FieldCompression: problem writing " + data_file); }
+            ofs.close();
+            amrex::AsyncOut::Notify();
+        });
+    }
+}
+
+amrex::Vector<char>
+FieldCompression::Encode (const amrex::Real* data, long n)
+{
+    constexpr int nbytes = sizeof(Word);
+
+    // XOR with the previous value, then shuffle the bytes
+    amrex::Vector<unsigned char> shuffled(n*nbytes);
+    Word previous = 0;
+    for (long i = 0; i < n; ++i) {
+        Word w;
+        std::memcpy(&w, data + i, nbytes);
+        const Word x = w ^ previous;
+        previous = w;
+        for (int b = 0; b < nbytes; ++b) {
+            shuffled[b*n + i] = static_cast<unsigned char>(x >> (8*b));
+        }
+    }
+
+    amrex::Vector<char> out;
+    out.reserve(shuffled.size()/4);
+    RunLengthEncode(shuffled.dataPtr(), static_cast<long>(shuffled.size()), out);
+    return out;
+}
+
+bool
+FieldCompression::Decode (const amrex::Vector<char>& buf, amrex::Real* data, long n)
+{
+    constexpr int nbytes = sizeof(Word);
+
+    amrex::Vector<unsigned char> shuffled(n*nbytes);
+    if (!RunLengthDecode(buf, shuffled.dataPtr(), n*nbytes)) return false;
+
+    Word previous = 0;
+    for (long i = 0; i < n; ++i) {
+        Word x = 0;
+        for (int b = 0; b < nbytes; ++b) {
+            x |= static_cast<Word>(shuffled[b*n + i]) << (8*b);
+        }
+        const Word w = x ^ previous;
+        previous = w;
+        std::memcpy(data + i, &w, nbytes);
+    }
+    return true;
+}
+
+void
+FieldCompression::WriteCompressed (const amrex::MultiFab& mf, const std::string& name)
+{
+    WARPX_PROFILE("FieldCompression::WriteCompressed()");
+
+    const int nboxes = mf.size();
+    amrex::Vector<int> local_index;
+    for (amrex::MFIter mfi(mf); mfi.isValid(); ++mfi) local_index.push_back(mfi.index());
+    const int nlocal = static_cast<int>(local_index.size());
+
+    // Copy the FABs, including guard cells, to the host
+    amrex::Vector<amrex::Vector<amrex::Real>> host(nlocal);
+    for (int il = 0; il < nlocal; ++il) {
+        const amrex::FArrayBox& fab = mf[local_index[il]];
+        const long n = fab.box().numPts()*fab.nComp();
+        host[il].resize(n);
+        amrex::Gpu::copyAsync(amrex::Gpu::deviceToHost, fab.dataPtr(), fab.dataPtr() + n,
+                              host[il].begin());
+    }
+    amrex::Gpu::streamSynchronize();
+
+    // Compress the FABs in parallel
+    amrex::Vector<amrex::Vector<char>> compressed(nlocal);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int il = 0; il < nlocal; ++il) {
+        compressed[il] = Encode(host[il].dataPtr(), static_cast<long>(host[il].size()));
+        amrex::Vector<amrex::Real>().swap(host[il]);
+    }
+
+    if (amrex::AsyncOut::UseAsyncOut()) {
+        WriteCompressedAsync(mf, name, local_index, std::move(compressed));
+        return;
+    }
+
+    // The ranks write their FABs in turn to at most VisMF::GetNOutFiles() files, as VisMF::Write
+    amrex::Vector<amrex::Long> offsets(nboxes, 0);
+    amrex::Vector<amrex::Long> sizes(nboxes, 0);
+    const int nfiles = amrex::NFilesIter::ActualNFiles(VisMF::GetNOutFiles());
+    const bool group_sets = false;
+    const bool set_buf = true;
+    amrex::NFilesIter nfi(nfiles, name + "_Z_D_", group_sets, set_buf);
+    for ( ; nfi.ReadyToWrite(); ++nfi) {
+        // the previous ranks of the file may have written to it
+        nfi.Stream().seekp(0, std::ios::end);
+        auto offset = static_cast<amrex::Long>(nfi.Stream().tellp());
+        for (int il = 0; il < nlocal; ++il) {
+            const auto size = static_cast<amrex::Long>(compressed[il].size());
+            nfi.Stream().write(compressed[il].dataPtr(), size);
+            offsets[local_index[il]] = offset;
+            sizes[local_index[il]] = size;
+            offset += size;
+        }
+        if (!nfi.Stream().good()) {
+            amrex::Abort("FieldCompression: problem writing " + nfi.FileName());
+        }
+    }
+
+    const int io_proc = ParallelDescriptor::IOProcessorNumber();
+    ParallelDescriptor::ReduceLongSum(offsets.dataPtr(), nboxes, io_proc);
+    ParallelDescriptor::ReduceLongSum(sizes.dataPtr(), nboxes, io_proc);
+
+    if (ParallelDescriptor::IOProcessor()) {
+        const amrex::DistributionMapping& dm = mf.DistributionMap();
+        amrex::Vector<int> file_numbers(nboxes);
+        for (int i = 0; i < nboxes; ++i) {
+            file_numbers[i] = amrex::NFilesIter::FileNumber(nfiles, dm[i], group_sets);
+        }
+        WriteHeader(mf, name, file_numbers, offsets, sizes);
+    }
+}
+
+void
+FieldCompression::Quantize (amrex::MultiFab& mf, amrex::Real tolerance)
+{
+    WARPX_PROFILE("FieldCompression::Quantize()");
+
+    if (tolerance <= 0) return;
+    const auto step = static_cast<amrex::Real>(
+        std::exp2(std::floor(std::log2(2.*static_cast<double>(tolerance)))));
+    const amrex::Real inv_step = 1._rt/step;
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (amrex::MFIter mfi(mf, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const amrex::Box& bx = mfi.growntilebox();
+        amrex::Array4<amrex::Real> const& arr = mf.array(mfi);
+        amrex::ParallelFor(bx, mf.nComp(),
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                arr(i,j,k,n) = std::floor(arr(i,j,k,n)*inv_step + 0.5_rt)*step;
+            });
+    }
+}
+
+bool
+FieldCompression::IsCompressed (const std::string& name)
+{
+    return amrex::FileExists(name + "_Z_H");
+}
+
+void
+FieldCompression::Read (amrex::MultiFab& mf, const std::string& name)
+{
+    if (!IsCompressed(name)) {
+        VisMF::Read(mf, name);
+        return;
+    }
+
+    WARPX_PROFILE("FieldCompression::Read()");
+
+    amrex::Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(name + "_Z_H", fileCharPtr);
+    std::string fileCharPtrString(fileCharPtr.dataPtr());
+    std::istringstream is(fileCharPtrString, std::istringstream::in);
+    is.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+
+    std::string version;
+    is >> version;
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(version == compressed_version,
+        "Unknown compressed MultiFab version in " + name + "_Z_H");
+    int ncomp;
+    amrex::IntVect ngrow;
+    amrex::IndexType ixtype;
+    is >> ncomp >> ngrow >> ixtype;
+    amrex::BoxArray ba;
+    ba.readFrom(is);
+    ba = amrex::convert(ba, ixtype);
+    const int nboxes = static_cast<int>(ba.size());
+    amrex::Vector<int> file_numbers(nboxes);
+    amrex::Vector<amrex::Long> offsets(nboxes);
+    amrex::Vector<amrex::Long> sizes(nboxes);
+    for (int i = 0; i < nboxes; ++i) {
+        is >> file_numbers[i] >> offsets[i] >> sizes[i];
+    }
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(ncomp == mf.nComp() && ixtype == mf.ixType(),
+        "The compressed MultiFab " + name + " does not match the simulation");
+
+    // Read and decompress with the layout of the file, then copy to mf
+    amrex::MultiFab tmp(ba, amrex::DistributionMapping(ba), ncomp, ngrow);
+    for (amrex::MFIter mfi(tmp); mfi.isValid(); ++mfi) {
+        const int i = mfi.index();
+        const std::string data_file = DataFileName(name, file_numbers[i]);
+        std::ifstream ifs(data_file, std::ios::in|std::ios::binary);
+        if (!ifs.good()) { amrex::FileOpenFailed(data_file); }
+        amrex::Vector<char> buf(sizes[i]);
+        ifs.seekg(offsets[i]);
+        ifs.read(buf.dataPtr(), sizes[i]);
+        if (!ifs.good()) { amrex::Abort("FieldCompression: problem reading " + data_file); }
+
+        amrex::FArrayBox& fab = tmp[mfi];
+        const long n = fab.box().numPts()*fab.nComp();
+        amrex::Vector<amrex::Real> host(n);
+        if (!Decode(buf, host.dataPtr(), n)) {
+            amrex::Abort("FieldCompression: corrupted data in " + data_file);
+        }
+        amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, host.begin(), host.end(), fab.dataPtr());
+        amrex::Gpu::streamSynchronize();
+    }
+
+    mf.ParallelCopy(tmp, 0, 0, ncomp, ngrow, mf.nGrowVect());
+}
@@ -5,24 +5,138 @@
 #   include "BoundaryConditions/PML_RZ.H"
 #endif
 #include "Diagnostics/ParticleDiag/ParticleDiag.H"
+#include "FieldCompression.H"
 #include "Particles/WarpXParticleContainer.H"
 #include "Utils/TextMsg.H"
 #include "Utils/WarpXProfilerWrapper.H"
 #include "WarpX.H"
 
+#include <AMReX_Array.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_MFIter.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_ParmParse.H>
 #include <AMReX_ParticleIO.H>
 #include <AMReX_PlotFileUtil.H>
 #include <AMReX_Print.H>
 #include <AMReX_REAL.H>
+#include <AMReX_Reduce.H>
 #include <AMReX_Utility.H>
 #include <AMReX_VisMF.H>
+#include <AMReX_iMultiFab.H>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
 
 using namespace amrex;
 
 namespace
 {
     const std::string default_level_prefix {"Level_"};
+
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    std::uint64_t SplitMix64 (std::uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    /** Hash of the valid data of mf. The hash of each value, mixed with its index and
+     *  component, is summed over the points owned by each box (see MultiFab::OwnerMask),
+     *  so that the nodal and face points shared by several boxes are counted once, and the
+     *  periodic images of a point are hashed with the same index. The result does not
+     *  depend on the BoxArray, the DistributionMapping or the order of the reduction.
+     */
+    std::uint64_t HashMultiFab (const amrex::MultiFab& mf, const amrex::Geometry& geom)
+    {
+        const std::unique_ptr<amrex::iMultiFab> owner_mask = mf.OwnerMask(geom.periodicity());
+        amrex::GpuArray<int, 3> period_lo {0, 0, 0};
+        amrex::GpuArray<int, 3> period_len {0, 0, 0};
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (geom.isPeriodic(idim)) {
+                period_lo[idim] = geom.Domain().smallEnd(idim);
+                period_len[idim] = geom.Domain().length(idim);
+            }
+        }
+
+        amrex::ReduceOps<amrex::ReduceOpSum> reduce_op;
+        amrex::ReduceData<unsigned long long> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        for (amrex::MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            const amrex::Box& bx = mfi.validbox();
+            amrex::Array4<amrex::Real const> const& arr = mf.const_array(mfi);
+            amrex::Array4<int const> const& owner = owner_mask->const_array(mfi);
+            reduce_op.eval(bx, mf.nComp(), reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) -> ReduceTuple
+                {
+                    if (!owner(i,j,k)) return {0ULL};
+                    const amrex::Real v = arr(i,j,k,n);
+                    std::uint64_t bits = 0;
+                    std::memcpy(&bits, &v, sizeof(amrex::Real));
+                    std::uint64_t h = SplitMix64(bits);
+                    const int index[3] = {i, j, k};
+                    for (int d = 0; d < 3; ++d) {
+                        int id = index[d];
+                        if (period_len[d] > 0) {
+                            id = period_lo[d] + ((id - period_lo[d])%period_len[d] + period_len[d])%period_len[d];
+                        }
+                        h = SplitMix64(h ^ static_cast<std::uint64_t>(id));
+                    }
+                    h = SplitMix64(h ^ static_cast<std::uint64_t>(n));
+                    return {static_cast<unsigned long long>(h)};
+                });
+        }
+        unsigned long long hash = amrex::get<0>(reduce_data.value(reduce_op));
+        amrex::ParallelAllReduce::Sum(hash, ParallelContext::CommunicatorSub());
+        return static_cast<std::uint64_t>(hash);
+    }
+
+    /** FNV-1a hash of a string */
+    std::uint64_t HashString (const std::string& str)
+    {
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        for (const char c : str) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+}
+
+FlushFormatCheckpoint::FlushFormatCheckpoint (const std::string& diag_name)
+{
+    amrex::ParmParse pp_diag_name(diag_name);
+    pp_diag_name.query("split_static_data", m_split_static_data);
+    std::string compression = "none";
+    pp_diag_name.query("compression", compression);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(compression == "none" || compression == "lossless",
+        "<diag>.compression must be none or lossless for checkpoints");
+    m_compress = (compression == "lossless");
+}
+
+void
+FlushFormatCheckpoint::WriteMultiFab (const amrex::MultiFab& mf, const std::string& name) const
+{
+    if (m_compress) {
+        FieldCompression::WriteCompressed(mf, name);
+    } else if (amrex::AsyncOut::UseAsyncOut()) {
+        VisMF::AsyncWrite(mf, name);
+    } else {
+        VisMF::Write(mf, name);
+    }
 }
 
 void
@@ -41,8 +155,17 @@ FlushFormatCheckpoint::WriteToFile (
 {
     WARPX_PROFILE("FlushFormatCheckpoint::WriteToFile()");
 
+    // Back-pressure: the previous dump must be written before a new one is staged
+    WaitForAsyncOutput();
+
+    // The static data written asynchronously by the previous checkpoint is now complete
+    WriteStaticHeader();
+
     auto & warpx = WarpX::GetInstance();
 
+    // the diags must not lose the data up to the checkpoint if the run stops after it
+    warpx.FlushBufferedDiagnostics();
+
     VisMF::Header::Version current_version = VisMF::GetHeaderVersion();
     VisMF::SetHeaderVersion(amrex::VisMF::Header::NoFabHeader_v1);
 
@@ -58,130 +181,147 @@ FlushFormatCheckpoint::WriteToFile (
 
     WriteJobInfo(checkpointname);
 
+    warpx.WriteDiagnosticsCheckpointData(checkpointname);
+
+    // With split_static_data, the static data is written once and referenced by the checkpoint
+    const std::string static_dir_name = m_split_static_data ? WriteStaticData(prefix, nlev) : "";
+    if (!static_dir_name.empty() && ParallelDescriptor::IOProcessor()) {
+        std::ofstream StaticFile(checkpointname + "/StaticData", std::ios::out|std::ios::trunc);
+        if (!StaticFile.good()) { amrex::FileOpenFailed(checkpointname + "/StaticData"); }
+        StaticFile << static_dir_name << "\n";
+    }
+#ifdef WARPX_MAG_LLG
+    const bool write_H_bias = static_dir_name.empty() || !WarpX::HbiasIsStatic();
+#endif
+
     for (int lev = 0; lev < nlev; ++lev)
     {
-        VisMF::Write(warpx.getEfield_fp(lev, 0),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_fp"));
-        VisMF::Write(warpx.getEfield_fp(lev, 1),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_fp"));
-        VisMF::Write(warpx.getEfield_fp(lev, 2),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_fp"));
-        VisMF::Write(warpx.getBfield_fp(lev, 0),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_fp"));
-        VisMF::Write(warpx.getBfield_fp(lev, 1),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_fp"));
-        VisMF::Write(warpx.getBfield_fp(lev, 2),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_fp"));
+        WriteMultiFab(warpx.getEfield_fp(lev, 0),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_fp"));
+        WriteMultiFab(warpx.getEfield_fp(lev, 1),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_fp"));
+        WriteMultiFab(warpx.getEfield_fp(lev, 2),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_fp"));
+        WriteMultiFab(warpx.getBfield_fp(lev, 0),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_fp"));
+        WriteMultiFab(warpx.getBfield_fp(lev, 1),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_fp"));
+        WriteMultiFab(warpx.getBfield_fp(lev, 2),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_fp"));
 
 #ifdef WARPX_MAG_LLG
-        VisMF::Write(warpx.getHfield_fp(lev, 0),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hx_fp"));
-        VisMF::Write(warpx.getHfield_fp(lev, 1),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hy_fp"));
-        VisMF::Write(warpx.getHfield_fp(lev, 2),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hz_fp"));
-        VisMF::Write(warpx.getMfield_fp(lev, 0),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Mx_fp"));
-        VisMF::Write(warpx.getMfield_fp(lev, 1),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "My_fp"));
-        VisMF::Write(warpx.getMfield_fp(lev, 2),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Mz_fp"));
-        VisMF::Write(warpx.getH_biasfield_fp(lev, 0),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hxbias_fp"));
-        VisMF::Write(warpx.getH_biasfield_fp(lev, 1),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hybias_fp"));
-        VisMF::Write(warpx.getH_biasfield_fp(lev, 2),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hzbias_fp"));
+        WriteMultiFab(warpx.getHfield_fp(lev, 0),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hx_fp"));
+        WriteMultiFab(warpx.getHfield_fp(lev, 1),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hy_fp"));
+        WriteMultiFab(warpx.getHfield_fp(lev, 2),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hz_fp"));
+        WriteMultiFab(warpx.getMfield_fp(lev, 0),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Mx_fp"));
+        WriteMultiFab(warpx.getMfield_fp(lev, 1),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "My_fp"));
+        WriteMultiFab(warpx.getMfield_fp(lev, 2),
+                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Mz_fp"));
+        if (write_H_bias) {
+            WriteMultiFab(warpx.getH_biasfield_fp(lev, 0),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hxbias_fp"));
+            WriteMultiFab(warpx.getH_biasfield_fp(lev, 1),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hybias_fp"));
+            WriteMultiFab(warpx.getH_biasfield_fp(lev, 2),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hzbias_fp"));
+        }
 #endif
 
         if (WarpX::fft_do_time_averaging)
         {
-            VisMF::Write(warpx.getEfield_avg_fp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_avg_fp"));
-            VisMF::Write(warpx.getEfield_avg_fp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_avg_fp"));
-            VisMF::Write(warpx.getEfield_avg_fp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_avg_fp"));
-
-            VisMF::Write(warpx.getBfield_avg_fp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_avg_fp"));
-            VisMF::Write(warpx.getBfield_avg_fp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_avg_fp"));
-            VisMF::Write(warpx.getBfield_avg_fp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_avg_fp"));
+            WriteMultiFab(warpx.getEfield_avg_fp(lev, 0),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_avg_fp"));
+            WriteMultiFab(warpx.getEfield_avg_fp(lev, 1),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_avg_fp"));
+            WriteMultiFab(warpx.getEfield_avg_fp(lev, 2),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_avg_fp"));
+
+            WriteMultiFab(warpx.getBfield_avg_fp(lev, 0),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_avg_fp"));
+            WriteMultiFab(warpx.getBfield_avg_fp(lev, 1),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_avg_fp"));
+            WriteMultiFab(warpx.getBfield_avg_fp(lev, 2),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_avg_fp"));
         }
 
         if (warpx.getis_synchronized() || WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon) {
             // Need to save j if synchronized because after restart we need j to evolve E by dt/2.
-            VisMF::Write(warpx.getcurrent_fp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jx_fp"));
-            VisMF::Write(warpx.getcurrent_fp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jy_fp"));
-            VisMF::Write(warpx.getcurrent_fp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jz_fp"));
+            WriteMultiFab(warpx.getcurrent_fp(lev, 0),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jx_fp"));
+            WriteMultiFab(warpx.getcurrent_fp(lev, 1),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jy_fp"));
+            WriteMultiFab(warpx.getcurrent_fp(lev, 2),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jz_fp"));
         }
 
         if (lev > 0)
         {
-            VisMF::Write(warpx.getEfield_cp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_cp"));
-            VisMF::Write(warpx.getEfield_cp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_cp"));
-            VisMF::Write(warpx.getEfield_cp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_cp"));
-            VisMF::Write(warpx.getBfield_cp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_cp"));
-            VisMF::Write(warpx.getBfield_cp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_cp"));
-            VisMF::Write(warpx.getBfield_cp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_cp"));
+            WriteMultiFab(warpx.getEfield_cp(lev, 0),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_cp"));
+            WriteMultiFab(warpx.getEfield_cp(lev, 1),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_cp"));
+            WriteMultiFab(warpx.getEfield_cp(lev, 2),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_cp"));
+            WriteMultiFab(warpx.getBfield_cp(lev, 0),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_cp"));
+            WriteMultiFab(warpx.getBfield_cp(lev, 1),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_cp"));
+            WriteMultiFab(warpx.getBfield_cp(lev, 2),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_cp"));
 
 #ifdef WARPX_MAG_LLG
-            VisMF::Write(warpx.getHfield_cp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hx_cp"));
-            VisMF::Write(warpx.getHfield_cp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hy_cp"));
-            VisMF::Write(warpx.getHfield_cp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hz_cp"));
-            VisMF::Write(warpx.getMfield_cp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Mx_cp"));
-            VisMF::Write(warpx.getMfield_cp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "My_cp"));
-            VisMF::Write(warpx.getMfield_cp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Mz_cp"));
-            VisMF::Write(warpx.getH_biasfield_cp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hxbias_fp"));
-            VisMF::Write(warpx.getH_biasfield_cp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hybias_fp"));
-            VisMF::Write(warpx.getH_biasfield_cp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hzbias_fp"));
+            WriteMultiFab(warpx.getHfield_cp(lev, 0),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hx_cp"));
+            WriteMultiFab(warpx.getHfield_cp(lev, 1),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hy_cp"));
+            WriteMultiFab(warpx.getHfield_cp(lev, 2),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hz_cp"));
+            WriteMultiFab(warpx.getMfield_cp(lev, 0),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Mx_cp"));
+            WriteMultiFab(warpx.getMfield_cp(lev, 1),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "My_cp"));
+            WriteMultiFab(warpx.getMfield_cp(lev, 2),
+                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Mz_cp"));
+            if (write_H_bias) {
+                WriteMultiFab(warpx.getH_biasfield_cp(lev, 0),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hxbias_cp"));
+                WriteMultiFab(warpx.getH_biasfield_cp(lev, 1),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hybias_cp"));
+                WriteMultiFab(warpx.getH_biasfield_cp(lev, 2),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Hzbias_cp"));
+            }
 #endif
 
             if (WarpX::fft_do_time_averaging)
             {
-                VisMF::Write(warpx.getEfield_avg_cp(lev, 0),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_avg_cp"));
-                VisMF::Write(warpx.getEfield_avg_cp(lev, 1),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_avg_cp"));
-                VisMF::Write(warpx.getEfield_avg_cp(lev, 2),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_avg_cp"));
-
-                VisMF::Write(warpx.getBfield_avg_cp(lev, 0),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_avg_cp"));
-                VisMF::Write(warpx.getBfield_avg_cp(lev, 1),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_avg_cp"));
-                VisMF::Write(warpx.getBfield_avg_cp(lev, 2),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_avg_cp"));
+                WriteMultiFab(warpx.getEfield_avg_cp(lev, 0),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_avg_cp"));
+                WriteMultiFab(warpx.getEfield_avg_cp(lev, 1),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_avg_cp"));
+                WriteMultiFab(warpx.getEfield_avg_cp(lev, 2),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_avg_cp"));
+
+                WriteMultiFab(warpx.getBfield_avg_cp(lev, 0),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_avg_cp"));
+                WriteMultiFab(warpx.getBfield_avg_cp(lev, 1),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_avg_cp"));
+                WriteMultiFab(warpx.getBfield_avg_cp(lev, 2),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_avg_cp"));
             }
 
             if (warpx.getis_synchronized() || WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon) {
                 // Need to save j if synchronized because after restart we need j to evolve E by dt/2.
-                VisMF::Write(warpx.getcurrent_cp(lev, 0),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jx_cp"));
-                VisMF::Write(warpx.getcurrent_cp(lev, 1),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jy_cp"));
-                VisMF::Write(warpx.getcurrent_cp(lev, 2),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jz_cp"));
+                WriteMultiFab(warpx.getcurrent_cp(lev, 0),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jx_cp"));
+                WriteMultiFab(warpx.getcurrent_cp(lev, 1),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jy_cp"));
+                WriteMultiFab(warpx.getcurrent_cp(lev, 2),
+                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jz_cp"));
             }
         }
 
@@ -273,3 +413,85 @@ FlushFormatCheckpoint::WriteDMaps (const std::string& dir, int nlev) const
         }
     }
 }
+
+void
+FlushFormatCheckpoint::WriteStaticHeader () const
+{
+    if (m_static_header_name.empty()) return;
+
+    // all the ranks have written their part of the static data
+    ParallelDescriptor::Barrier();
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream HeaderFile(m_static_header_name, std::ios::out|std::ios::trunc);
+        if (!HeaderFile.good()) { amrex::FileOpenFailed(m_static_header_name); }
+        HeaderFile << m_static_header;
+    }
+    m_static_header_name.clear();
+    m_static_header.clear();
+}
+
+std::string
+FlushFormatCheckpoint::WriteStaticData (const std::string& prefix, int nlev) const
+{
+    if (m_static_data_written) return m_static_dir_name;
+
+    WARPX_PROFILE("FlushFormatCheckpoint::WriteStaticData()");
+
+    auto & warpx = WarpX::GetInstance();
+
+    amrex::Vector<amrex::Vector<std::pair<std::string, amrex::MultiFab*>>> static_mfs(nlev);
+    bool has_static_data = false;
+    for (int lev = 0; lev < nlev; ++lev) {
+        static_mfs[lev] = warpx.GetStaticMultiFabs(lev);
+        has_static_data = has_static_data || !static_mfs[lev].empty();
+    }
+    m_static_data_written = true;
+    if (!has_static_data) return m_static_dir_name;
+
+    // Content hash of all the static data
+    std::uint64_t hash = 0;
+    for (int lev = 0; lev < nlev; ++lev) {
+        for (const auto& static_mf : static_mfs[lev]) {
+            const std::uint64_t name_hash = HashString(static_mf.first + std::to_string(lev));
+            hash = SplitMix64(hash ^ name_hash ^ HashMultiFab(*static_mf.second, warpx.Geom(lev)));
+        }
+    }
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+    const std::string static_dir = prefix + "_static_" + ss.str();
+    const auto pos = static_dir.rfind('/');
+    m_static_dir_name = (pos == std::string::npos) ? static_dir : static_dir.substr(pos+1);
+
+    // The header is written last, so that an interrupted write is redone
+    const std::string header_name = static_dir + "/WarpXStaticHeader";
+    int exists = 0;
+    if (ParallelDescriptor::IOProcessor()) exists = amrex::FileExists(header_name);
+    ParallelDescriptor::Bcast(&exists, 1, ParallelDescriptor::IOProcessorNumber());
+    if (exists) return m_static_dir_name;
+
+    amrex::Print() << Utils::TextMsg::Info("Writing static data " + static_dir);
+
+    amrex::PreBuildDirectorHierarchy(static_dir, default_level_prefix, nlev, true);
+    for (int lev = 0; lev < nlev; ++lev) {
+        for (const auto& static_mf : static_mfs[lev]) {
+            WriteMultiFab(*static_mf.second, amrex::MultiFabFileFullPrefix(
+                lev, static_dir, default_level_prefix, static_mf.first));
+        }
+    }
+
+    std::stringstream header;
+    header << nlev << "\n";
+    for (int lev = 0; lev < nlev; ++lev) {
+        for (const auto& static_mf : static_mfs[lev]) {
+            header << lev << " " << static_mf.first << "\n";
+        }
+    }
+    m_static_header_name = header_name;
+    m_static_header = header.str();
+    // With asynchronous output, the data is only known to be written on all the ranks
+    // at the next checkpoint, see WriteToFile. If the run stops before, the static data
+    // is written again by the next run.
+    if (!amrex::AsyncOut::UseAsyncOut()) WriteStaticHeader();
+
+    return m_static_dir_name;
+}
@@ -1,12 +1,14 @@
 #include "FlushFormatPlotfile.H"
 
 #include "Diagnostics/ParticleDiag/ParticleDiag.H"
+#include "FieldCompression.H"
 #include "Particles/Filter/FilterFunctors.H"
 #include "Particles/WarpXParticleContainer.H"
 #include "Particles/PinnedMemoryParticleContainer.H"
 #include "Utils/Interpolate.H"
 #include "Utils/TextMsg.H"
 #include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
 #include "WarpX.H"
 
 #include <AMReX.H>
@@ -50,6 +52,20 @@ namespace
     const std::string default_level_prefix {"Level_"};
 }
 
+FlushFormatPlotfile::FlushFormatPlotfile (const std::string& diag_name)
+{
+    amrex::ParmParse pp_diag_name(diag_name);
+    std::string compression = "none";
+    pp_diag_name.query("compression", compression);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(compression == "none" || compression == "lossy",
+        "<diag>.compression must be none or lossy for plotfiles");
+    if (compression == "lossy") {
+        getWithParser(pp_diag_name, "quantization_tolerance", m_quantization_tolerance);
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_quantization_tolerance > 0.,
+            "<diag>.quantization_tolerance must be positive");
+    }
+}
+
 void
 FlushFormatPlotfile::WriteToFile (
     const amrex::Vector<std::string> varnames,
@@ -63,16 +79,33 @@ FlushFormatPlotfile::WriteToFile (
     bool /*isLastBTDFlush*/, const amrex::Vector<int>& /* totalParticlesFlushedAlready*/) const
 {
     WARPX_PROFILE("FlushFormatPlotfile::WriteToFile()");
+
+    // Back-pressure: the previous dump must be written before a new one is staged
+    WaitForAsyncOutput();
+
     auto & warpx = WarpX::GetInstance();
     const std::string& filename = amrex::Concatenate(prefix, iteration[0], file_min_digits);
     amrex::Print() << Utils::TextMsg::Info("Writing plotfile " + filename);
 
+    // Lossy compression, on a copy of the output buffers
+    amrex::Vector<amrex::MultiFab> mf_quantized;
+    if (m_quantization_tolerance > 0.) {
+        for (int lev = 0; lev < nlev; ++lev) {
+            mf_quantized.emplace_back(mf[lev].boxArray(), mf[lev].DistributionMap(),
+                                      mf[lev].nComp(), mf[lev].nGrowVect());
+            amrex::MultiFab::Copy(mf_quantized[lev], mf[lev], 0, 0, mf[lev].nComp(),
+                                  mf[lev].nGrowVect());
+            FieldCompression::Quantize(mf_quantized[lev], m_quantization_tolerance);
+        }
+    }
+    const amrex::Vector<amrex::MultiFab>& mf_out = mf_quantized.empty() ? mf : mf_quantized;
+
     Vector<std::string> rfs;
     VisMF::Header::Version current_version = VisMF::GetHeaderVersion();
     VisMF::SetHeaderVersion(amrex::VisMF::Header::Version_v1);
     if (plot_raw_fields) rfs.emplace_back("raw_fields");
     amrex::WriteMultiLevelPlotfile(filename, nlev,
-                                   amrex::GetVecOfConstPtrs(mf),
+                                   amrex::GetVecOfConstPtrs(mf_out),
                                    varnames, geom,
                                    static_cast<Real>(time), iteration, warpx.refRatio(),
                                    "HyperCLaw-V1.1",
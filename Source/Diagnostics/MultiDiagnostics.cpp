@@ -1,7 +1,10 @@
 #include "MultiDiagnostics.H"
 
 #include "Diagnostics/BTDiagnostics.H"
+#include "Diagnostics/DFTDiagnostics.H"
 #include "Diagnostics/FullDiagnostics.H"
+#include "Diagnostics/TimeAveragedDiagnostics.H"
+#include "Diagnostics/TimeSeriesDiagnostics.H"
 #include "Utils/TextMsg.H"
 
 #include <AMReX_ParmParse.H>
@@ -28,6 +31,12 @@ MultiDiagnostics::MultiDiagnostics ()
 #else
             alldiags[i] = std::make_unique<BTDiagnostics>(i, diags_names[i]);
 #endif
+        } else if ( diags_types[i] == DiagTypes::DFT ){
+            alldiags[i] = std::make_unique<DFTDiagnostics>(i, diags_names[i]);
+        } else if ( diags_types[i] == DiagTypes::TimeSeries ){
+            alldiags[i] = std::make_unique<TimeSeriesDiagnostics>(i, diags_names[i]);
+        } else if ( diags_types[i] == DiagTypes::TimeAveraged ){
+            alldiags[i] = std::make_unique<TimeAveragedDiagnostics>(i, diags_names[i]);
         } else {
             amrex::Abort(Utils::TextMsg::Err("Unknown diagnostic type"));
         }
@@ -70,36 +79,70 @@ MultiDiagnostics::ReadParameters ()
         pp_diag_name.get("diag_type", diag_type_str);
         if (diag_type_str == "Full") diags_types[i] = DiagTypes::Full;
         if (diag_type_str == "BackTransformed") diags_types[i] = DiagTypes::BackTransformed;
+        if (diag_type_str == "DFT") diags_types[i] = DiagTypes::DFT;
+        if (diag_type_str == "TimeSeries") diags_types[i] = DiagTypes::TimeSeries;
+        if (diag_type_str == "TimeAveraged") diags_types[i] = DiagTypes::TimeAveraged;
     }
 }
 
 void
 MultiDiagnostics::FilterComputePackFlush (int step, bool force_flush, bool BackTransform)
 {
-    int i = 0;
-    for (auto& diag : alldiags){
-        if (BackTransform == true) {
-            if (diags_types[i] == DiagTypes::BackTransformed)
-                diag->FilterComputePackFlush (step, force_flush);
-        } else {
-            if (diags_types[i] != DiagTypes::BackTransformed)
-                diag->FilterComputePackFlush (step, force_flush);
+    // Checkpoints are written after the other diags of the step, so that the data that the
+    // other diags keep in memory includes this step when the checkpoint flushes it
+    for (const bool checkpoints : {false, true}) {
+        for (int i = 0; i < ndiags; ++i) {
+            auto& diag = alldiags[i];
+            if (diag->IsCheckpoint() != checkpoints) continue;
+            if (BackTransform == true) {
+                if (diags_types[i] == DiagTypes::BackTransformed)
+                    diag->FilterComputePackFlush (step, force_flush);
+            } else {
+                if (diags_types[i] != DiagTypes::BackTransformed)
+                    diag->FilterComputePackFlush (step, force_flush);
+            }
         }
-        ++i;
     }
 }
 
 void
 MultiDiagnostics::FilterComputePackFlushLastTimestep (int step)
 {
-    for (auto& diag : alldiags){
-        if (diag->DoDumpLastTimestep()){
-            constexpr bool force_flush = true;
-            diag->FilterComputePackFlush (step, force_flush);
+    for (const bool checkpoints : {false, true}) {
+        for (auto& diag : alldiags){
+            if (diag->IsCheckpoint() != checkpoints) continue;
+            if (diag->DoDumpLastTimestep()){
+                constexpr bool force_flush = true;
+                diag->FilterComputePackFlush (step, force_flush);
+            }
         }
     }
 }
 
+void
+MultiDiagnostics::FlushBufferedData ()
+{
+    for (auto& diag : alldiags){
+        diag->FlushBufferedData();
+    }
+}
+
+void
+MultiDiagnostics::WriteCheckpointData (const std::string& dir)
+{
+    for (auto& diag : alldiags){
+        diag->WriteCheckpointData(dir);
+    }
+}
+
+void
+MultiDiagnostics::ReadCheckpointData (const std::string& dir)
+{
+    for (auto& diag : alldiags){
+        diag->ReadCheckpointData(dir);
+    }
+}
+
 void
 MultiDiagnostics::NewIteration ()
 {
@@ -19,6 +19,7 @@
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_REAL.H>
+#include <AMReX_iMultiFab.H>
 
 #include <algorithm>
 #include <fstream>
@@ -77,6 +78,13 @@ FieldEnergy::FieldEnergy (std::string rd_name)
 
 // function that computes field energy
 void FieldEnergy::ComputeDiags (int step)
+{
+    ComputeDiagsWithOwnBatch(step);
+}
+// end void FieldEnergy::ComputeDiags
+
+// function that computes the sums of the squared fields on this MPI rank
+void FieldEnergy::AddToBatch (int step, ReductionBatch& batch)
 {
     // Judge if the diags should be done
     if (!m_intervals.contains(step+1)) { return; }
@@ -87,17 +95,48 @@ void FieldEnergy::ComputeDiags (int step)
     // get number of level
     const auto nLevel = warpx.finestLevel() + 1;
 
+    // sums of E squared and B squared at each level, on this MPI rank
+    std::vector<Real> local_sums(2*nLevel, 0.0_rt);
+
     // loop over refinement levels
     for (int lev = 0; lev < nLevel; ++lev)
     {
-        // get MultiFab data at lev
-        const MultiFab & Ex = warpx.getEfield(lev,0);
-        const MultiFab & Ey = warpx.getEfield(lev,1);
-        const MultiFab & Ez = warpx.getEfield(lev,2);
-        const MultiFab & Bx = warpx.getBfield(lev,0);
-        const MultiFab & By = warpx.getBfield(lev,1);
-        const MultiFab & Bz = warpx.getBfield(lev,2);
+        Geometry const & geom = warpx.Geom(lev);
+        for (int idir = 0; idir < 3; ++idir)
+        {
+            // as MultiFab::norm2, the points shared by several boxes are only counted
+            // in the box owning them, but without reduction over the MPI ranks
+            const MultiFab & E = warpx.getEfield(lev,idir);
+            const MultiFab & B = warpx.getBfield(lev,idir);
+            const auto E_mask = E.OwnerMask(geom.periodicity());
+            const auto B_mask = B.OwnerMask(geom.periodicity());
+            constexpr bool local = true;
+            local_sums[2*lev] += MultiFab::Dot(*E_mask, E, 0, E, 0, 1, 0, local);
+            local_sums[2*lev+1] += MultiFab::Dot(*B_mask, B, 0, B, 0, 1, 0, local);
+        }
+    }
+    // end loop over refinement levels
 
+    // summed over mpi ranks with the other diags
+    m_batch_offset = batch.AddSum(local_sums);
+}
+// end void FieldEnergy::AddToBatch
+
+// function that computes field energy from the sums over all MPI ranks
+void FieldEnergy::ReadFromBatch (int step, const ReductionBatch& batch)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    // get a reference to WarpX instance
+    auto & warpx = WarpX::GetInstance();
+
+    // get number of level
+    const auto nLevel = warpx.finestLevel() + 1;
+
+    // loop over refinement levels
+    for (int lev = 0; lev < nLevel; ++lev)
+    {
         // get cell size
         Geometry const & geom = warpx.Geom(lev);
 #if defined(WARPX_DIM_1D_Z)
@@ -108,17 +147,9 @@ void FieldEnergy::ComputeDiags (int step)
         auto dV = geom.CellSize(0) * geom.CellSize(1) * geom.CellSize(2);
 #endif
 
-        // compute E squared
-        Real const tmpEx = Ex.norm2(0,geom.periodicity());
-        Real const tmpEy = Ey.norm2(0,geom.periodicity());
-        Real const tmpEz = Ez.norm2(0,geom.periodicity());
-        Real const Es = tmpEx*tmpEx + tmpEy*tmpEy + tmpEz*tmpEz;
-
-        // compute B squared
-        Real const tmpBx = Bx.norm2(0,geom.periodicity());
-        Real const tmpBy = By.norm2(0,geom.periodicity());
-        Real const tmpBz = Bz.norm2(0,geom.periodicity());
-        Real const Bs = tmpBx*tmpBx + tmpBy*tmpBy + tmpBz*tmpBz;
+        // E squared and B squared
+        Real const Es = batch.Sum(m_batch_offset + 2*lev);
+        Real const Bs = batch.Sum(m_batch_offset + 2*lev+1);
 
         constexpr int noutputs = 3; // total energy, E-field energy and B-field energy
         constexpr int index_total = 0;
@@ -142,4 +173,4 @@ void FieldEnergy::ComputeDiags (int step)
      *   magnetic field energy at level 1,
      *   ......] */
 }
-// end void FieldEnergy::ComputeDiags
+// end void FieldEnergy::ReadFromBatch
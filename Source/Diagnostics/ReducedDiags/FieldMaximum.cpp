@@ -100,6 +100,13 @@ FieldMaximum::FieldMaximum (std::string rd_name)
 
 // function that computes maximum field values
 void FieldMaximum::ComputeDiags (int step)
+{
+    ComputeDiagsWithOwnBatch(step);
+}
+// end void FieldMaximum::ComputeDiags
+
+// function that computes maximum field values on this MPI rank
+void FieldMaximum::AddToBatch (int step, ReductionBatch& batch)
 {
     // Judge if the diags should be done
     if (!m_intervals.contains(step+1)) { return; }
@@ -110,6 +117,9 @@ void FieldMaximum::ComputeDiags (int step)
     // get number of level
     const auto nLevel = warpx.finestLevel() + 1;
 
+    // local maxima, with |E|**2 and |B|**2 in place of |E| and |B|
+    std::vector<Real> local_max(m_data.size(), 0.0_rt);
+
     // loop over refinement levels
     for (int lev = 0; lev < nLevel; ++lev)
     {
@@ -256,39 +266,45 @@ void FieldMaximum::ComputeDiags (int step)
             });
         }
 
-        Real hv_Ex = amrex::get<0>(reduceEx_data.value()); // highest value of |Ex|
-        Real hv_Ey = amrex::get<0>(reduceEy_data.value()); // highest value of |Ey|
-        Real hv_Ez = amrex::get<0>(reduceEz_data.value()); // highest value of |Ez|
-        Real hv_Bx = amrex::get<0>(reduceBx_data.value()); // highest value of |Bx|
-        Real hv_By = amrex::get<0>(reduceBy_data.value()); // highest value of |By|
-        Real hv_Bz = amrex::get<0>(reduceBz_data.value()); // highest value of |Bz|
-        Real hv_E = amrex::get<0>(reduceE_data.value()); // highest value of |E|**2
-        Real hv_B = amrex::get<0>(reduceB_data.value()); // highest value of |B|**2
+        // Fill local maxima
+        local_max[lev*noutputs+index_Ex] = amrex::get<0>(reduceEx_data.value()); // highest value of |Ex|
+        local_max[lev*noutputs+index_Ey] = amrex::get<0>(reduceEy_data.value()); // highest value of |Ey|
+        local_max[lev*noutputs+index_Ez] = amrex::get<0>(reduceEz_data.value()); // highest value of |Ez|
+        local_max[lev*noutputs+index_Bx] = amrex::get<0>(reduceBx_data.value()); // highest value of |Bx|
+        local_max[lev*noutputs+index_By] = amrex::get<0>(reduceBy_data.value()); // highest value of |By|
+        local_max[lev*noutputs+index_Bz] = amrex::get<0>(reduceBz_data.value()); // highest value of |Bz|
+        local_max[lev*noutputs+index_absE] = amrex::get<0>(reduceE_data.value()); // highest value of |E|**2
+        local_max[lev*noutputs+index_absB] = amrex::get<0>(reduceB_data.value()); // highest value of |B|**2
+    }
+    // end loop over refinement levels
+
+    // MPI reduce, with the other diags
+    m_batch_offset = batch.AddMax(local_max);
+}
+// end void FieldMaximum::AddToBatch
+
+// function that reads the maximum field values over all MPI ranks
+void FieldMaximum::ReadFromBatch (int step, const ReductionBatch& batch)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
 
-        // MPI reduce
-        ParallelDescriptor::ReduceRealMax(hv_Ex);
-        ParallelDescriptor::ReduceRealMax(hv_Ey);
-        ParallelDescriptor::ReduceRealMax(hv_Ez);
-        ParallelDescriptor::ReduceRealMax(hv_Bx);
-        ParallelDescriptor::ReduceRealMax(hv_By);
-        ParallelDescriptor::ReduceRealMax(hv_Bz);
-        ParallelDescriptor::ReduceRealMax(hv_E);
-        ParallelDescriptor::ReduceRealMax(hv_B);
+    constexpr int noutputs = 8; // max of Ex,Ey,Ez,|E|,Bx,By,Bz and |B|
+    constexpr int index_absE = 3;
+    constexpr int index_absB = 7;
 
-        // Fill output array
-        m_data[lev*noutputs+index_Ex] = hv_Ex;
-        m_data[lev*noutputs+index_Ey] = hv_Ey;
-        m_data[lev*noutputs+index_Ez] = hv_Ez;
-        m_data[lev*noutputs+index_Bx] = hv_Bx;
-        m_data[lev*noutputs+index_By] = hv_By;
-        m_data[lev*noutputs+index_Bz] = hv_Bz;
-        m_data[lev*noutputs+index_absE] = std::sqrt(hv_E);
-        m_data[lev*noutputs+index_absB] = std::sqrt(hv_B);
+    // Fill output array
+    for (int i = 0; i < static_cast<int>(m_data.size()); ++i)
+    {
+        m_data[i] = batch.Max(m_batch_offset + i);
+        if (i%noutputs == index_absE || i%noutputs == index_absB)
+        {
+            m_data[i] = std::sqrt(m_data[i]);
+        }
     }
-    // end loop over refinement levels
 
     /* m_data now contains up-to-date values for:
      *  [max(Ex),max(Ey),max(Ez),max(|E|),
      *   max(Bx),max(By),max(Bz),max(|B|)] */
 }
-// end void FieldMaximum::ComputeDiags
+// end void FieldMaximum::ReadFromBatch
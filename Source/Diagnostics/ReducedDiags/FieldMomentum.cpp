@@ -92,6 +92,11 @@ FieldMomentum::FieldMomentum (std::string rd_name)
 }
 
 void FieldMomentum::ComputeDiags (int step)
+{
+    ComputeDiagsWithOwnBatch(step);
+}
+
+void FieldMomentum::AddToBatch (int step, ReductionBatch& batch)
 {
     // Check if the diags should be done
     if (m_intervals.contains(step+1) == false)
@@ -105,6 +110,9 @@ void FieldMomentum::ComputeDiags (int step)
     // Get number of refinement levels
     const auto nLevel = warpx.finestLevel() + 1;
 
+    // Momentum on this MPI rank
+    std::vector<amrex::Real> local_data(m_data.size(), 0.);
+
     // Loop over refinement levels
     for (int lev = 0; lev < nLevel; ++lev)
     {
@@ -177,14 +185,11 @@ void FieldMomentum::ComputeDiags (int step)
                 });
         }
 
-        // MPI reduce
+        // Local sums, reduced over MPI ranks with the other diags
         auto r = reduce_data.value();
         amrex::Real ExB_x = amrex::get<0>(r);
         amrex::Real ExB_y = amrex::get<1>(r);
         amrex::Real ExB_z = amrex::get<2>(r);
-        amrex::ParallelDescriptor::ReduceRealSum(ExB_x);
-        amrex::ParallelDescriptor::ReduceRealSum(ExB_y);
-        amrex::ParallelDescriptor::ReduceRealSum(ExB_z);
 
         // Get cell size
         amrex::Geometry const & geom = warpx.Geom(lev);
@@ -198,8 +203,25 @@ void FieldMomentum::ComputeDiags (int step)
 
         // Save data (offset: 3 values for each refinement level)
         const int offset = lev*3;
-        m_data[offset+0] = PhysConst::ep0 * ExB_x * dV;
-        m_data[offset+1] = PhysConst::ep0 * ExB_y * dV;
-        m_data[offset+2] = PhysConst::ep0 * ExB_z * dV;
+        local_data[offset+0] = PhysConst::ep0 * ExB_x * dV;
+        local_data[offset+1] = PhysConst::ep0 * ExB_y * dV;
+        local_data[offset+2] = PhysConst::ep0 * ExB_z * dV;
+    }
+
+    // MPI reduce
+    m_batch_offset = batch.AddSum(local_data);
+}
+
+void FieldMomentum::ReadFromBatch (int step, const ReductionBatch& batch)
+{
+    // Check if the diags should be done
+    if (m_intervals.contains(step+1) == false)
+    {
+        return;
+    }
+
+    for (int i = 0; i < static_cast<int>(m_data.size()); ++i)
+    {
+        m_data[i] = batch.Sum(m_batch_offset + i);
     }
 }
@@ -19,6 +19,7 @@
 
 #include <AMReX_Array.H>
 #include <AMReX_Config.H>
+#include <AMReX_GpuContainers.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_ParallelDescriptor.H>
@@ -35,8 +36,11 @@
 
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <ostream>
 #include <string>
 #include <unordered_map>
@@ -44,6 +48,69 @@
 
 using namespace amrex;
 
+namespace
+{
+    /** \brief Gather send_count values of each MPI rank to recv on the root rank, in rank order.
+     *
+     * The values are gathered by groups of consecutive ranks holding at most INT_MAX values in
+     * total, since the counts and displacements of MPI_Gatherv are int.
+     *
+     * \param[in] lengths number of values of each rank (root only)
+     * \param[out] recv resized to the total number of values (root only)
+     * \return total number of values (root only)
+     */
+    template <typename T>
+    Long GathervByGroups (T const* send, int send_count, amrex::Vector<int> const& lengths,
+                          amrex::Vector<T>& recv, int root)
+    {
+        const int mpisize = ParallelDescriptor::NProcs();
+        const int myproc = ParallelDescriptor::MyProc();
+
+        // first rank of each group, followed by mpisize
+        amrex::Vector<int> group_start;
+        Long total_data_size = 0;
+        if (myproc == root) {
+            Long group_size = 0;
+            group_start.push_back(0);
+            for (int i=0; i<mpisize; i++) {
+                if (group_size > 0 && group_size + lengths[i] > std::numeric_limits<int>::max()) {
+                    group_start.push_back(i);
+                    group_size = 0;
+                }
+                group_size += lengths[i];
+                total_data_size += lengths[i];
+            }
+            group_start.push_back(mpisize);
+            recv.resize(total_data_size, 0);
+        }
+        int nstarts = static_cast<int>(group_start.size());
+        ParallelDescriptor::Bcast(&nstarts, 1, root);
+        group_start.resize(nstarts);
+        ParallelDescriptor::Bcast(group_start.data(), nstarts, root);
+
+        Long offset = 0;
+        for (int g=0; g<nstarts-1; g++) {
+            const bool in_group = group_start[g] <= myproc && myproc < group_start[g+1];
+            amrex::Vector<int> length_vector;
+            amrex::Vector<int> displs_vector;
+            int group_size = 0;
+            if (myproc == root) {
+                length_vector.resize(mpisize, 0);
+                displs_vector.resize(mpisize, 0);
+                for (int i=group_start[g]; i<group_start[g+1]; i++) {
+                    length_vector[i] = lengths[i];
+                    displs_vector[i] = group_size;
+                    group_size += lengths[i];
+                }
+            }
+            ParallelDescriptor::Gatherv(send, in_group ? send_count : 0,
+                                        recv.data() + offset, length_vector, displs_vector, root);
+            offset += group_size;
+        }
+        return total_data_size;
+    }
+}
+
 // constructor
 
 FieldProbe::FieldProbe (std::string rd_name)
@@ -151,6 +218,9 @@ FieldProbe::FieldProbe (std::string rd_name)
     pp_rd_name.query("raw_fields", raw_fields);
     pp_rd_name.query("interp_order", interp_order);
     pp_rd_name.query("do_moving_window_FP", do_moving_window_FP);
+    queryWithParser(pp_rd_name, "buffer_size", m_buffer_size);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_buffer_size >= 0,
+                                     "Field probe buffer_size must be non-negative");
 
     if (WarpX::gamma_boost > 1.0_rt)
     {
@@ -225,11 +295,27 @@ FieldProbe::FieldProbe (std::string rd_name)
                 ofs << "[" << c++ << "]part_Bz_lev" + std::to_string(lev) + u_map[FieldProbePIdx::Bz];
                 ofs << m_sep;
                 ofs << "[" << c++ << "]part_S_lev" + std::to_string(lev) + u_map[FieldProbePIdx::S];
+#ifdef WARPX_MAG_LLG
+                const std::string H_units = m_field_probe_integrate ? "-(A*s/m)" : "-(A/m)";
+                for (const std::string field : {"Hx", "Hy", "Hz", "Mx", "My", "Mz",
+                                                "Hx_bias", "Hy_bias", "Hz_bias"})
+                {
+                    ofs << m_sep;
+                    ofs << "[" << c++ << "]part_" + field + "_lev" + std::to_string(lev) + H_units;
+                }
+#endif
             }
             ofs << std::endl;
 
             // close file
             ofs.close();
+
+            // replace / create binary output file
+            if (m_buffer_size > 0)
+            {
+                std::ofstream ofs_bin{m_path + m_rd_name + ".bin",
+                                      std::ofstream::out | std::ofstream::trunc | std::ofstream::binary};
+            }
         }
     }
 } // end constructor
@@ -385,6 +471,28 @@ void FieldProbe::ComputeDiags (int step)
     // get number of mesh-refinement levels
     const auto nLevel = warpx.finestLevel() + 1;
 
+    // number of probe particles on this MPI rank added to the buffer at this step
+    int nprobes_buffered = 0;
+
+    // The device buffer is resized once for all the probes of this MPI rank, before any
+    // kernel writes to it: a resize in the particle loop could move the data that the
+    // kernels of the previous tiles are still writing
+    std::size_t buffer_offset = m_dev_buffer.size();
+    if (m_intervals.contains(step+1) && m_buffer_size > 0 && ProbeInDomain())
+    {
+        long nprobes = 0;
+        for (int lev = 0; lev < nLevel; ++lev) {
+            for (FieldProbeParticleContainer::iterator pti(m_probe, lev); pti.isValid(); ++pti) {
+                nprobes += pti.numParticles();
+            }
+        }
+        const std::size_t nvalues = std::size_t(nprobes) * noutputs;
+        if (m_dev_buffer.empty()) {
+            m_dev_buffer.reserve(std::size_t(m_buffer_size) * nvalues);
+        }
+        m_dev_buffer.resize(buffer_offset + nvalues);
+    }
+
     // loop over refinement levels
     for (int lev = 0; lev < nLevel; ++lev)
     {
@@ -421,6 +529,26 @@ void FieldProbe::ComputeDiags (int step)
         amrex::IndexType const Bxtype = Bx.ixType();
         amrex::IndexType const Bytype = By.ixType();
         amrex::IndexType const Bztype = Bz.ixType();
+#ifdef WARPX_MAG_LLG
+        const amrex::MultiFab &Hx = warpx.getHfield(lev, 0);
+        const amrex::MultiFab &Hy = warpx.getHfield(lev, 1);
+        const amrex::MultiFab &Hz = warpx.getHfield(lev, 2);
+        const amrex::MultiFab &Mx = warpx.getMfield(lev, 0);
+        const amrex::MultiFab &My = warpx.getMfield(lev, 1);
+        const amrex::MultiFab &Mz = warpx.getMfield(lev, 2);
+        const amrex::MultiFab &Hx_bias = warpx.getH_biasfield(lev, 0);
+        const amrex::MultiFab &Hy_bias = warpx.getH_biasfield(lev, 1);
+        const amrex::MultiFab &Hz_bias = warpx.getH_biasfield(lev, 2);
+        amrex::IndexType const Hxtype = Hx.ixType();
+        amrex::IndexType const Hytype = Hy.ixType();
+        amrex::IndexType const Hztype = Hz.ixType();
+        amrex::IndexType const Mxtype = Mx.ixType();
+        amrex::IndexType const Mytype = My.ixType();
+        amrex::IndexType const Mztype = Mz.ixType();
+        amrex::IndexType const Hx_biastype = Hx_bias.ixType();
+        amrex::IndexType const Hy_biastype = Hy_bias.ixType();
+        amrex::IndexType const Hz_biastype = Hz_bias.ixType();
+#endif
 
         // loop over each particle
         // TODO: add OMP parallel as in PhysicalParticleContainer::Evolve
@@ -432,7 +560,7 @@ void FieldProbe::ComputeDiags (int step)
             numparticles += pti.numParticles();
         }
 
-        if (m_intervals.contains(step+1))
+        if (m_intervals.contains(step+1) && m_buffer_size == 0)
         {
             // reset m_data vector to clear pushed values. Reserves data
             m_data.clear();
@@ -487,6 +615,18 @@ void FieldProbe::ComputeDiags (int step)
                 const auto &arrBx = Bx[pti].array();
                 const auto &arrBy = By[pti].array();
                 const auto &arrBz = Bz[pti].array();
+#ifdef WARPX_MAG_LLG
+                const auto &arrHx = Hx[pti].array();
+                const auto &arrHy = Hy[pti].array();
+                const auto &arrHz = Hz[pti].array();
+                // M has 3 components on each face: Mx is component 0 on the x-faces, etc.
+                const amrex::Array4<amrex::Real const> arrMx(Mx[pti].array(), 0);
+                const amrex::Array4<amrex::Real const> arrMy(My[pti].array(), 1);
+                const amrex::Array4<amrex::Real const> arrMz(Mz[pti].array(), 2);
+                const auto &arrHx_bias = Hx_bias[pti].array();
+                const auto &arrHy_bias = Hy_bias[pti].array();
+                const auto &arrHz_bias = Hz_bias[pti].array();
+#endif
 
                 /*
                  * Make the box cell centered in preparation for the interpolation (and to avoid
@@ -504,6 +644,14 @@ void FieldProbe::ComputeDiags (int step)
                 ParticleReal* const AMREX_RESTRICT part_By = attribs[FieldProbePIdx::By].dataPtr();
                 ParticleReal* const AMREX_RESTRICT part_Bz = attribs[FieldProbePIdx::Bz].dataPtr();
                 ParticleReal* const AMREX_RESTRICT part_S = attribs[FieldProbePIdx::S].dataPtr();
+#ifdef WARPX_MAG_LLG
+                // Hx, Hy, Hz, Mx, My, Mz, Hx_bias, Hy_bias, Hz_bias
+                constexpr int n_llg = FieldProbePIdx::nattribs - FieldProbePIdx::Hx;
+                amrex::GpuArray<ParticleReal*, n_llg> part_llg;
+                for (int n = 0; n < n_llg; ++n) {
+                    part_llg[n] = attribs[FieldProbePIdx::Hx + n].dataPtr();
+                }
+#endif
 
                 const auto &xyzmin = WarpX::LowerCorner(box, lev, 0._rt);
                 const std::array<Real, 3> &dx = WarpX::CellSize(lev);
@@ -577,10 +725,75 @@ void FieldProbe::ComputeDiags (int step)
                         part_Bz[ip] = Bzp; //remember to add lorentz transform
                         part_S[ip] = S; //remember to add lorentz transform
                     }
+
+#ifdef WARPX_MAG_LLG
+                    amrex::ParticleReal Hxp = 0._prt, Hyp = 0._prt, Hzp = 0._prt;
+                    amrex::ParticleReal Mxp = 0._prt, Myp = 0._prt, Mzp = 0._prt;
+                    amrex::ParticleReal Hx_biasp = 0._prt, Hy_biasp = 0._prt, Hz_biasp = 0._prt;
+                    if (temp_raw_fields)
+                    {
+                        Hxp = arrHx(i_probe, j_probe, k_probe);
+                        Hyp = arrHy(i_probe, j_probe, k_probe);
+                        Hzp = arrHz(i_probe, j_probe, k_probe);
+                        Mxp = arrMx(i_probe, j_probe, k_probe);
+                        Myp = arrMy(i_probe, j_probe, k_probe);
+                        Mzp = arrMz(i_probe, j_probe, k_probe);
+                        Hx_biasp = arrHx_bias(i_probe, j_probe, k_probe);
+                        Hy_biasp = arrHy_bias(i_probe, j_probe, k_probe);
+                        Hz_biasp = arrHz_bias(i_probe, j_probe, k_probe);
+                    }
+                    else
+                    {
+                        doGatherShapeN(xp, yp, zp, Hxp, Hyp, Hzp, Mxp, Myp, Mzp,
+                                   arrHx, arrHy, arrHz, arrMx, arrMy, arrMz,
+                                   Hxtype, Hytype, Hztype, Mxtype, Mytype, Mztype,
+                                   dx_arr, xyzmin_arr, lo, temp_modes,
+                                   temp_interp_order, false);
+                        doGatherVectorShapeN(xp, yp, zp, Hx_biasp, Hy_biasp, Hz_biasp,
+                                   arrHx_bias, arrHy_bias, arrHz_bias,
+                                   Hx_biastype, Hy_biastype, Hz_biastype,
+                                   dx_arr, xyzmin_arr, lo, temp_modes,
+                                   temp_interp_order);
+                    }
+                    amrex::ParticleReal const llg_values[n_llg]{
+                        Hxp, Hyp, Hzp, Mxp, Myp, Mzp, Hx_biasp, Hy_biasp, Hz_biasp};
+                    for (int n = 0; n < n_llg; ++n)
+                    {
+                        if (temp_field_probe_integrate) {
+                            part_llg[n][ip] += llg_values[n] * dt;
+                        } else {
+                            part_llg[n][ip] = llg_values[n];
+                        }
+                    }
+#endif
                 });// ParallelFor Close
                 // this check is here because for m_field_probe_integrate == True, we always compute
                 // but we only write when we truly are in an output interval step
-                if (m_intervals.contains(step+1))
+                if (m_intervals.contains(step+1) && m_buffer_size > 0)
+                {
+                    // append [x, y, z, attributes] of each probe particle to the device buffer
+                    constexpr int nout = noutputs;
+                    ParticleReal* const AMREX_RESTRICT buffer = m_dev_buffer.dataPtr() + buffer_offset;
+                    buffer_offset += std::size_t(np) * nout;
+                    amrex::GpuArray<ParticleReal const*, FieldProbePIdx::nattribs> part_attribs;
+                    for (int n = 0; n < FieldProbePIdx::nattribs; ++n) {
+                        part_attribs[n] = attribs[n].dataPtr();
+                    }
+                    amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (long ip)
+                    {
+                        amrex::ParticleReal xp, yp, zp;
+                        getPosition(ip, xp, yp, zp);
+                        ParticleReal* const row = buffer + ip * nout;
+                        row[0] = xp;
+                        row[1] = yp;
+                        row[2] = zp;
+                        for (int n = 0; n < FieldProbePIdx::nattribs; ++n) {
+                            row[3 + n] = part_attribs[n][ip];
+                        }
+                    });
+                    nprobes_buffered += static_cast<int>(np);
+                }
+                else if (m_intervals.contains(step+1))
                 {
                     for (auto ip=0; ip < np; ip++)
                     {
@@ -598,64 +811,146 @@ void FieldProbe::ComputeDiags (int step)
                         m_data.push_back(part_By[ip]);
                         m_data.push_back(part_Bz[ip]);
                         m_data.push_back(part_S[ip]);
+#ifdef WARPX_MAG_LLG
+                        for (int n = 0; n < n_llg; ++n) {
+                            m_data.push_back(part_llg[n][ip]);
+                        }
+#endif
                     }
                 /* m_data now contains up-to-date values for:
-                 *  [x, y, z, Ex, Ey, Ez, Bx, By, Bz, and S] */
+                 *  [x, y, z, Ex, Ey, Ez, Bx, By, Bz, and S]
+                 *  (and Hx, Hy, Hz, Mx, My, Mz, Hx_bias, Hy_bias, Hz_bias with WARPX_MAG_LLG) */
                 }
             }
         } // end particle iterator loop
         Gpu::synchronize();
-        if (m_intervals.contains(step+1))
+        if (m_intervals.contains(step+1) && m_buffer_size == 0)
         {
             // returns total number of mpi notes into mpisize
             int mpisize = ParallelDescriptor::NProcs();
 
             // allocates data space for length_array. Will contain size of m_data from each processor
             amrex::Vector<int> length_vector;
-            amrex::Vector<int> localsize;
-
             if (amrex::ParallelDescriptor::IOProcessor()) {
                 length_vector.resize(mpisize, 0);
             }
-            localsize.resize(1,0);
-            localsize[0] = m_data.size();
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+                m_data.size() <= static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                "FieldProbe: too many probe particles on one MPI rank");
+            int localsize = static_cast<int>(m_data.size());
 
             // gather size of m_data from each processor
-            amrex::ParallelDescriptor::Gather(localsize.data(), 1,
+            amrex::ParallelDescriptor::Gather(&localsize, 1,
                                               length_vector.data(), 1,
                                               amrex::ParallelDescriptor::IOProcessorNumber());
 
-            // IO processor sums values from length_array to get size of total output array.
-            /* displs records the size of each m_data as well as previous displs. This array
-             * tells Gatherv where in the m_data_out array allocation to write incomming data. */
-            long total_data_size = 0;
-            amrex::Vector<int> displs_vector;
+            // gather m_data of varied lengths from all processors into m_data_out, whose
+            // total size may exceed the int counts of Gatherv
+            const Long total_data_size = GathervByGroups(m_data.data(), localsize, length_vector, m_data_out,
+                                                         amrex::ParallelDescriptor::IOProcessorNumber());
             if (amrex::ParallelDescriptor::IOProcessor()) {
-                displs_vector.resize(mpisize, 0);
-                displs_vector[0] = 0;
-                total_data_size += length_vector[0];
-                for (int i=1; i<mpisize; i++) {
-                    displs_vector[i] = (displs_vector[i-1] + length_vector[i-1]);
-                    total_data_size += length_vector[i];
-                }
                 // valid particles are counted (for all MPI ranks) to inform output processes as to size of output
                 m_valid_particles = total_data_size / noutputs;
-                m_data_out.resize(total_data_size, 0);
             }
-            // resize receive buffer (resize, initialize 0)
-            // gather m_data of varied lengths from all processors. Prints to m_data_out
-            amrex::ParallelDescriptor::Gatherv(m_data.data(), localsize[0],
-                                               m_data_out.data(), length_vector, displs_vector,
-                                               amrex::ParallelDescriptor::IOProcessorNumber());
         }
     }// end loop over refinement levels
+
+    if (m_intervals.contains(step+1) && m_buffer_size > 0)
+    {
+        m_buffer_steps.push_back(step + 1);
+        m_buffer_times.push_back(warpx.gett_new(0));
+        m_buffer_nprobes.push_back(nprobes_buffered);
+        if (static_cast<int>(m_buffer_steps.size()) >= m_buffer_size) { FlushBuffer(); }
+    }
     // make sure data is in m_data on the IOProcessor
     // TODO: In the future, we want to use a parallel I/O method instead (plotfiles or openPMD)
     m_last_compute_step = step;
 } // end void FieldProbe::ComputeDiags
 
-void FieldProbe::WriteToFile (int step) const
+void FieldProbe::Flush ()
+{
+    if (m_buffer_size > 0) { FlushBuffer(); }
+}
+
+void FieldProbe::FlushBuffer ()
 {
+    const int nsteps = static_cast<int>(m_buffer_steps.size());
+    if (nsteps == 0) { return; }
+
+    // copy the buffer to the host
+    amrex::Vector<amrex::ParticleReal> h_buffer(m_dev_buffer.size());
+    amrex::Gpu::copy(amrex::Gpu::deviceToHost, m_dev_buffer.begin(), m_dev_buffer.end(),
+                     h_buffer.begin());
+
+    const int mpisize = ParallelDescriptor::NProcs();
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    const bool is_ioproc = ParallelDescriptor::IOProcessor();
+
+    // number of probe particles of each buffered step, for each MPI rank
+    amrex::Vector<int> nprobes_vector;
+    amrex::Vector<int> length_vector;
+    if (is_ioproc) {
+        nprobes_vector.resize(mpisize * nsteps, 0);
+        length_vector.resize(mpisize, 0);
+    }
+    amrex::ParallelDescriptor::Gather(m_buffer_nprobes.data(), nsteps,
+                                      nprobes_vector.data(), nsteps, ioproc);
+
+    // gather the buffers of all MPI ranks, once for all buffered steps
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        h_buffer.size() <= static_cast<std::size_t>(std::numeric_limits<int>::max()),
+        "FieldProbe: the buffer of one MPI rank is too large, reduce buffer_size");
+    int localsize = static_cast<int>(h_buffer.size());
+    amrex::ParallelDescriptor::Gather(&localsize, 1, length_vector.data(), 1, ioproc);
+    amrex::Vector<amrex::ParticleReal> data_out;
+    GathervByGroups(h_buffer.data(), localsize, length_vector, data_out, ioproc);
+
+    if (is_ioproc)
+    {
+        // Each step is written as: step and number of probe particles (int64) and time
+        // (double), followed by [x, y, z, attributes] (double) for each probe particle
+        std::ofstream ofs{m_path + m_rd_name + ".bin",
+                          std::ofstream::out | std::ofstream::app | std::ofstream::binary};
+        // offset of the data of each rank in data_out
+        amrex::Vector<Long> rank_offsets(mpisize, 0);
+        for (int i=1; i<mpisize; i++) {
+            rank_offsets[i] = rank_offsets[i-1] + length_vector[i-1];
+        }
+        amrex::Vector<double> record;
+        for (int is = 0; is < nsteps; ++is)
+        {
+            std::int64_t nprobes = 0;
+            for (int i=0; i<mpisize; i++) { nprobes += nprobes_vector[i * nsteps + is]; }
+            const std::int64_t step = m_buffer_steps[is];
+            const double time = m_buffer_times[is];
+            ofs.write(reinterpret_cast<const char*>(&step), sizeof(std::int64_t));
+            ofs.write(reinterpret_cast<const char*>(&nprobes), sizeof(std::int64_t));
+            ofs.write(reinterpret_cast<const char*>(&time), sizeof(double));
+
+            record.clear();
+            for (int i=0; i<mpisize; i++)
+            {
+                const long n = long(nprobes_vector[i * nsteps + is]) * noutputs;
+                record.insert(record.end(), data_out.begin() + rank_offsets[i],
+                              data_out.begin() + rank_offsets[i] + n);
+                rank_offsets[i] += n;
+            }
+            ofs.write(reinterpret_cast<const char*>(record.data()), record.size() * sizeof(double));
+        }
+        if (!ofs) { amrex::Abort("Failed to write " + m_path + m_rd_name + ".bin"); }
+    }
+
+    m_dev_buffer.clear();
+    m_buffer_steps.clear();
+    m_buffer_times.clear();
+    m_buffer_nprobes.clear();
+}
+
+void FieldProbe::WriteToFile (int step)
+{
+    // the buffered data is written by FlushBuffer
+    if (m_buffer_size > 0) { return; }
+
     if (ProbeInDomain() && amrex::ParallelDescriptor::IOProcessor())
     {
         // open file
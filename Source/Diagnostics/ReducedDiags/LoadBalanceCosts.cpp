@@ -243,7 +243,7 @@ void LoadBalanceCosts::ComputeDiags (int step)
 }
 
 // write to file function for cost
-void LoadBalanceCosts::WriteToFile (int step) const
+void LoadBalanceCosts::WriteToFile (int step)
 {
     // open file
     std::ofstream ofs{m_path + m_rd_name + "." + m_extension,
@@ -0,0 +1,320 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "MaterialEnergy.H"
+
+#include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#include "Utils/CoarsenIO.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX_Array4.H>
+#include <AMReX_Box.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuControl.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Parser.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Reduce.H>
+#include <AMReX_Tuple.H>
+#include <AMReX_iMultiFab.H>
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace amrex;
+using namespace amrex::literals;
+
+namespace
+{
+    /** Electric energy, magnetic energy and loss of each material */
+    constexpr int nsums = 3*MaterialEnergy::max_materials;
+    using SumSequence = std::make_index_sequence<nsums>;
+
+    template <std::size_t, typename T>
+    struct Repeat { using type = T; };
+
+    template <std::size_t... I>
+    auto SumOps (std::index_sequence<I...>) -> ReduceOps<typename Repeat<I, ReduceOpSum>::type...>;
+    template <std::size_t... I>
+    auto SumData (std::index_sequence<I...>) -> ReduceData<typename Repeat<I, Real>::type...>;
+
+    using MaterialReduceOps = decltype(SumOps(SumSequence{}));
+    using MaterialReduceData = decltype(SumData(SumSequence{}));
+    using MaterialReduceTuple = typename MaterialReduceData::Type;
+
+    template <std::size_t... I>
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    MaterialReduceTuple ToTuple (const Real* values, std::index_sequence<I...>)
+    {
+        return MaterialReduceTuple(values[I]...);
+    }
+
+    template <std::size_t... I>
+    void FromTuple (const MaterialReduceTuple& tuple, Real* values, std::index_sequence<I...>)
+    {
+        ((values[I] = amrex::get<I>(tuple)), ...);
+    }
+}
+
+// constructor
+MaterialEnergy::MaterialEnergy (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+#if !defined(WARPX_DIM_3D)
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(false,
+        "MaterialEnergy reduced diagnostics only works in 3D.");
+#endif
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(WarpX::em_solver_medium == MediumForEM::Macroscopic,
+        "MaterialEnergy reduced diagnostics requires algo.em_solver_medium = macroscopic.");
+
+    ParmParse pp_rd_name(rd_name);
+    pp_rd_name.queryarr("material_names", m_material_names);
+    for (const auto& material : m_material_names) {
+        ParmParse pp_material(rd_name + "." + material);
+        std::string region_string = "";
+        Store_parserString(pp_material, "region_function(x,y,z)", region_string);
+        m_region_parsers.push_back(std::make_unique<amrex::Parser>(
+            makeParser(region_string, {"x","y","z"})));
+    }
+    m_material_names.push_back("background");
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        static_cast<int>(m_material_names.size()) <= max_materials,
+        rd_name + ".material_names can have at most " + std::to_string(max_materials - 1) + " materials");
+
+    // The region functions are compiled once
+    std::vector<ParserExecutor<3>> h_regions;
+    for (const auto& parser : m_region_parsers) h_regions.push_back(parser->compile<3>());
+    m_regions.resize(h_regions.size());
+    Gpu::copyAsync(Gpu::hostToDevice, h_regions.begin(), h_regions.end(), m_regions.begin());
+    Gpu::streamSynchronize();
+
+    constexpr int noutputs = 3; // electric energy, magnetic energy and loss
+    m_data.resize(noutputs*m_material_names.size(), 0.0_rt);
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << c++ << "]step()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time(s)";
+            for (const auto& material : m_material_names)
+            {
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" + material + "_WE(J)";
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" + material + "_WM(J)";
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" + material + "_loss(W)";
+            }
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+// function that computes the energies and losses of each material
+void MaterialEnergy::ComputeDiags (int step)
+{
+    ComputeDiagsWithOwnBatch(step);
+}
+// end void MaterialEnergy::ComputeDiags
+
+// function that computes the material of each cell
+void MaterialEnergy::UpdateMaterialIds ()
+{
+    auto & warpx = WarpX::GetInstance();
+    const MultiFab& sigma_mf = warpx.GetMacroscopicProperties().getsigma_mf();
+
+    // Only recomputed after a regrid or a load balance
+    if (m_mat_id && m_mat_id->boxArray() == sigma_mf.boxArray() &&
+        m_mat_id->DistributionMap() == sigma_mf.DistributionMap()) { return; }
+
+    WARPX_PROFILE("MaterialEnergy::UpdateMaterialIds()");
+
+    const Geometry& geom = warpx.Geom(0);
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+
+    const int nregions = static_cast<int>(m_region_parsers.size());
+    const ParserExecutor<3>* const regions = m_regions.dataPtr();
+
+    m_mat_id = std::make_unique<iMultiFab>(sigma_mf.boxArray(), sigma_mf.DistributionMap(), 1, 0);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(*m_mat_id, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<int> const& id = m_mat_id->array(mfi);
+
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k)
+        {
+            const Real x = problo[0] + (i + 0.5_rt)*dx[0];
+            const Real y = problo[1] + (j + 0.5_rt)*dx[1];
+            const Real z = problo[2] + (k + 0.5_rt)*dx[2];
+            int imat = nregions;
+            for (int r = 0; r < nregions; ++r) {
+                if (regions[r](x, y, z) != 0._rt) {
+                    imat = r;
+                    break;
+                }
+            }
+            id(i,j,k) = imat;
+        });
+    }
+}
+// end void MaterialEnergy::UpdateMaterialIds
+
+// function that computes the energies and losses of each material on this MPI rank
+void MaterialEnergy::AddToBatch (int step, ReductionBatch& batch)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    WARPX_PROFILE("MaterialEnergy::AddToBatch()");
+
+    UpdateMaterialIds();
+
+    auto & warpx = WarpX::GetInstance();
+
+    // The macroscopic properties are only defined on level 0
+    constexpr int lev = 0;
+
+    const Geometry& geom = warpx.Geom(lev);
+    const auto dx = geom.CellSizeArray();
+    const Real dV = AMREX_D_TERM(dx[0], *dx[1], *dx[2]);
+
+    MacroscopicProperties& macroscopic = warpx.GetMacroscopicProperties();
+    const MultiFab& sigma_mf = macroscopic.getsigma_mf();
+    const MultiFab& eps_mf = macroscopic.getepsilon_mf();
+    const MultiFab& mu_mf = macroscopic.getmu_mf();
+
+    const MultiFab& Ex = warpx.getEfield_fp(lev,0);
+    const MultiFab& Ey = warpx.getEfield_fp(lev,1);
+    const MultiFab& Ez = warpx.getEfield_fp(lev,2);
+#ifdef WARPX_MAG_LLG
+    const MultiFab& Hx = warpx.getHfield_fp(lev,0);
+    const MultiFab& Hy = warpx.getHfield_fp(lev,1);
+    const MultiFab& Hz = warpx.getHfield_fp(lev,2);
+    constexpr bool H_from_B = false;
+#else
+    const MultiFab& Hx = warpx.getBfield_fp(lev,0);
+    const MultiFab& Hy = warpx.getBfield_fp(lev,1);
+    const MultiFab& Hz = warpx.getBfield_fp(lev,2);
+    constexpr bool H_from_B = true;
+#endif
+
+    GpuArray<int,3> Ex_type{0,0,0}, Ey_type{0,0,0}, Ez_type{0,0,0};
+    GpuArray<int,3> Hx_type{0,0,0}, Hy_type{0,0,0}, Hz_type{0,0,0};
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        Ex_type[idim] = Ex.ixType()[idim];
+        Ey_type[idim] = Ey.ixType()[idim];
+        Ez_type[idim] = Ez.ixType()[idim];
+        Hx_type[idim] = Hx.ixType()[idim];
+        Hy_type[idim] = Hy.ixType()[idim];
+        Hz_type[idim] = Hz.ixType()[idim];
+    }
+    const GpuArray<int,3> cc_type{0,0,0};
+    const GpuArray<int,3> ratio{1,1,1};
+
+    // All the materials in one pass: each cell adds to the sums of its material
+    MaterialReduceOps reduce_op;
+    MaterialReduceData rd(reduce_op);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(sigma_mf, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<int const> const& id = m_mat_id->const_array(mfi);
+        Array4<Real const> const& sigma = sigma_mf.const_array(mfi);
+        Array4<Real const> const& eps = eps_mf.const_array(mfi);
+        Array4<Real const> const& mu = mu_mf.const_array(mfi);
+        Array4<Real const> const& Ex_arr = Ex.const_array(mfi);
+        Array4<Real const> const& Ey_arr = Ey.const_array(mfi);
+        Array4<Real const> const& Ez_arr = Ez.const_array(mfi);
+        Array4<Real const> const& Hx_arr = Hx.const_array(mfi);
+        Array4<Real const> const& Hy_arr = Hy.const_array(mfi);
+        Array4<Real const> const& Hz_arr = Hz.const_array(mfi);
+
+        reduce_op.eval(bx, rd,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> MaterialReduceTuple
+            {
+                const Real ex = CoarsenIO::Interp(Ex_arr, Ex_type, cc_type, ratio, i, j, k, 0);
+                const Real ey = CoarsenIO::Interp(Ey_arr, Ey_type, cc_type, ratio, i, j, k, 0);
+                const Real ez = CoarsenIO::Interp(Ez_arr, Ez_type, cc_type, ratio, i, j, k, 0);
+                Real hx = CoarsenIO::Interp(Hx_arr, Hx_type, cc_type, ratio, i, j, k, 0);
+                Real hy = CoarsenIO::Interp(Hy_arr, Hy_type, cc_type, ratio, i, j, k, 0);
+                Real hz = CoarsenIO::Interp(Hz_arr, Hz_type, cc_type, ratio, i, j, k, 0);
+                if (H_from_B) {
+                    const Real inv_mu = 1._rt/mu(i,j,k);
+                    hx *= inv_mu;
+                    hy *= inv_mu;
+                    hz *= inv_mu;
+                }
+                const Real E2 = ex*ex + ey*ey + ez*ez;
+                const Real H2 = hx*hx + hy*hy + hz*hz;
+                Real sums[nsums] = {};
+                const int imat = id(i,j,k);
+                sums[3*imat] = 0.5_rt*eps(i,j,k)*E2*dV;
+                sums[3*imat+1] = 0.5_rt*mu(i,j,k)*H2*dV;
+                sums[3*imat+2] = sigma(i,j,k)*E2*dV;
+                return ToTuple(sums, SumSequence{});
+            });
+    }
+
+    Real sums[nsums];
+    FromTuple(rd.value(reduce_op), sums, SumSequence{});
+    for (int i = 0; i < static_cast<int>(m_data.size()); ++i) {
+        m_data[i] = sums[i];
+    }
+
+    // summed over mpi ranks with the other diags
+    m_batch_offset = batch.AddSum(m_data);
+}
+// end void MaterialEnergy::AddToBatch
+
+// function that reads the energies and losses summed over all MPI ranks
+void MaterialEnergy::ReadFromBatch (int step, const ReductionBatch& batch)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    for (int i = 0; i < static_cast<int>(m_data.size()); ++i) {
+        m_data[i] = batch.Sum(m_batch_offset + i);
+    }
+
+    /* m_data now contains up-to-date values for:
+     *  [electric energy, magnetic energy and Ohmic loss of material 0,
+     *   electric energy, magnetic energy and Ohmic loss of material 1,
+     *   ...,
+     *   electric energy, magnetic energy and Ohmic loss of the background] */
+}
+// end void MaterialEnergy::ReadFromBatch
@@ -14,14 +14,17 @@
 #include "FieldReduction.H"
 #include "LoadBalanceCosts.H"
 #include "LoadBalanceEfficiency.H"
+#include "MaterialEnergy.H"
 #include "ParticleEnergy.H"
 #include "ParticleExtrema.H"
 #include "ParticleHistogram.H"
 #include "ParticleMomentum.H"
 #include "ParticleNumber.H"
+#include "PoyntingFlux.H"
 #include "RhoMaximum.H"
 #include "RawEFieldReduction.H"
 #include "RawBFieldReduction.H"
+#include "TimingBreakdown.H"
 #include "Utils/IntervalsParser.H"
 #include "Utils/TextMsg.H"
 #include "Utils/WarpXProfilerWrapper.H"
@@ -33,11 +36,31 @@
 
 #include <algorithm>
 #include <functional>
+#include <iostream>
 #include <iterator>
 #include <map>
 
 using namespace amrex;
 
+namespace
+{
+    /// reduced diags whose buffered output lines are written if the run aborts
+    MultiReducedDiags* reduced_diags_to_flush_on_abort = nullptr;
+
+    /** Error handler of AMReX: writes the buffered output lines of the reduced diags,
+     *  then aborts as AMReX does without an error handler */
+    void FlushAndAbort (const char* msg)
+    {
+        // the lines are only written once, even if writing them fails and aborts again
+        MultiReducedDiags* const reduced_diags = reduced_diags_to_flush_on_abort;
+        reduced_diags_to_flush_on_abort = nullptr;
+        if (reduced_diags) { reduced_diags->FlushOnAbort(); }
+
+        std::cerr << msg << "!!!\n" << std::flush;
+        ParallelDescriptor::Abort();
+    }
+}
+
 // constructor
 MultiReducedDiags::MultiReducedDiags ()
 {
@@ -58,6 +81,7 @@ MultiReducedDiags::MultiReducedDiags ()
             {"FieldMaximum",          [](CS s){return std::make_unique<FieldMaximum>(s);}},
             {"FieldProbe",            [](CS s){return std::make_unique<FieldProbe>(s);}},
             {"FieldReduction",        [](CS s){return std::make_unique<FieldReduction>(s);}},
+            {"MaterialEnergy",        [](CS s){return std::make_unique<MaterialEnergy>(s);}},
             {"RhoMaximum",            [](CS s){return std::make_unique<RhoMaximum>(s);}},
             {"BeamRelevant",          [](CS s){return std::make_unique<BeamRelevant>(s);}},
             {"LoadBalanceCosts",      [](CS s){return std::make_unique<LoadBalanceCosts>(s);}},
@@ -65,8 +89,10 @@ MultiReducedDiags::MultiReducedDiags ()
             {"ParticleHistogram",     [](CS s){return std::make_unique<ParticleHistogram>(s);}},
             {"ParticleNumber",        [](CS s){return std::make_unique<ParticleNumber>(s);}},
             {"ParticleExtrema",       [](CS s){return std::make_unique<ParticleExtrema>(s);}},
+            {"PoyntingFlux",          [](CS s){return std::make_unique<PoyntingFlux>(s);}},
             {"RawEFieldReduction",    [](CS s){return std::make_unique<RawEFieldReduction>(s);}},
-            {"RawBFieldReduction",    [](CS s){return std::make_unique<RawBFieldReduction>(s);}}
+            {"RawBFieldReduction",    [](CS s){return std::make_unique<RawBFieldReduction>(s);}},
+            {"TimingBreakdown",       [](CS s){return std::make_unique<TimingBreakdown>(s);}}
         };
     // loop over all reduced diags and fill m_multi_rd with requested reduced diags
     std::transform(m_rd_names.begin(), m_rd_names.end(), std::back_inserter(m_multi_rd),
@@ -85,9 +111,24 @@ MultiReducedDiags::MultiReducedDiags ()
             return reduced_diags_dictionary.at(rd_type)(rd_name);
         });
     // end loop over all reduced diags
+
+    // write the buffered output lines if the run aborts, unless the errors of AMReX
+    // are thrown as exceptions (e.g., in Python), which the caller handles
+    if (!amrex::system::throw_exception) {
+        reduced_diags_to_flush_on_abort = this;
+        amrex::SetErrorHandler(FlushAndAbort);
+    }
 }
 // end constructor
 
+MultiReducedDiags::~MultiReducedDiags ()
+{
+    if (reduced_diags_to_flush_on_abort == this) {
+        reduced_diags_to_flush_on_abort = nullptr;
+        amrex::SetErrorHandler(nullptr);
+    }
+}
+
 void MultiReducedDiags::InitData ()
 {
     // loop over all reduced diags
@@ -110,10 +151,22 @@ void MultiReducedDiags::ComputeDiags (int step)
 {
     WARPX_PROFILE("MultiReducedDiags::ComputeDiags()");
 
-    // loop over all reduced diags
+    m_batch.Clear();
+
+    // loop over all reduced diags, to compute their local partial results
     for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
     {
-        m_multi_rd[i_rd] -> ComputeDiags(step);
+        m_multi_rd[i_rd] -> AddToBatch(step, m_batch);
+    }
+    // end loop over all reduced diags
+
+    // one MPI reduction for the sums and one for the maxima of all reduced diags
+    m_batch.Reduce();
+
+    // loop over all reduced diags, to finish them with the reduced results
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        m_multi_rd[i_rd] -> ReadFromBatch(step, m_batch);
     }
     // end loop over all reduced diags
 }
@@ -137,3 +190,63 @@ void MultiReducedDiags::WriteToFile (int step)
     // end loop over all reduced diags
 }
 // end void MultiReducedDiags::WriteToFile
+
+// function to write buffered data at the end of the simulation
+void MultiReducedDiags::Finalize ()
+{
+    // loop over all reduced diags
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        m_multi_rd[i_rd]->Finalize();
+    }
+    // end loop over all reduced diags
+}
+// end void MultiReducedDiags::Finalize
+
+// function to write buffered data at checkpoints and on signals
+void MultiReducedDiags::Flush ()
+{
+    // loop over all reduced diags
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        m_multi_rd[i_rd]->Flush();
+    }
+    // end loop over all reduced diags
+}
+// end void MultiReducedDiags::Flush
+
+// function to write the buffered output lines of this MPI rank when the run aborts
+void MultiReducedDiags::FlushOnAbort ()
+{
+    // loop over all reduced diags
+    for (int i_rd = 0; i_rd < static_cast<int>(m_multi_rd.size()); ++i_rd)
+    {
+        m_multi_rd[i_rd]->FlushOnAbort();
+    }
+    // end loop over all reduced diags
+}
+// end void MultiReducedDiags::FlushOnAbort
+
+// function to write the state of the reduced diags to a checkpoint
+void MultiReducedDiags::WriteCheckpointData (const std::string& dir)
+{
+    // loop over all reduced diags
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        m_multi_rd[i_rd]->WriteCheckpointData(dir);
+    }
+    // end loop over all reduced diags
+}
+// end void MultiReducedDiags::WriteCheckpointData
+
+// function to read the state of the reduced diags from a checkpoint
+void MultiReducedDiags::ReadCheckpointData (const std::string& dir)
+{
+    // loop over all reduced diags
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        m_multi_rd[i_rd]->ReadCheckpointData(dir);
+    }
+    // end loop over all reduced diags
+}
+// end void MultiReducedDiags::ReadCheckpointData
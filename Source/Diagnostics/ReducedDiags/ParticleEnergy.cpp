@@ -87,6 +87,11 @@ ParticleEnergy::ParticleEnergy (std::string rd_name)
 }
 
 void ParticleEnergy::ComputeDiags (int step)
+{
+    ComputeDiagsWithOwnBatch(step);
+}
+
+void ParticleEnergy::AddToBatch (int step, ReductionBatch& batch)
 {
     // Check if the diags should be done
     if (m_intervals.contains(step+1) == false)
@@ -100,10 +105,8 @@ void ParticleEnergy::ComputeDiags (int step)
     // Get number of species
     const int nSpecies = mypc.nSpecies();
 
-    // Some useful offsets to fill m_data below
-    int offset_total_species, offset_mean_species, offset_mean_all;
-
-    amrex::Real Wtot = 0.0_rt;
+    // Sums of energies and weights of each species on this MPI rank
+    std::vector<Real> local_sums(2*nSpecies, 0.0_rt);
 
     // Loop over species
     for (int i_s = 0; i_s < nSpecies; ++i_s)
@@ -159,9 +162,36 @@ void ParticleEnergy::ComputeDiags (int step)
             Ws   = amrex::get<1>(r);
         }
 
-        // Reduced sum over MPI ranks
-        ParallelDescriptor::ReduceRealSum(Etot, ParallelDescriptor::IOProcessorNumber());
-        ParallelDescriptor::ReduceRealSum(Ws  , ParallelDescriptor::IOProcessorNumber());
+        local_sums[2*i_s] = Etot;
+        local_sums[2*i_s+1] = Ws;
+    }
+
+    // Summed over MPI ranks with the other diags
+    m_batch_offset = batch.AddSum(local_sums);
+}
+
+void ParticleEnergy::ReadFromBatch (int step, const ReductionBatch& batch)
+{
+    // Check if the diags should be done
+    if (m_intervals.contains(step+1) == false)
+    {
+        return;
+    }
+
+    // Get number of species
+    const int nSpecies = WarpX::GetInstance().GetPartContainer().nSpecies();
+
+    // Some useful offsets to fill m_data below
+    int offset_total_species, offset_mean_species, offset_mean_all;
+
+    amrex::Real Wtot = 0.0_rt;
+
+    // Loop over species
+    for (int i_s = 0; i_s < nSpecies; ++i_s)
+    {
+        // Sums over all MPI ranks
+        const amrex::Real Etot = batch.Sum(m_batch_offset + 2*i_s);
+        const amrex::Real Ws   = batch.Sum(m_batch_offset + 2*i_s+1);
 
         // Accumulate sum of weights over all species (must come after MPI reduction of Ws)
         Wtot += Ws;
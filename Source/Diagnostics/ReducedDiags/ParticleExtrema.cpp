@@ -48,6 +48,7 @@
 #include <array>
 #include <cmath>
 #include <fstream>
+#include <limits>
 #include <map>
 #include <vector>
 
@@ -164,10 +165,20 @@ ParticleExtrema::ParticleExtrema (std::string rd_name)
 
 // function that computes extrema
 void ParticleExtrema::ComputeDiags (int step)
+{
+    ComputeDiagsWithOwnBatch(step);
+}
+// end void ParticleExtrema::ComputeDiags
+
+// function that computes the particle extrema on this MPI rank
+void ParticleExtrema::AddToBatch (int step, ReductionBatch& batch)
 {
     // Judge if the diags should be done
     if (!m_intervals.contains(step+1)) { return; }
 
+    // local extrema, the minima being stored as the maxima of their opposites
+    std::vector<Real> local_max(m_data.size(), std::numeric_limits<Real>::lowest());
+
     // get MultiParticleContainer class object
     auto & mypc = WarpX::GetInstance().GetPartContainer();
 
@@ -212,14 +223,12 @@ void ParticleExtrema::ComputeDiags (int step)
         Real xmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0)*std::cos(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMin(xmin);
 #elif (defined WARPX_DIM_1D_Z)
         Real xmin = 0.0_rt;
 #else
         Real xmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0); });
-        ParallelDescriptor::ReduceRealMin(xmin);
 #endif
 
         // xmax
@@ -227,14 +236,12 @@ void ParticleExtrema::ComputeDiags (int step)
         Real xmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0)*std::cos(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMax(xmax);
 #elif (defined WARPX_DIM_1D_Z)
         Real xmax = 0.0_rt;
 #else
         Real xmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0); });
-        ParallelDescriptor::ReduceRealMax(xmax);
 #endif
 
         // ymin
@@ -242,14 +249,12 @@ void ParticleExtrema::ComputeDiags (int step)
         Real ymin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0)*std::sin(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMin(ymin);
 #elif (defined WARPX_DIM_XZ || WARPX_DIM_1D_Z)
         Real ymin = 0.0_rt;
 #else
         Real ymin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(1); });
-        ParallelDescriptor::ReduceRealMin(ymin);
 #endif
 
         // ymax
@@ -257,63 +262,53 @@ void ParticleExtrema::ComputeDiags (int step)
         Real ymax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0)*std::sin(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMax(ymax);
 #elif (defined WARPX_DIM_XZ || WARPX_DIM_1D_Z)
         Real ymax = 0.0_rt;
 #else
         Real ymax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(1); });
-        ParallelDescriptor::ReduceRealMax(ymax);
 #endif
 
         // zmin
         Real zmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(index_z); });
-        ParallelDescriptor::ReduceRealMin(zmin);
 
         // zmax
         Real zmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(index_z); });
-        ParallelDescriptor::ReduceRealMax(zmax);
 
         // uxmin
         Real uxmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::ux); });
-        ParallelDescriptor::ReduceRealMin(uxmin);
 
         // uxmax
         Real uxmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::ux); });
-        ParallelDescriptor::ReduceRealMax(uxmax);
 
         // uymin
         Real uymin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::uy); });
-        ParallelDescriptor::ReduceRealMin(uymin);
 
         // uymax
         Real uymax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::uy); });
-        ParallelDescriptor::ReduceRealMax(uymax);
 
         // uzmin
         Real uzmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::uz); });
-        ParallelDescriptor::ReduceRealMin(uzmin);
 
         // uzmax
         Real uzmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::uz); });
-        ParallelDescriptor::ReduceRealMax(uzmax);
 
         // gmin
         Real gmin = 0.0_rt;
@@ -338,7 +333,6 @@ void ParticleExtrema::ComputeDiags (int step)
                 return std::sqrt(1.0_rt + us*inv_c2);
             });
         }
-        ParallelDescriptor::ReduceRealMin(gmin);
 
         // gmax
         Real gmax = 0.0_rt;
@@ -363,19 +357,16 @@ void ParticleExtrema::ComputeDiags (int step)
                 return std::sqrt(1.0_rt + us*inv_c2);
             });
         }
-        ParallelDescriptor::ReduceRealMax(gmax);
 
         // wmin
         Real wmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::w); });
-        ParallelDescriptor::ReduceRealMin(wmin);
 
         // wmax
         Real wmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::w); });
-        ParallelDescriptor::ReduceRealMax(wmax);
 
 #if (defined WARPX_QED)
         // get number of level (int)
@@ -483,34 +474,50 @@ void ParticleExtrema::ComputeDiags (int step)
                 chimin_f = *std::min_element(chimin.begin(), chimin.end());
                 chimax_f = *std::max_element(chimax.begin(), chimax.end());
             }
-            ParallelDescriptor::ReduceRealMin(chimin_f);
-            ParallelDescriptor::ReduceRealMax(chimax_f);
         }
 #endif
-        m_data[0]  = xmin;
-        m_data[1]  = xmax;
-        m_data[2]  = ymin;
-        m_data[3]  = ymax;
-        m_data[4]  = zmin;
-        m_data[5]  = zmax;
-        m_data[6]  = uxmin*m;
-        m_data[7]  = uxmax*m;
-        m_data[8]  = uymin*m;
-        m_data[9]  = uymax*m;
-        m_data[10] = uzmin*m;
-        m_data[11] = uzmax*m;
-        m_data[12] = gmin;
-        m_data[13] = gmax;
-        m_data[14] = wmin;
-        m_data[15] = wmax;
+        local_max[0]  = -xmin;
+        local_max[1]  = xmax;
+        local_max[2]  = -ymin;
+        local_max[3]  = ymax;
+        local_max[4]  = -zmin;
+        local_max[5]  = zmax;
+        local_max[6]  = -uxmin*m;
+        local_max[7]  = uxmax*m;
+        local_max[8]  = -uymin*m;
+        local_max[9]  = uymax*m;
+        local_max[10] = -uzmin*m;
+        local_max[11] = uzmax*m;
+        local_max[12] = -gmin;
+        local_max[13] = gmax;
+        local_max[14] = -wmin;
+        local_max[15] = wmax;
 #if (defined WARPX_QED)
         if (myspc.DoQED())
         {
-            m_data[16] = chimin_f;
-            m_data[17] = chimax_f;
+            local_max[16] = -chimin_f;
+            local_max[17] = chimax_f;
         }
 #endif
     }
     // end loop over species
+
+    // maxima over mpi ranks with the other diags
+    m_batch_offset = batch.AddMax(local_max);
+}
+// end void ParticleExtrema::AddToBatch
+
+// function that reads the particle extrema over all MPI ranks
+void ParticleExtrema::ReadFromBatch (int step, const ReductionBatch& batch)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    // minima at even indices, maxima at odd indices
+    for (int i = 0; i < static_cast<int>(m_data.size()); ++i)
+    {
+        const Real value = batch.Max(m_batch_offset + i);
+        m_data[i] = (i % 2 == 0) ? -value : value;
+    }
 }
-// end void ParticleEnergy::ComputeDiags
+// end void ParticleExtrema::ReadFromBatch
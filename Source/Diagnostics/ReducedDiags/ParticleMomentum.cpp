@@ -115,6 +115,11 @@ ParticleMomentum::ParticleMomentum (std::string rd_name)
 }
 
 void ParticleMomentum::ComputeDiags (int step)
+{
+    ComputeDiagsWithOwnBatch(step);
+}
+
+void ParticleMomentum::AddToBatch (int step, ReductionBatch& batch)
 {
     // Check if the diags should be done
     if (m_intervals.contains(step+1) == false)
@@ -128,10 +133,8 @@ void ParticleMomentum::ComputeDiags (int step)
     // Get number of species
     const int nSpecies = mypc.nSpecies();
 
-    // Some useful offsets to fill m_data below
-    int offset_total_species, offset_mean_species, offset_mean_all;
-
-    amrex::Real Wtot = 0.0_rt;
+    // Sums of momenta and weights of each species on this MPI rank
+    std::vector<Real> local_sums(4*nSpecies, 0.0_rt);
 
     // Loop over species
     for (int i_s = 0; i_s < nSpecies; ++i_s)
@@ -162,16 +165,40 @@ void ParticleMomentum::ComputeDiags (int step)
             },
             reduce_ops);
 
-        amrex::Real Px = amrex::get<0>(r);
-        amrex::Real Py = amrex::get<1>(r);
-        amrex::Real Pz = amrex::get<2>(r);
-        amrex::Real Ws = amrex::get<3>(r);
+        local_sums[4*i_s+0] = amrex::get<0>(r);
+        local_sums[4*i_s+1] = amrex::get<1>(r);
+        local_sums[4*i_s+2] = amrex::get<2>(r);
+        local_sums[4*i_s+3] = amrex::get<3>(r);
+    }
+
+    // Summed over MPI ranks with the other diags
+    m_batch_offset = batch.AddSum(local_sums);
+}
 
-        // Reduced sum over MPI ranks
-        ParallelDescriptor::ReduceRealSum(Px, ParallelDescriptor::IOProcessorNumber());
-        ParallelDescriptor::ReduceRealSum(Py, ParallelDescriptor::IOProcessorNumber());
-        ParallelDescriptor::ReduceRealSum(Pz, ParallelDescriptor::IOProcessorNumber());
-        ParallelDescriptor::ReduceRealSum(Ws, ParallelDescriptor::IOProcessorNumber());
+void ParticleMomentum::ReadFromBatch (int step, const ReductionBatch& batch)
+{
+    // Check if the diags should be done
+    if (m_intervals.contains(step+1) == false)
+    {
+        return;
+    }
+
+    // Get number of species
+    const int nSpecies = WarpX::GetInstance().GetPartContainer().nSpecies();
+
+    // Some useful offsets to fill m_data below
+    int offset_total_species, offset_mean_species, offset_mean_all;
+
+    amrex::Real Wtot = 0.0_rt;
+
+    // Loop over species
+    for (int i_s = 0; i_s < nSpecies; ++i_s)
+    {
+        // Sums over all MPI ranks
+        const amrex::Real Px = batch.Sum(m_batch_offset + 4*i_s+0);
+        const amrex::Real Py = batch.Sum(m_batch_offset + 4*i_s+1);
+        const amrex::Real Pz = batch.Sum(m_batch_offset + 4*i_s+2);
+        const amrex::Real Ws = batch.Sum(m_batch_offset + 4*i_s+3);
 
         // Accumulate sum of weights over all species (must come after MPI reduction of Ws)
         Wtot += Ws;
@@ -86,6 +86,13 @@ ParticleNumber::ParticleNumber (std::string rd_name)
 
 // function that computes total number of macroparticles and physical particles
 void ParticleNumber::ComputeDiags (int step)
+{
+    ComputeDiagsWithOwnBatch(step);
+}
+// end void ParticleNumber::ComputeDiags
+
+// function that computes the number of particles on this MPI rank
+void ParticleNumber::AddToBatch (int step, ReductionBatch& batch)
 {
     // Judge if the diags should be done
     if (!m_intervals.contains(step+1)) { return; }
@@ -96,18 +103,8 @@ void ParticleNumber::ComputeDiags (int step)
     // get number of species (int)
     const auto nSpecies = mypc.nSpecies();
 
-    // Index of total number of macroparticles (all species) in m_data
-    constexpr int idx_total_macroparticles = 0;
-    // Index of first species macroparticle number in m_data
-    constexpr int idx_first_species_macroparticles = 1;
-    // Index of total weight (all species) in m_data
-    const int idx_total_sum_weight = idx_first_species_macroparticles + nSpecies;
-    // Index of first species weight in m_data
-    const int idx_first_species_sum_weight = idx_total_sum_weight + 1;
-
-    // Initialize total number of macroparticles and total weight (all species) to 0
-    m_data[idx_total_macroparticles] = 0.0_rt;
-    m_data[idx_total_sum_weight] = 0.0_rt;
+    // number of macroparticles and sum of weights of each species on this MPI rank
+    std::vector<Real> local_sums(2*nSpecies, 0.0_rt);
 
     // loop over species
     for (int i_s = 0; i_s < nSpecies; ++i_s)
@@ -115,25 +112,55 @@ void ParticleNumber::ComputeDiags (int step)
         // get WarpXParticleContainer class object
         const auto & myspc = mypc.GetParticleContainer(i_s);
 
-        // Save total number of macroparticles for this species
-        m_data[idx_first_species_macroparticles + i_s] = myspc.TotalNumberOfParticles();
+        // Number of macroparticles of this species on this MPI rank
+        constexpr bool only_valid = true;
+        constexpr bool only_local = true;
+        local_sums[2*i_s] = static_cast<Real>(myspc.TotalNumberOfParticles(only_valid, only_local));
 
         using PType = typename WarpXParticleContainer::SuperParticleType;
 
         // Reduction to compute sum of weights for this species
-        auto Wtot = ReduceSum( myspc,
+        local_sums[2*i_s+1] = ReduceSum( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> amrex::Real
         {
             return p.rdata(PIdx::w);
         });
+    }
+    // end loop over species
 
-        // MPI reduction
-        amrex::ParallelDescriptor::ReduceRealSum
-            (Wtot, amrex::ParallelDescriptor::IOProcessorNumber());
+    // summed over MPI ranks with the other diags
+    m_batch_offset = batch.AddSum(local_sums);
+}
+// end void ParticleNumber::AddToBatch
 
-        // Save sum of particles weight for this species
-        m_data[idx_first_species_sum_weight + i_s] = Wtot;
+// function that reads the number of particles summed over all MPI ranks
+void ParticleNumber::ReadFromBatch (int step, const ReductionBatch& batch)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    // get number of species (int)
+    const auto nSpecies = WarpX::GetInstance().GetPartContainer().nSpecies();
+
+    // Index of total number of macroparticles (all species) in m_data
+    constexpr int idx_total_macroparticles = 0;
+    // Index of first species macroparticle number in m_data
+    constexpr int idx_first_species_macroparticles = 1;
+    // Index of total weight (all species) in m_data
+    const int idx_total_sum_weight = idx_first_species_macroparticles + nSpecies;
+    // Index of first species weight in m_data
+    const int idx_first_species_sum_weight = idx_total_sum_weight + 1;
+
+    // Initialize total number of macroparticles and total weight (all species) to 0
+    m_data[idx_total_macroparticles] = 0.0_rt;
+    m_data[idx_total_sum_weight] = 0.0_rt;
 
+    // loop over species
+    for (int i_s = 0; i_s < nSpecies; ++i_s)
+    {
+        // Save total number of macroparticles and sum of particles weight for this species
+        m_data[idx_first_species_macroparticles + i_s] = batch.Sum(m_batch_offset + 2*i_s);
+        m_data[idx_first_species_sum_weight + i_s] = batch.Sum(m_batch_offset + 2*i_s+1);
 
         // Increase total number of macroparticles and total weight (all species)
         m_data[idx_total_macroparticles] += m_data[idx_first_species_macroparticles + i_s];
@@ -151,4 +178,4 @@ void ParticleNumber::ComputeDiags (int step)
      *   ...,
      *   sum of particles weight (species n)] */
 }
-// end void ParticleNumber::ComputeDiags
+// end void ParticleNumber::ReadFromBatch
@@ -0,0 +1,430 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "PoyntingFlux.H"
+
+#include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#include "Utils/CoarsenIO.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX_Array4.H>
+#include <AMReX_Box.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_GpuControl.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_IndexType.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Reduce.H>
+#include <AMReX_Tuple.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace amrex;
+using namespace amrex::literals;
+
+// constructor
+PoyntingFlux::PoyntingFlux (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+#if !defined(WARPX_DIM_3D)
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(false,
+        "PoyntingFlux reduced diagnostics only works in 3D.");
+#endif
+
+    ParmParse pp_rd_name(rd_name);
+
+    std::vector<std::string> port_names;
+    pp_rd_name.getarr("port_names", port_names);
+    for (const auto& port_name : port_names) {
+        m_ports.push_back(ReadPort(port_name));
+    }
+    const int nports = static_cast<int>(m_ports.size());
+    m_energy.resize(nports, 0._rt);
+
+    std::vector<amrex::Real> frequencies;
+    queryArrWithParser(pp_rd_name, "frequencies", frequencies);
+    m_frequencies.assign(frequencies.begin(), frequencies.end());
+    const int nfreq = static_cast<int>(m_frequencies.size());
+    m_dft.resize(4*nports*nfreq, 0._rt);
+
+    if (nfreq > 0) {
+        queryWithParser(pp_rd_name, "reference_impedance", m_reference_impedance);
+        std::string excitation_port = port_names[0];
+        pp_rd_name.query("excitation_port", excitation_port);
+        const auto it = std::find(port_names.begin(), port_names.end(), excitation_port);
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(it != port_names.end(),
+            rd_name + ".excitation_port must be one of " + rd_name + ".port_names");
+        m_excitation_port = static_cast<int>(std::distance(port_names.begin(), it));
+    }
+
+    // instantaneous and averaged power, then for each frequency V, I and S
+    m_data.resize(2*nports + 6*nports*nfreq, 0._rt);
+
+    if (ParallelDescriptor::IOProcessor() && m_IsNotRestart) WriteHeader();
+}
+// end constructor
+
+PoyntingFlux::Port
+PoyntingFlux::ReadPort (const std::string& port_name) const
+{
+    ParmParse pp_port(m_rd_name + "." + port_name);
+    Port port;
+    port.name = port_name;
+
+    std::string normal;
+    pp_port.get("normal", normal);
+    port.orientation = 1._rt;
+    if (normal[0] == '-' || normal[0] == '+') {
+        if (normal[0] == '-') port.orientation = -1._rt;
+        normal = normal.substr(1);
+    }
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(normal == "x" || normal == "y" || normal == "z",
+        m_rd_name + "." + port_name + ".normal must be x, y or z, optionally preceded by + or -");
+    port.normal = (normal == "x") ? 0 : ((normal == "y") ? 1 : 2);
+
+    // By default, the voltage is along the next axis in (x, y, z, x, ...)
+    std::string voltage_dir;
+    const std::array<std::string, 3> dir_names = {"x", "y", "z"};
+    port.vdir = (port.normal + 1) % 3;
+    if (pp_port.query("voltage_dir", voltage_dir)) {
+        const auto it = std::find(dir_names.begin(), dir_names.end(), voltage_dir);
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(it != dir_names.end() && *it != normal,
+            m_rd_name + "." + port_name + ".voltage_dir must be an axis tangential to the port");
+        port.vdir = static_cast<int>(std::distance(dir_names.begin(), it));
+    }
+    port.wdir = 3 - port.normal - port.vdir;
+    // (E x H)_n = E_v H_w - E_w H_v if (n, v, w) is a cyclic permutation of (x, y, z)
+    port.vw_sign = (port.vdir == (port.normal + 1) % 3) ? 1._rt : -1._rt;
+
+    std::vector<amrex::Real> lo, hi;
+    getArrWithParser(pp_port, "lo", lo);
+    getArrWithParser(pp_port, "hi", hi);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(lo.size() == 3 && hi.size() == 3,
+        m_rd_name + "." + port_name + ".lo and .hi must have 3 components");
+    for (int idim = 0; idim < 3; ++idim) {
+        port.lo[idim] = lo[idim];
+        port.hi[idim] = hi[idim];
+    }
+    return port;
+}
+
+void PoyntingFlux::WriteHeader () const
+{
+    std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+    int c = 0;
+    ofs << "#";
+    ofs << "[" << c++ << "]step()";
+    ofs << m_sep;
+    ofs << "[" << c++ << "]time(s)";
+    for (const auto& port : m_ports) {
+        ofs << m_sep << "[" << c++ << "]" << port.name << "_P(W)";
+        ofs << m_sep << "[" << c++ << "]" << port.name << "_P_avg(W)";
+    }
+    const int nfreq = static_cast<int>(m_frequencies.size());
+    for (const auto& port : m_ports) {
+        for (int ifreq = 0; ifreq < nfreq; ++ifreq) {
+            const std::string f = "_f" + std::to_string(ifreq);
+            ofs << m_sep << "[" << c++ << "]" << port.name << "_V" << f << "_re(Vs)";
+            ofs << m_sep << "[" << c++ << "]" << port.name << "_V" << f << "_im(Vs)";
+            ofs << m_sep << "[" << c++ << "]" << port.name << "_I" << f << "_re(As)";
+            ofs << m_sep << "[" << c++ << "]" << port.name << "_I" << f << "_im(As)";
+        }
+    }
+    const std::string& exc = m_ports[m_excitation_port].name;
+    for (const auto& port : m_ports) {
+        for (int ifreq = 0; ifreq < nfreq; ++ifreq) {
+            const std::string f = "_f" + std::to_string(ifreq);
+            ofs << m_sep << "[" << c++ << "]S_" << port.name << "_" << exc << f << "_re()";
+            ofs << m_sep << "[" << c++ << "]S_" << port.name << "_" << exc << f << "_im()";
+        }
+    }
+    ofs << std::endl;
+}
+
+// function that computes the flux through the ports
+void PoyntingFlux::ComputeDiags (int step)
+{
+    ComputeDiagsWithOwnBatch(step);
+}
+// end void PoyntingFlux::ComputeDiags
+
+// function that computes the flux through the ports on this MPI rank
+void PoyntingFlux::AddToBatch (int step, ReductionBatch& batch)
+{
+    WARPX_PROFILE("PoyntingFlux::AddToBatch()");
+
+    // The flux is accumulated at every step, once
+    if (step == m_last_accumulated_step) return;
+    m_last_accumulated_step = step;
+    m_in_batch = true;
+
+    auto & warpx = WarpX::GetInstance();
+
+    constexpr int lev = 0; // This reduced diag currently does not work with mesh refinement
+
+    const Geometry& geom = warpx.Geom(lev);
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+    const Box& domain = geom.Domain();
+
+    std::array<const MultiFab*, 3> E;
+    std::array<const MultiFab*, 3> H;
+    for (int idir = 0; idir < 3; ++idir) {
+        E[idir] = &warpx.getEfield(lev, idir);
+#ifdef WARPX_MAG_LLG
+        H[idir] = &warpx.getHfield(lev, idir);
+#else
+        H[idir] = &warpx.getBfield(lev, idir);
+#endif
+    }
+#ifdef WARPX_MAG_LLG
+    // H is stored directly
+    const bool H_from_B = false;
+#else
+    const bool H_from_B = true;
+#endif
+    // With a macroscopic medium, H = B/mu with the local permeability
+    const bool use_macroscopic_mu = H_from_B &&
+        (WarpX::em_solver_medium == MediumForEM::Macroscopic);
+    const MultiFab* mu_mf = use_macroscopic_mu ?
+        &warpx.GetMacroscopicProperties().getmu_mf() : nullptr;
+    const amrex::Real inv_mu0 = H_from_B ? 1._rt/PhysConst::mu0 : 1._rt;
+
+    const int nports = static_cast<int>(m_ports.size());
+
+    using ReduceDataType = ReduceData<Real, Real, Real>;
+    using ReduceTuple = typename ReduceDataType::Type;
+    std::vector<Real> sums(3*nports);
+    m_Lv.resize(nports);
+    m_Lw.resize(nports);
+
+    for (int iport = 0; iport < nports; ++iport) {
+        const Port& port = m_ports[iport];
+        const int n = port.normal;
+        const int v = port.vdir;
+        const int w = port.wdir;
+
+        // Faces normal to n that are on the port, and whose center is within the port
+        // in the tangential directions. The faces on the upper domain boundary are included.
+        IntVect face_iv(0);
+        face_iv[n] = 1;
+        IntVect port_lo, port_hi;
+        for (int idim = 0; idim < 3; ++idim) {
+            if (idim == n) {
+                port_lo[idim] = static_cast<int>(
+                    std::floor((port.lo[idim] - problo[idim])/dx[idim] + 0.5_rt));
+                port_hi[idim] = port_lo[idim];
+            } else {
+                port_lo[idim] = static_cast<int>(
+                    std::ceil((port.lo[idim] - problo[idim])/dx[idim] - 0.5_rt));
+                port_hi[idim] = static_cast<int>(
+                    std::floor((port.hi[idim] - problo[idim])/dx[idim] - 0.5_rt));
+            }
+        }
+        const Box port_box = Box(port_lo, port_hi, IndexType(face_iv)) & amrex::convert(domain, face_iv);
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(port_box.ok(),
+            "The port " + port.name + " of " + m_rd_name + " is outside of the domain");
+        const Real dA = dx[v]*dx[w];
+        m_Lv[iport] = port_box.length(v)*dx[v];
+        m_Lw[iport] = port_box.length(w)*dx[w];
+
+        // Fields are interpolated to the centers of the faces normal to n
+        GpuArray<int,3> face_type{0,0,0};
+        face_type[n] = 1;
+        const GpuArray<int,3> cell_type{0,0,0};
+        const GpuArray<int,3> ratio{1,1,1};
+        GpuArray<int,3> Ev_type{0,0,0}, Ew_type{0,0,0}, Hv_type{0,0,0}, Hw_type{0,0,0};
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            Ev_type[idim] = E[v]->ixType()[idim];
+            Ew_type[idim] = E[w]->ixType()[idim];
+            Hv_type[idim] = H[v]->ixType()[idim];
+            Hw_type[idim] = H[w]->ixType()[idim];
+        }
+        const Real sign = port.vw_sign*port.orientation;
+
+        // One ReduceOps per port: its result can only be read once
+        ReduceOps<ReduceOpSum, ReduceOpSum, ReduceOpSum> reduce_op;
+        ReduceDataType rd(reduce_op);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(*E[v], TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            // Each tile counts the faces on its low side, and the tiles at the top of the
+            // domain also count the faces on the upper domain boundary
+            const Box cbx = mfi.tilebox(IntVect::TheCellVector());
+            Box fbx = amrex::surroundingNodes(cbx, n);
+            if (cbx.bigEnd(n) < domain.bigEnd(n)) fbx.growHi(n, -1);
+            const Box bx = fbx & port_box;
+            if (!bx.ok()) continue;
+            Array4<Real const> const& Ev = E[v]->const_array(mfi);
+            Array4<Real const> const& Ew = E[w]->const_array(mfi);
+            Array4<Real const> const& Hv = H[v]->const_array(mfi);
+            Array4<Real const> const& Hw = H[w]->const_array(mfi);
+            Array4<Real const> const mu_arr = use_macroscopic_mu ?
+                mu_mf->const_array(mfi) : Array4<Real const>();
+
+            reduce_op.eval(bx, rd,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                const Real ev = CoarsenIO::Interp(Ev, Ev_type, face_type, ratio, i, j, k, 0);
+                const Real ew = CoarsenIO::Interp(Ew, Ew_type, face_type, ratio, i, j, k, 0);
+                Real inv_mu = inv_mu0;
+                if (use_macroscopic_mu) {
+                    inv_mu = 1._rt/CoarsenIO::Interp(mu_arr, cell_type, face_type, ratio, i, j, k, 0);
+                }
+                const Real hv = inv_mu*CoarsenIO::Interp(Hv, Hv_type, face_type, ratio, i, j, k, 0);
+                const Real hw = inv_mu*CoarsenIO::Interp(Hw, Hw_type, face_type, ratio, i, j, k, 0);
+                return {sign*(ev*hw - ew*hv)*dA, ev*dA, sign*hw*dA};
+            });
+        }
+
+        const auto r = rd.value(reduce_op);
+        sums[3*iport] = amrex::get<0>(r);
+        sums[3*iport+1] = amrex::get<1>(r);
+        sums[3*iport+2] = amrex::get<2>(r);
+    }
+
+    // Summed over the MPI ranks for all ports at once, with the other diags
+    m_batch_offset = batch.AddSum(sums);
+}
+// end void PoyntingFlux::AddToBatch
+
+// function that accumulates the flux summed over all MPI ranks
+void PoyntingFlux::ReadFromBatch (int step, const ReductionBatch& batch)
+{
+    if (!m_in_batch) return;
+    m_in_batch = false;
+
+    auto & warpx = WarpX::GetInstance();
+
+    constexpr int lev = 0;
+
+    const int nports = static_cast<int>(m_ports.size());
+
+    // Accumulate the energy and the Fourier transforms of V = Lv <E_v> and I = Lw <H_w>
+    const Real t = warpx.gett_new(lev);
+    const Real dt = warpx.getdt(lev);
+    m_accumulated_time += dt;
+    const int nfreq = static_cast<int>(m_frequencies.size());
+    for (int iport = 0; iport < nports; ++iport) {
+        const Real power = batch.Sum(m_batch_offset + 3*iport);
+        m_energy[iport] += power*dt;
+        m_data[2*iport] = power;
+        m_data[2*iport+1] = m_energy[iport]/m_accumulated_time;
+
+        const Real voltage = batch.Sum(m_batch_offset + 3*iport+1)/m_Lw[iport];
+        const Real current = batch.Sum(m_batch_offset + 3*iport+2)/m_Lv[iport];
+        for (int ifreq = 0; ifreq < nfreq; ++ifreq) {
+            const Real phase = 2._rt*MathConst::pi*m_frequencies[ifreq]*t;
+            const Real c = std::cos(phase)*dt;
+            const Real s = std::sin(phase)*dt;
+            Real* dft = &m_dft[4*(iport*nfreq + ifreq)];
+            dft[0] += voltage*c;
+            dft[1] -= voltage*s;
+            dft[2] += current*c;
+            dft[3] -= current*s;
+        }
+    }
+    if (!m_intervals.contains(step+1)) return;
+
+    // Transformed V and I, and scattering parameters S_{port, excitation} = b_port / a_excitation,
+    // with a = (V + Z0 I) / (2 sqrt(Z0)) and b = (V - Z0 I) / (2 sqrt(Z0))
+    const Real Z0 = m_reference_impedance;
+    int idata = 2*nports;
+    for (int iport = 0; iport < nports; ++iport) {
+        for (int ifreq = 0; ifreq < nfreq; ++ifreq) {
+            for (int icomp = 0; icomp < 4; ++icomp) {
+                m_data[idata++] = m_dft[4*(iport*nfreq + ifreq) + icomp];
+            }
+        }
+    }
+    for (int iport = 0; iport < nports; ++iport) {
+        for (int ifreq = 0; ifreq < nfreq; ++ifreq) {
+            const Real* dft_exc = &m_dft[4*(m_excitation_port*nfreq + ifreq)];
+            const Real* dft = &m_dft[4*(iport*nfreq + ifreq)];
+            const std::complex<Real> a_exc = std::complex<Real>(dft_exc[0], dft_exc[1])
+                                           + Z0*std::complex<Real>(dft_exc[2], dft_exc[3]);
+            const std::complex<Real> b = std::complex<Real>(dft[0], dft[1])
+                                       - Z0*std::complex<Real>(dft[2], dft[3]);
+            const std::complex<Real> S = (std::abs(a_exc) > 0._rt) ?
+                b/a_exc : std::complex<Real>(0._rt, 0._rt);
+            m_data[idata++] = S.real();
+            m_data[idata++] = S.imag();
+        }
+    }
+}
+// end void PoyntingFlux::ReadFromBatch
+
+std::string
+PoyntingFlux::CheckpointFileName (const std::string& dir) const
+{
+    return dir + "/ReducedDiags_" + m_rd_name;
+}
+
+// function that writes the accumulated data to a checkpoint
+void PoyntingFlux::WriteCheckpointData (const std::string& dir)
+{
+    if (!ParallelDescriptor::IOProcessor()) return;
+
+    const std::string file_name = CheckpointFileName(dir);
+    std::ofstream ofs{file_name, std::ofstream::out | std::ofstream::trunc};
+    if (!ofs.good()) { amrex::FileOpenFailed(file_name); }
+    ofs << std::setprecision(17);
+    ofs << m_energy.size() << " " << m_dft.size() << "\n";
+    ofs << m_accumulated_time << " " << m_last_accumulated_step << "\n";
+    for (const auto energy : m_energy) ofs << energy << "\n";
+    for (const auto dft : m_dft) ofs << dft << "\n";
+    if (!ofs.good()) { amrex::Abort("PoyntingFlux: problem writing " + file_name); }
+}
+// end void PoyntingFlux::WriteCheckpointData
+
+// function that reads the accumulated data from a checkpoint
+void PoyntingFlux::ReadCheckpointData (const std::string& dir)
+{
+    const std::string file_name = CheckpointFileName(dir);
+    // checkpoints written before the data was saved restart with zero accumulated data
+    if (!amrex::FileExists(file_name)) {
+        WarpX::GetInstance().RecordWarning("Diagnostics",
+            m_rd_name + ": no accumulated data in " + dir + ", the averages and Fourier "
+            "transforms restart from zero");
+        return;
+    }
+
+    Vector<char> file_char;
+    ParallelDescriptor::ReadAndBcastFile(file_name, file_char);
+    std::istringstream is(file_char.dataPtr());
+    std::size_t nenergy = 0, ndft = 0;
+    is >> nenergy >> ndft;
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(nenergy == m_energy.size() && ndft == m_dft.size(),
+        m_rd_name + ": the ports and frequencies must be the same as in the checkpoint " + dir);
+    is >> m_accumulated_time >> m_last_accumulated_step;
+    for (auto& energy : m_energy) is >> energy;
+    for (auto& dft : m_dft) is >> dft;
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!is.fail(), "PoyntingFlux: problem reading " + file_name);
+}
+// end void PoyntingFlux::ReadCheckpointData
@@ -62,6 +62,11 @@ ReducedDiags::ReducedDiags (std::string rd_name)
 
     // read separator
     pp_rd_name.query("separator", m_sep);
+
+    // read number of output lines buffered in memory
+    pp_rd_name.query("flush_interval", m_flush_interval);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_flush_interval >= 1,
+        m_rd_name + ".flush_interval must be at least 1");
 }
 // end constructor
 
@@ -79,6 +84,55 @@ void ReducedDiags::LoadBalance ()
     // load balancing operations
 }
 
+void ReducedDiags::AddToBatch (int step, ReductionBatch& /*batch*/)
+{
+    // Diags that do not use the batch are computed here, with their own reductions
+    ComputeDiags(step);
+}
+
+void ReducedDiags::ReadFromBatch (int /*step*/, const ReductionBatch& /*batch*/)
+{
+    // Defines an empty function ReadFromBatch() to be overwritten by the
+    // diags that add their partial results in AddToBatch
+}
+
+void ReducedDiags::ComputeDiagsWithOwnBatch (int step)
+{
+    ReductionBatch batch;
+    AddToBatch(step, batch);
+    batch.Reduce();
+    ReadFromBatch(step, batch);
+}
+
+void ReducedDiags::Finalize ()
+{
+    // Function used to write data buffered in memory at the end of the
+    // simulation, can be overwritten if needed
+    Flush();
+}
+
+void ReducedDiags::Flush ()
+{
+    // Function used to write data buffered in memory during the simulation,
+    // can be overwritten by diags that buffer data on all MPI ranks
+    if (ParallelDescriptor::IOProcessor()) { FlushWriteBuffer(); }
+}
+
+void ReducedDiags::FlushOnAbort ()
+{
+    if (ParallelDescriptor::IOProcessor()) { FlushWriteBuffer(); }
+}
+
+void ReducedDiags::WriteCheckpointData (const std::string& /*dir*/)
+{
+    // Function used to save the state of diags that accumulate data over time,
+    // can be overwritten if needed
+}
+
+void ReducedDiags::ReadCheckpointData (const std::string& /*dir*/)
+{
+}
+
 void ReducedDiags::BackwardCompatibility ()
 {
     amrex::ParmParse pp_rd_name(m_rd_name);
@@ -91,32 +145,46 @@ void ReducedDiags::BackwardCompatibility ()
 }
 
 // write to file function
-void ReducedDiags::WriteToFile (int step) const
+void ReducedDiags::WriteToFile (int step)
 {
-    // open file
-    std::ofstream ofs{m_path + m_rd_name + "." + m_extension,
-        std::ofstream::out | std::ofstream::app};
-
     // write step
-    ofs << step+1;
+    m_write_buffer << step+1;
 
-    ofs << m_sep;
+    m_write_buffer << m_sep;
 
     // set precision
-    ofs << std::fixed << std::setprecision(14) << std::scientific;
+    m_write_buffer << std::fixed << std::setprecision(14) << std::scientific;
 
     // write time
-    ofs << WarpX::GetInstance().gett_new(0);
+    m_write_buffer << WarpX::GetInstance().gett_new(0);
 
     // loop over data size and write
-    for (const auto& item : m_data) ofs << m_sep << item;
+    for (const auto& item : m_data) m_write_buffer << m_sep << item;
 
     // end loop over data size
 
     // end line
-    ofs << std::endl;
+    m_write_buffer << "\n";
+
+    // append the buffered lines to the file
+    ++m_buffered_lines;
+    if (m_buffered_lines >= m_flush_interval) { FlushWriteBuffer(); }
+}
+// end ReducedDiags::WriteToFile
+
+void ReducedDiags::FlushWriteBuffer ()
+{
+    if (m_buffered_lines == 0) { return; }
+
+    // open file
+    std::ofstream ofs{m_path + m_rd_name + "." + m_extension,
+        std::ofstream::out | std::ofstream::app};
+
+    ofs << m_write_buffer.str();
 
     // close file
     ofs.close();
+
+    m_write_buffer.str("");
+    m_buffered_lines = 0;
 }
-// end ReducedDiags::WriteToFile
@@ -0,0 +1,48 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "ReductionBatch.H"
+
+#include "Utils/WarpXProfilerWrapper.H"
+
+#include <AMReX_ParallelDescriptor.H>
+
+using namespace amrex;
+
+int ReductionBatch::AddSum (const std::vector<Real>& values)
+{
+    const int offset = static_cast<int>(m_sum.size());
+    m_sum.insert(m_sum.end(), values.begin(), values.end());
+    return offset;
+}
+
+int ReductionBatch::AddMax (const std::vector<Real>& values)
+{
+    const int offset = static_cast<int>(m_max.size());
+    m_max.insert(m_max.end(), values.begin(), values.end());
+    return offset;
+}
+
+void ReductionBatch::Reduce ()
+{
+    WARPX_PROFILE("ReductionBatch::Reduce()");
+
+    // All the ranks compute the same diagnostics at the same steps,
+    // hence the sizes of the buffers are the same on all the ranks
+    if (!m_sum.empty()) {
+        ParallelDescriptor::ReduceRealSum(m_sum.data(), static_cast<int>(m_sum.size()));
+    }
+    if (!m_max.empty()) {
+        ParallelDescriptor::ReduceRealMax(m_max.data(), static_cast<int>(m_max.size()));
+    }
+}
+
+void ReductionBatch::Clear ()
+{
+    m_sum.clear();
+    m_max.clear();
+}
@@ -0,0 +1,196 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "TimingBreakdown.H"
+
+#include "Diagnostics/ReducedDiags/ReducedDiags.H"
+#include "Utils/TextMsg.H"
+#include "WarpX.H"
+
+#include <ablastr/profiler/RegionTimers.H>
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_REAL.H>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace amrex;
+
+namespace
+{
+    /** name as a JSON string, with its quotes and backslashes escaped */
+    std::string JSONString (const std::string& name)
+    {
+        std::string out = "\"";
+        for (const char c : name)
+        {
+            if (c == '"' || c == '\\') { out += '\\'; }
+            out += c;
+        }
+        return out + "\"";
+    }
+}
+
+// constructor
+TimingBreakdown::TimingBreakdown (std::string rd_name)
+    : ReducedDiags{rd_name}
+{
+    // read the names of the profiled regions
+    m_regions = {"WarpX::Evolve::step",
+                 "WarpX::MacroscopicEvolveHM()",
+                 "WarpX::MacroscopicEvolveHM_2nd()",
+                 "WarpXCommUtil::FillBoundary",
+                 "WarpXCommUtil::FillBoundary_finish",
+                 "Diagnostics::FilterComputePackFlush()"};
+    ParmParse pp_rd_name(rd_name);
+    pp_rd_name.queryarr("regions", m_regions);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!m_regions.empty(),
+        rd_name + ".regions must contain at least one region");
+
+    // read the output format
+    std::string format = "text";
+    pp_rd_name.query("format", format);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(format == "text" || format == "json",
+        rd_name + ".format must be text or json");
+    m_json = (format == "json");
+
+    // start measuring the time of the regions
+    ablastr::profiler::RegionTimers::Enable();
+
+    m_previous_total.resize(m_regions.size(), 0.);
+
+    // resize data array: min, avg and max for each region
+    m_data.resize(3*m_regions.size(), 0.0_rt);
+
+    // the JSON objects have no header
+    if (ParallelDescriptor::IOProcessor() && !m_json)
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+
+            // write header row
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << c++ << "]step()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time(s)";
+            for (const auto& region : m_regions)
+            {
+                for (const auto& stat : {"_min", "_avg", "_max"})
+                {
+                    ofs << m_sep;
+                    ofs << "[" << c++ << "]" << region << stat << "(s/step)";
+                }
+            }
+            ofs << std::endl;
+
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+void TimingBreakdown::InitData ()
+{
+    // the time is measured from the first step of this run (e.g., after a restart)
+    m_previous_step = WarpX::GetInstance().getistep(0);
+    for (int i = 0; i < static_cast<int>(m_regions.size()); ++i)
+    {
+        m_previous_total[i] = ablastr::profiler::RegionTimers::Total(m_regions[i]);
+    }
+}
+
+void TimingBreakdown::ComputeDiags (int step)
+{
+    ComputeDiagsWithOwnBatch(step);
+}
+
+// function that computes the time per step of the regions since the previous output
+void TimingBreakdown::AddToBatch (int step, ReductionBatch& batch)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    // the region of the current step is still running, and counted up to now
+    const int nsteps = std::max(step + 1 - m_previous_step, 1);
+    m_previous_step = step + 1;
+
+    const auto nregions = static_cast<int>(m_regions.size());
+    std::vector<Real> local_time(nregions), local_max(2*nregions);
+    for (int i = 0; i < nregions; ++i)
+    {
+        const double total = ablastr::profiler::RegionTimers::Total(m_regions[i]);
+        local_time[i] = static_cast<Real>((total - m_previous_total[i]) / nsteps);
+        m_previous_total[i] = total;
+
+        // the minimum is the opposite of the maximum of the opposite
+        local_max[2*i] = -local_time[i];
+        local_max[2*i+1] = local_time[i];
+    }
+
+    m_batch_sum_offset = batch.AddSum(local_time);
+    m_batch_max_offset = batch.AddMax(local_max);
+}
+// end void TimingBreakdown::AddToBatch
+
+// function that reads the minimum, average and maximum over all MPI ranks
+void TimingBreakdown::ReadFromBatch (int step, const ReductionBatch& batch)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    const auto nprocs = static_cast<Real>(ParallelDescriptor::NProcs());
+    for (int i = 0; i < static_cast<int>(m_regions.size()); ++i)
+    {
+        m_data[3*i] = -batch.Max(m_batch_max_offset + 2*i);
+        m_data[3*i+1] = batch.Sum(m_batch_sum_offset + i) / nprocs;
+        m_data[3*i+2] = batch.Max(m_batch_max_offset + 2*i+1);
+    }
+
+    /* m_data now contains up-to-date values for:
+     *  [min, avg and max of the time per step of region 0,
+     *   min, avg and max of the time per step of region 1,
+     *   ......] */
+}
+// end void TimingBreakdown::ReadFromBatch
+
+// function that writes the output line, as columns or as a JSON object
+void TimingBreakdown::WriteToFile (int step)
+{
+    if (!m_json)
+    {
+        ReducedDiags::WriteToFile(step);
+        return;
+    }
+
+    // one JSON object per line (JSON Lines), which can be appended after a restart
+    m_write_buffer << "{\"step\": " << step+1;
+    m_write_buffer << std::setprecision(14) << std::scientific;
+    m_write_buffer << ", \"time\": " << WarpX::GetInstance().gett_new(0);
+    m_write_buffer << ", \"regions\": {";
+    for (int i = 0; i < static_cast<int>(m_regions.size()); ++i)
+    {
+        if (i > 0) { m_write_buffer << ", "; }
+        m_write_buffer << JSONString(m_regions[i])
+                       << ": {\"min\": " << m_data[3*i]
+                       << ", \"avg\": " << m_data[3*i+1]
+                       << ", \"max\": " << m_data[3*i+2] << "}";
+    }
+    m_write_buffer << "}}\n";
+
+    // append the buffered lines to the file
+    ++m_buffered_lines;
+    if (m_buffered_lines >= m_flush_interval) { FlushWriteBuffer(); }
+}
+// end void TimingBreakdown::WriteToFile
@@ -0,0 +1,254 @@
+#include "TimeAveragedDiagnostics.H"
+
+#include "Diagnostics/ParticleDiag/ParticleDiag.H"
+#include "FlushFormats/FlushFormat.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX.H>
+#include <AMReX_Array4.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_Box.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+#include <AMReX_VisMF.H>
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace amrex::literals;
+
+TimeAveragedDiagnostics::TimeAveragedDiagnostics (int i, std::string name)
+    : FullDiagnostics(i, name)
+{
+    ReadAveragingParameters();
+}
+
+void
+TimeAveragedDiagnostics::ReadAveragingParameters ()
+{
+    amrex::ParmParse pp_diag_name(m_diag_name);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_format == "plotfile" || m_format == "openpmd",
+        "<diag>.format must be plotfile or openpmd for TimeAveraged diagnostics");
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        !m_plot_raw_fields, "<diag>.plot_raw_fields is not supported for TimeAveraged diagnostics");
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_pfield_varnames.empty(),
+        "<diag>.particle_fields_to_plot is not supported for TimeAveraged diagnostics");
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        !WarpX::GetInstance().do_moving_window,
+        "TimeAveraged diagnostics are not supported with a moving window");
+
+    std::vector<std::string> averages = {"mean"};
+    pp_diag_name.queryarr("averages", averages);
+    for (const auto& average : averages) {
+        if (average == "mean") {
+            m_do_mean = true;
+        } else if (average == "rms") {
+            m_do_rms = true;
+        } else {
+            amrex::Abort(Utils::TextMsg::Err(
+                "<diag>.averages must contain mean and/or rms, not " + average));
+        }
+    }
+
+    queryWithParser(pp_diag_name, "averaging_steps", m_averaging_steps);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_averaging_steps >= 0, "<diag>.averaging_steps must be non-negative");
+
+    if (m_do_mean) {
+        for (const auto& var : m_varnames) m_avg_varnames.push_back(var + "_mean");
+    }
+    if (m_do_rms) {
+        for (const auto& var : m_varnames) m_avg_varnames.push_back(var + "_rms");
+    }
+}
+
+void
+TimeAveragedDiagnostics::InitializeBufferData (int i_buffer, int lev)
+{
+    FullDiagnostics::InitializeBufferData(i_buffer, lev);
+
+    if (static_cast<int>(m_mf_sum.size()) < nmax_lev) m_mf_sum.resize(nmax_lev);
+    if (static_cast<int>(m_mf_avg.size()) < nmax_lev) m_mf_avg.resize(nmax_lev);
+    // Keep the accumulated fields if the output buffer is re-initialized
+    if (m_mf_sum[lev].ok()) return;
+    const amrex::MultiFab& mf = m_mf_output[i_buffer][lev];
+    const int ncomp = static_cast<int>(m_avg_varnames.size());
+    m_mf_sum[lev] = amrex::MultiFab(mf.boxArray(), mf.DistributionMap(), ncomp, 0);
+    m_mf_sum[lev].setVal(0._rt);
+    m_mf_avg[lev] = amrex::MultiFab(mf.boxArray(), mf.DistributionMap(), ncomp, 0);
+}
+
+bool
+TimeAveragedDiagnostics::DoComputeAndPack (int step, bool force_flush)
+{
+    // The fields are accumulated only once per step, including when the last
+    // step is flushed again at the end of the simulation (where step is the number
+    // of completed steps, instead of this number minus one in the time loop).
+    const int istep = WarpX::GetInstance().getistep(0);
+    if (istep == m_last_accumulated_step) return false;
+
+    if (m_averaging_steps > 0 && !force_flush) {
+        // Only the last averaging_steps steps before the next output are accumulated
+        const int next_output = m_intervals.contains(step+1) ?
+            step+1 : m_intervals.nextContains(step+1);
+        if (next_output - (step+1) >= m_averaging_steps) return false;
+    }
+    m_last_accumulated_step = istep;
+    return true;
+}
+
+void
+TimeAveragedDiagnostics::UpdateBufferData ()
+{
+    WARPX_PROFILE("TimeAveragedDiagnostics::UpdateBufferData()");
+
+    auto & warpx = WarpX::GetInstance();
+    const amrex::Real dt = warpx.getdt(0);
+    m_accumulated_time += dt;
+
+    const int nvar = static_cast<int>(m_varnames.size());
+    const bool do_mean = m_do_mean;
+    const bool do_rms = m_do_rms;
+    // Index of the first F^2 dt component
+    const int irms = do_mean ? nvar : 0;
+    for (int lev = 0; lev < nlev_output; ++lev) {
+        const amrex::MultiFab& mf_field = m_mf_output[0][lev];
+        amrex::MultiFab& mf_sum = m_mf_sum[lev];
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (amrex::MFIter mfi(mf_sum, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const amrex::Box& bx = mfi.tilebox();
+            amrex::Array4<amrex::Real const> const& F = mf_field.const_array(mfi);
+            amrex::Array4<amrex::Real> const& sum = mf_sum.array(mfi);
+            amrex::ParallelFor(bx, nvar,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                    const amrex::Real f = F(i,j,k,n);
+                    if (do_mean) sum(i,j,k,n) += f*dt;
+                    if (do_rms) sum(i,j,k,irms+n) += f*f*dt;
+                });
+        }
+    }
+}
+
+void
+TimeAveragedDiagnostics::Flush (int i_buffer)
+{
+    WARPX_PROFILE("TimeAveragedDiagnostics::Flush()");
+
+    auto & warpx = WarpX::GetInstance();
+
+    const int nvar = static_cast<int>(m_varnames.size());
+    const bool do_mean = m_do_mean;
+    const int irms = do_mean ? nvar : 0;
+    const int ncomp = static_cast<int>(m_avg_varnames.size());
+    const amrex::Real inv_time = (m_accumulated_time > 0._rt) ? 1._rt/m_accumulated_time : 0._rt;
+    for (int lev = 0; lev < nlev_output; ++lev) {
+        const amrex::MultiFab& mf_sum = m_mf_sum[lev];
+        amrex::MultiFab& mf_avg = m_mf_avg[lev];
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (amrex::MFIter mfi(mf_avg, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const amrex::Box& bx = mfi.tilebox();
+            amrex::Array4<amrex::Real const> const& sum = mf_sum.const_array(mfi);
+            amrex::Array4<amrex::Real> const& avg = mf_avg.array(mfi);
+            amrex::ParallelFor(bx, ncomp,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                    const amrex::Real a = sum(i,j,k,n)*inv_time;
+                    avg(i,j,k,n) = (n >= irms) ? std::sqrt(a) : a;
+                });
+        }
+    }
+
+    // No particles are written
+    const amrex::Vector<ParticleDiag> no_particles;
+    m_flush_format->WriteToFile(
+        m_avg_varnames, m_mf_avg, m_geom_output[i_buffer], warpx.getistep(),
+        warpx.gett_new(0), no_particles, nlev_output, m_file_prefix,
+        m_file_min_digits, false, false);
+
+    // The next window starts after this output
+    for (int lev = 0; lev < nlev_output; ++lev) {
+        m_mf_sum[lev].setVal(0._rt);
+    }
+    m_accumulated_time = 0._rt;
+}
+
+std::string
+TimeAveragedDiagnostics::CheckpointPrefix (const std::string& dir, int lev) const
+{
+    return amrex::MultiFabFileFullPrefix(lev, dir, "Level_", m_diag_name + "_sum");
+}
+
+void
+TimeAveragedDiagnostics::WriteCheckpointData (const std::string& dir)
+{
+    WARPX_PROFILE("TimeAveragedDiagnostics::WriteCheckpointData()");
+
+    if (amrex::ParallelDescriptor::IOProcessor()) {
+        const std::string file_name = dir + "/TimeAveraged_" + m_diag_name;
+        std::ofstream ofs(file_name, std::ios::out|std::ios::trunc);
+        if (!ofs.good()) { amrex::FileOpenFailed(file_name); }
+        ofs << std::setprecision(17);
+        ofs << nlev_output << " " << m_accumulated_time << " " << m_last_accumulated_step << "\n";
+        if (!ofs.good()) { amrex::Abort("TimeAveragedDiagnostics: problem writing " + file_name); }
+    }
+    for (int lev = 0; lev < nlev_output; ++lev) {
+        if (amrex::AsyncOut::UseAsyncOut()) {
+            amrex::VisMF::AsyncWrite(m_mf_sum[lev], CheckpointPrefix(dir, lev));
+        } else {
+            amrex::VisMF::Write(m_mf_sum[lev], CheckpointPrefix(dir, lev));
+        }
+    }
+}
+
+void
+TimeAveragedDiagnostics::ReadCheckpointData (const std::string& dir)
+{
+    WARPX_PROFILE("TimeAveragedDiagnostics::ReadCheckpointData()");
+
+    const std::string file_name = dir + "/TimeAveraged_" + m_diag_name;
+    // checkpoints written before the accumulators were saved restart with a new window
+    if (!amrex::FileExists(file_name)) {
+        WarpX::GetInstance().RecordWarning("Diagnostics",
+            m_diag_name + ": no accumulated fields in " + dir + ", the averaging window "
+            "restarts at the restart step");
+        return;
+    }
+
+    amrex::Vector<char> file_char;
+    amrex::ParallelDescriptor::ReadAndBcastFile(file_name, file_char);
+    std::istringstream is(file_char.dataPtr());
+    int nlev = 0;
+    is >> nlev >> m_accumulated_time >> m_last_accumulated_step;
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!is.fail() && nlev == nlev_output,
+        m_diag_name + ": the accumulated fields in " + dir + " do not match the diagnostic");
+
+    // The accumulators are read with the BoxArray they were written with,
+    // then copied to the output layout, which may be distributed differently
+    for (int lev = 0; lev < nlev_output; ++lev) {
+        amrex::MultiFab tmp;
+        amrex::VisMF::Read(tmp, CheckpointPrefix(dir, lev));
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(tmp.nComp() == m_mf_sum[lev].nComp(),
+            m_diag_name + ": the accumulated fields in " + dir + " do not match the diagnostic");
+        m_mf_sum[lev].ParallelCopy(tmp, 0, 0, tmp.nComp());
+    }
+}
@@ -0,0 +1,253 @@
+#include "TimeSeriesDiagnostics.H"
+
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_DistributionMapping.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+TimeSeriesDiagnostics::TimeSeriesDiagnostics (int i, std::string name)
+    : FullDiagnostics(i, name)
+{
+    ReadTimeSeriesParameters();
+}
+
+TimeSeriesDiagnostics::~TimeSeriesDiagnostics ()
+{
+    // Samples taken after the last flush, e.g. if dump_last_timestep = 0
+    WriteBuffer();
+}
+
+void
+TimeSeriesDiagnostics::ReadTimeSeriesParameters ()
+{
+    amrex::ParmParse pp_diag_name(m_diag_name);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        !m_plot_raw_fields, "<diag>.plot_raw_fields is not supported for TimeSeries diagnostics");
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_pfield_varnames.empty(),
+        "<diag>.particle_fields_to_plot is not supported for TimeSeries diagnostics");
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        !WarpX::GetInstance().do_moving_window,
+        "TimeSeries diagnostics are not supported with a moving window");
+
+    queryWithParser(pp_diag_name, "buffer_size", m_buffer_size);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_buffer_size > 0, "<diag>.buffer_size must be positive");
+
+    // check if it is a restart run, in which case the samples are appended to the files
+    std::string restart_chkfile = "";
+    amrex::ParmParse pp_amr("amr");
+    pp_amr.query("restart", restart_chkfile);
+    m_is_restart = !restart_chkfile.empty();
+}
+
+void
+TimeSeriesDiagnostics::DerivedInitData ()
+{
+    // The checkpoint has been read: the current step is the step of the checkpoint
+    if (m_is_restart) TruncateFiles(WarpX::GetInstance().getistep(0));
+}
+
+void
+TimeSeriesDiagnostics::TruncateFiles (int restart_step)
+{
+    if (!amrex::ParallelDescriptor::IOProcessor()) return;
+
+    const std::string data_file = m_file_prefix + ".bin";
+    const std::string index_file = m_file_prefix + ".idx";
+    if (!amrex::FileExists(index_file)) return;
+
+    // Keep the header and the records up to the restart step. The data file is cut at the
+    // offset of the first removed record.
+    std::ifstream ifs{index_file};
+    std::ostringstream kept;
+    std::string line;
+    std::streamoff data_end = -1;
+    while (std::getline(ifs, line)) {
+        if (!line.empty() && line[0] != '#') {
+            std::istringstream is(line);
+            int step;
+            amrex::Real time;
+            std::streamoff offset;
+            is >> step >> time >> offset;
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!is.fail(), "Invalid record in " + index_file);
+            if (step > restart_step) {
+                data_end = offset;
+                break;
+            }
+        }
+        kept << line << "\n";
+    }
+    ifs.close();
+    if (data_end < 0) return;
+
+    std::error_code ec;
+    std::filesystem::resize_file(data_file, static_cast<std::uintmax_t>(data_end), ec);
+    if (ec) amrex::Abort("Failed to truncate " + data_file + ": " + ec.message());
+    std::ofstream ofs_index{index_file, std::ios::trunc};
+    ofs_index << kept.str();
+    if (!ofs_index) amrex::Abort("Failed to write " + index_file);
+}
+
+void
+TimeSeriesDiagnostics::InitializeBufferData (int i_buffer, int lev)
+{
+    FullDiagnostics::InitializeBufferData(i_buffer, lev);
+
+    // Only level 0 is sampled
+    if (lev != 0) return;
+    const amrex::Box box = m_mf_output[i_buffer][lev].boxArray().minimalBox();
+    if (m_mf_gather.ok() && box == m_box) return;
+    m_box = box;
+
+    // The whole sample is owned by the IO processor. Pinned memory can be read
+    // directly on the host.
+    const int io_proc = amrex::ParallelDescriptor::IOProcessorNumber();
+    const amrex::BoxArray ba(m_box);
+    const amrex::DistributionMapping dm(amrex::Vector<int>{io_proc});
+    m_mf_gather.define(ba, dm, m_mf_output[i_buffer][lev].nComp(), 0,
+                       amrex::MFInfo().SetArena(amrex::The_Pinned_Arena()));
+}
+
+bool
+TimeSeriesDiagnostics::DoComputeAndPack (int step, bool force_flush)
+{
+    // The last step is flushed again at the end of the simulation, where step is the
+    // number of completed steps instead of this number minus one, so the completed
+    // steps identify the sampled fields
+    const int istep = WarpX::GetInstance().getistep(0);
+    if (istep == m_last_sampled_step) return false;
+    if (force_flush || m_intervals.contains(step+1)) {
+        m_last_sampled_step = istep;
+        return true;
+    }
+    return false;
+}
+
+bool
+TimeSeriesDiagnostics::DoDump (int /*step*/, int /*i_buffer*/, bool force_flush)
+{
+    if (m_n_buffered == 0) return false;
+    return force_flush || m_n_buffered >= m_buffer_size;
+}
+
+void
+TimeSeriesDiagnostics::UpdateBufferData ()
+{
+    WARPX_PROFILE("TimeSeriesDiagnostics::UpdateBufferData()");
+
+    auto & warpx = WarpX::GetInstance();
+
+    // Gather the sample to the IO processor
+    m_mf_gather.ParallelCopy(m_mf_output[0][0]);
+    amrex::Gpu::streamSynchronize();
+
+    if (amrex::ParallelDescriptor::IOProcessor()) {
+        for (amrex::MFIter mfi(m_mf_gather); mfi.isValid(); ++mfi) {
+            const amrex::FArrayBox& fab = m_mf_gather[mfi];
+            const amrex::Real* p = fab.dataPtr();
+            m_buffer.insert(m_buffer.end(), p, p + fab.box().numPts()*fab.nComp());
+        }
+        m_buffer_steps.push_back(warpx.getistep(0));
+        m_buffer_times.push_back(warpx.gett_new(0));
+    }
+    ++m_n_buffered;
+}
+
+void
+TimeSeriesDiagnostics::Flush (int /*i_buffer*/)
+{
+    WARPX_PROFILE("TimeSeriesDiagnostics::Flush()");
+    WriteBuffer();
+}
+
+void
+TimeSeriesDiagnostics::WriteBuffer ()
+{
+    m_n_buffered = 0;
+    if (!amrex::ParallelDescriptor::IOProcessor()) return;
+    if (m_buffer_steps.empty()) return;
+
+    const std::string data_file = m_file_prefix + ".bin";
+    const std::string index_file = m_file_prefix + ".idx";
+
+    if (!m_files_created) {
+        // create folder
+        const auto pos = m_file_prefix.rfind('/');
+        if (pos != std::string::npos) {
+            const std::string path = m_file_prefix.substr(0, pos);
+            if (!amrex::UtilCreateDirectory(path, 0755)) amrex::CreateDirectoryFailed(path);
+        }
+        // replace / create output files
+        if (!m_is_restart) {
+            std::ofstream ofs_data{data_file, std::ios::trunc | std::ios::binary};
+            std::ofstream ofs_index{index_file, std::ios::trunc};
+            WriteIndexHeader(ofs_index);
+        }
+        m_files_created = true;
+    }
+
+    std::ofstream ofs_data{data_file, std::ios::app | std::ios::binary};
+    ofs_data.seekp(0, std::ios::end);
+    std::streamoff offset = ofs_data.tellp();
+    ofs_data.write(reinterpret_cast<const char*>(m_buffer.dataPtr()),
+                   m_buffer.size()*sizeof(amrex::Real));
+    if (!ofs_data) amrex::Abort("Failed to write " + data_file);
+
+    const auto n_samples = static_cast<int>(m_buffer_steps.size());
+    const auto record_bytes = static_cast<std::streamoff>(
+        m_buffer.size()/n_samples*sizeof(amrex::Real));
+    std::ofstream ofs_index{index_file, std::ios::app};
+    ofs_index << std::setprecision(14);
+    for (int i = 0; i < n_samples; ++i) {
+        ofs_index << m_buffer_steps[i] << " " << m_buffer_times[i] << " " << offset << "\n";
+        offset += record_bytes;
+    }
+
+    m_buffer.clear();
+    m_buffer_steps.clear();
+    m_buffer_times.clear();
+}
+
+void
+TimeSeriesDiagnostics::WriteIndexHeader (std::ofstream& ofs) const
+{
+    const amrex::Geometry& geom = m_geom_output[0][0];
+    const amrex::IntVect size = m_box.size();
+    ofs << std::setprecision(14);
+    ofs << "# data_file " << m_file_prefix << ".bin\n";
+    ofs << "# real_size " << sizeof(amrex::Real) << "\n";
+    ofs << "# ncells";
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) ofs << " " << size[idim];
+    ofs << "\n# lo";
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) ofs << " " << geom.ProbLo(idim);
+    ofs << "\n# hi";
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) ofs << " " << geom.ProbHi(idim);
+    ofs << "\n# fields";
+    for (const auto& var : m_varnames) ofs << " " << var;
+    ofs << "\n# Each record contains the fields, one after the other, with the first";
+    ofs << "\n# dimension varying fastest. One line per record:";
+    ofs << "\n# step time byte_offset\n";
+}
@@ -12,10 +12,12 @@
 #    include "BoundaryConditions/PML_RZ.H"
 #endif
 #include "FieldIO.H"
+#include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Parallelization/WarpXCommUtil.H"
 #include "Utils/CoarsenIO.H"
 #include "Utils/TextMsg.H"
+#include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXProfilerWrapper.H"
 #include "WarpX.H"
 
@@ -33,6 +35,7 @@
 #include <AMReX_Print.H>
 #include <AMReX_REAL.H>
 #include <AMReX_RealBox.H>
+#include <AMReX_Utility.H>
 #include <AMReX_Vector.H>
 #include <AMReX_VisMF.H>
 
@@ -47,6 +50,12 @@ using namespace amrex;
 namespace
 {
     const std::string level_prefix {"Level_"};
+
+    /** Read a MultiFab of the checkpoint, compressed or not */
+    void ReadMultiFab (amrex::MultiFab& mf, const std::string& name)
+    {
+        FieldCompression::Read(mf, name);
+    }
 }
 
 void
@@ -97,6 +106,25 @@ WarpX::InitFromCheckpoint ()
     amrex::Print()<< Utils::TextMsg::Info(
         "restart from checkpoint " + restart_chkfile);
 
+    // Static data written once, in a directory next to the checkpoint
+    m_restart_static_dir.clear();
+    {
+        const std::string static_file = restart_chkfile + "/StaticData";
+        if (amrex::FileExists(static_file)) {
+            Vector<char> fileCharPtr;
+            ParallelDescriptor::ReadAndBcastFile(static_file, fileCharPtr);
+            std::string static_name(fileCharPtr.dataPtr());
+            static_name.erase(static_name.find_last_not_of(" \n") + 1);
+            std::string chkdir = restart_chkfile;
+            while (chkdir.size() > 1 && chkdir.back() == '/') chkdir.pop_back();
+            const auto pos = chkdir.rfind('/');
+            m_restart_static_dir = (pos == std::string::npos) ?
+                static_name : chkdir.substr(0, pos+1) + static_name;
+            amrex::Print() << Utils::TextMsg::Info(
+                "static data read from " + m_restart_static_dir);
+        }
+    }
+
     // Header
     {
         std::string File(restart_chkfile + "/WarpXHeader");
@@ -255,128 +283,140 @@ WarpX::InitFromCheckpoint ()
             }
         }
 
-        VisMF::Read(*Efield_fp[lev][0],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_fp"));
-        VisMF::Read(*Efield_fp[lev][1],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ey_fp"));
-        VisMF::Read(*Efield_fp[lev][2],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ez_fp"));
+        ReadMultiFab(*Efield_fp[lev][0],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_fp"));
+        ReadMultiFab(*Efield_fp[lev][1],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ey_fp"));
+        ReadMultiFab(*Efield_fp[lev][2],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ez_fp"));
 
-        VisMF::Read(*Bfield_fp[lev][0],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bx_fp"));
-        VisMF::Read(*Bfield_fp[lev][1],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "By_fp"));
-        VisMF::Read(*Bfield_fp[lev][2],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_fp"));
+        ReadMultiFab(*Bfield_fp[lev][0],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bx_fp"));
+        ReadMultiFab(*Bfield_fp[lev][1],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "By_fp"));
+        ReadMultiFab(*Bfield_fp[lev][2],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_fp"));
 
 #ifdef WARPX_MAG_LLG
-        VisMF::Read(*Hfield_fp[lev][0],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hx_fp"));
-        VisMF::Read(*Hfield_fp[lev][1],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hy_fp"));
-        VisMF::Read(*Hfield_fp[lev][2],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hz_fp"));
-        VisMF::Read(*Mfield_fp[lev][0],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mx_fp"));
-        VisMF::Read(*Mfield_fp[lev][1],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "My_fp"));
-        VisMF::Read(*Mfield_fp[lev][2],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mz_fp"));
-        VisMF::Read(*H_biasfield_fp[lev][0],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hxbias_fp"));
-        VisMF::Read(*H_biasfield_fp[lev][1],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hybias_fp"));
-        VisMF::Read(*H_biasfield_fp[lev][2],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hzbias_fp"));
+        ReadMultiFab(*Hfield_fp[lev][0],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hx_fp"));
+        ReadMultiFab(*Hfield_fp[lev][1],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hy_fp"));
+        ReadMultiFab(*Hfield_fp[lev][2],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hz_fp"));
+        ReadMultiFab(*Mfield_fp[lev][0],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mx_fp"));
+        ReadMultiFab(*Mfield_fp[lev][1],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "My_fp"));
+        ReadMultiFab(*Mfield_fp[lev][2],
+                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mz_fp"));
+        if (!m_restart_static_dir.empty() && HbiasIsStatic()) {
+            ReadStaticData(*H_biasfield_fp[lev][0], lev, "Hxbias_fp");
+            ReadStaticData(*H_biasfield_fp[lev][1], lev, "Hybias_fp");
+            ReadStaticData(*H_biasfield_fp[lev][2], lev, "Hzbias_fp");
+        } else {
+            ReadMultiFab(*H_biasfield_fp[lev][0],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hxbias_fp"));
+            ReadMultiFab(*H_biasfield_fp[lev][1],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hybias_fp"));
+            ReadMultiFab(*H_biasfield_fp[lev][2],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hzbias_fp"));
+        }
 #endif
         if (WarpX::fft_do_time_averaging)
         {
-            VisMF::Read(*Efield_avg_fp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_avg_fp"));
-            VisMF::Read(*Efield_avg_fp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ey_avg_fp"));
-            VisMF::Read(*Efield_avg_fp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ez_avg_fp"));
-
-            VisMF::Read(*Bfield_avg_fp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bx_avg_fp"));
-            VisMF::Read(*Bfield_avg_fp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "By_avg_fp"));
-            VisMF::Read(*Bfield_avg_fp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_avg_fp"));
+            ReadMultiFab(*Efield_avg_fp[lev][0],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_avg_fp"));
+            ReadMultiFab(*Efield_avg_fp[lev][1],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ey_avg_fp"));
+            ReadMultiFab(*Efield_avg_fp[lev][2],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ez_avg_fp"));
+
+            ReadMultiFab(*Bfield_avg_fp[lev][0],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bx_avg_fp"));
+            ReadMultiFab(*Bfield_avg_fp[lev][1],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "By_avg_fp"));
+            ReadMultiFab(*Bfield_avg_fp[lev][2],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_avg_fp"));
         }
 
         if (is_synchronized || WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon) {
-            VisMF::Read(*current_fp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jx_fp"));
-            VisMF::Read(*current_fp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jy_fp"));
-            VisMF::Read(*current_fp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jz_fp"));
+            ReadMultiFab(*current_fp[lev][0],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jx_fp"));
+            ReadMultiFab(*current_fp[lev][1],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jy_fp"));
+            ReadMultiFab(*current_fp[lev][2],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jz_fp"));
         }
 
         if (lev > 0)
         {
-            VisMF::Read(*Efield_cp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_cp"));
-            VisMF::Read(*Efield_cp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ey_cp"));
-            VisMF::Read(*Efield_cp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ez_cp"));
-
-            VisMF::Read(*Bfield_cp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bx_cp"));
-            VisMF::Read(*Bfield_cp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "By_cp"));
-            VisMF::Read(*Bfield_cp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_cp"));
+            ReadMultiFab(*Efield_cp[lev][0],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_cp"));
+            ReadMultiFab(*Efield_cp[lev][1],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ey_cp"));
+            ReadMultiFab(*Efield_cp[lev][2],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ez_cp"));
+
+            ReadMultiFab(*Bfield_cp[lev][0],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bx_cp"));
+            ReadMultiFab(*Bfield_cp[lev][1],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "By_cp"));
+            ReadMultiFab(*Bfield_cp[lev][2],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_cp"));
 
 #ifdef WARPX_MAG_LLG
-            VisMF::Read(*Hfield_cp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hx_cp"));
-            VisMF::Read(*Hfield_cp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hy_cp"));
-            VisMF::Read(*Hfield_cp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hz_cp"));
-
-            VisMF::Read(*Mfield_cp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mx_cp"));
-            VisMF::Read(*Mfield_cp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "My_cp"));
-            VisMF::Read(*Mfield_cp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mz_cp"));
-
-            VisMF::Read(*H_biasfield_cp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hxbias_cp"));
-            VisMF::Read(*H_biasfield_cp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hybias_cp"));
-            VisMF::Read(*H_biasfield_cp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hzbias_cp"));
+            ReadMultiFab(*Hfield_cp[lev][0],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hx_cp"));
+            ReadMultiFab(*Hfield_cp[lev][1],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hy_cp"));
+            ReadMultiFab(*Hfield_cp[lev][2],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hz_cp"));
+
+            ReadMultiFab(*Mfield_cp[lev][0],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mx_cp"));
+            ReadMultiFab(*Mfield_cp[lev][1],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "My_cp"));
+            ReadMultiFab(*Mfield_cp[lev][2],
+                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mz_cp"));
+
+            if (!m_restart_static_dir.empty() && HbiasIsStatic()) {
+                ReadStaticData(*H_biasfield_cp[lev][0], lev, "Hxbias_cp");
+                ReadStaticData(*H_biasfield_cp[lev][1], lev, "Hybias_cp");
+                ReadStaticData(*H_biasfield_cp[lev][2], lev, "Hzbias_cp");
+            } else {
+                ReadMultiFab(*H_biasfield_cp[lev][0],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hxbias_cp"));
+                ReadMultiFab(*H_biasfield_cp[lev][1],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hybias_cp"));
+                ReadMultiFab(*H_biasfield_cp[lev][2],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hzbias_cp"));
+            }
 #endif
             if (WarpX::fft_do_time_averaging)
             {
-                VisMF::Read(*Efield_avg_cp[lev][0],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_avg_cp"));
-                VisMF::Read(*Efield_avg_cp[lev][1],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ey_avg_cp"));
-                VisMF::Read(*Efield_avg_cp[lev][2],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ez_avg_cp"));
-
-                VisMF::Read(*Bfield_avg_cp[lev][0],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bx_avg_cp"));
-                VisMF::Read(*Bfield_avg_cp[lev][1],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "By_avg_cp"));
-                VisMF::Read(*Bfield_avg_cp[lev][2],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_avg_cp"));
+                ReadMultiFab(*Efield_avg_cp[lev][0],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_avg_cp"));
+                ReadMultiFab(*Efield_avg_cp[lev][1],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ey_avg_cp"));
+                ReadMultiFab(*Efield_avg_cp[lev][2],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ez_avg_cp"));
+
+                ReadMultiFab(*Bfield_avg_cp[lev][0],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bx_avg_cp"));
+                ReadMultiFab(*Bfield_avg_cp[lev][1],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "By_avg_cp"));
+                ReadMultiFab(*Bfield_avg_cp[lev][2],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_avg_cp"));
             }
 
             if (is_synchronized || WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon) {
-                VisMF::Read(*current_cp[lev][0],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jx_cp"));
-                VisMF::Read(*current_cp[lev][1],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jy_cp"));
-                VisMF::Read(*current_cp[lev][2],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jz_cp"));
+                ReadMultiFab(*current_cp[lev][0],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jx_cp"));
+                ReadMultiFab(*current_cp[lev][1],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jy_cp"));
+                ReadMultiFab(*current_cp[lev][2],
+                             amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "jz_cp"));
             }
         }
     }
@@ -402,6 +442,49 @@ WarpX::InitFromCheckpoint ()
 
 }
 
+amrex::Vector<std::pair<std::string, amrex::MultiFab*>>
+WarpX::GetStaticMultiFabs (int lev)
+{
+    amrex::Vector<std::pair<std::string, amrex::MultiFab*>> static_mfs;
+#ifdef WARPX_MAG_LLG
+    if (HbiasIsStatic()) {
+        static_mfs.emplace_back("Hxbias_fp", H_biasfield_fp[lev][0].get());
+        static_mfs.emplace_back("Hybias_fp", H_biasfield_fp[lev][1].get());
+        static_mfs.emplace_back("Hzbias_fp", H_biasfield_fp[lev][2].get());
+        if (lev > 0) {
+            static_mfs.emplace_back("Hxbias_cp", H_biasfield_cp[lev][0].get());
+            static_mfs.emplace_back("Hybias_cp", H_biasfield_cp[lev][1].get());
+            static_mfs.emplace_back("Hzbias_cp", H_biasfield_cp[lev][2].get());
+        }
+    }
+#endif
+    // The macroscopic properties are only defined on level 0
+    if (lev == 0 && WarpX::em_solver_medium == MediumForEM::Macroscopic) {
+        for (auto& static_mf : m_macroscopic_properties->GetStaticMultiFabs()) {
+            static_mfs.push_back(static_mf);
+        }
+    }
+    return static_mfs;
+}
+
+void
+WarpX::ReadStaticData (amrex::MultiFab& mf, int lev, const std::string& name) const
+{
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!m_restart_static_dir.empty(),
+        "No static data to read " + name + " from");
+    // Read with the BoxArray it was written with, then copy to mf,
+    // which may be distributed differently.
+    const std::string file_name = amrex::MultiFabFileFullPrefix(lev, m_restart_static_dir, level_prefix, name);
+    if (FieldCompression::IsCompressed(file_name)) {
+        FieldCompression::Read(mf, file_name);
+        return;
+    }
+    amrex::MultiFab tmp;
+    VisMF::Read(tmp, file_name);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(tmp.nComp() == mf.nComp() && tmp.ixType() == mf.ixType(),
+        "The static data " + name + " does not match the simulation");
+    mf.ParallelCopy(tmp, 0, 0, mf.nComp(), tmp.nGrowVect(), mf.nGrowVect());
+}
 
 std::unique_ptr<MultiFab>
 WarpX::GetCellCenteredData() {
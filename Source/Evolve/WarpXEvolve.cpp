@@ -12,9 +12,11 @@
 
 #include "BoundaryConditions/PML.H"
 #include "Diagnostics/BackTransformedDiagnostic.H"
+#include "Diagnostics/FlushFormats/FlushFormat.H"
 #include "Diagnostics/MultiDiagnostics.H"
 #include "Diagnostics/ReducedDiags/MultiReducedDiags.H"
 #include "Evolve/WarpXDtType.H"
+#include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
 #ifdef WARPX_USE_PSATD
 #   ifdef WARPX_DIM_RZ
 #       include "FieldSolver/SpectralSolver/SpectralSolverRZ.H"
@@ -130,8 +132,8 @@ WarpX::Evolve (int numsteps)
                 FillBoundaryB(guard_cells.ng_alloc_EB);
 #endif
 #ifdef WARPX_MAG_LLG
-                FillBoundaryH(guard_cells.ng_alloc_EB);
-                FillBoundaryM(guard_cells.ng_alloc_EB);
+                FillBoundaryH(guard_cells.ng_alloc_H);
+                FillBoundaryM(guard_cells.ng_alloc_M);
 #endif
                 UpdateAuxilaryData();
                 FillBoundaryAux(guard_cells.ng_UpdateAux);
@@ -381,17 +383,33 @@ WarpX::Evolve (int numsteps)
                       << " s; Avg. per step = " << evolve_time/(step-step_begin+1) << " s\n";
         }
 
-        if (cur_time >= stop_time - 1.e-3*dt[0] || SignalHandling::TestAndResetActionRequestFlag(SignalHandling::SIGNAL_REQUESTS_BREAK)) {
+        if (cur_time >= stop_time - 1.e-3*dt[0]) {
+            break;
+        }
+        if (SignalHandling::TestAndResetActionRequestFlag(SignalHandling::SIGNAL_REQUESTS_BREAK)) {
+            // The job may be terminated soon after the signal: write the buffered data first
+            FlushBufferedDiagnostics();
             break;
         }
 
         // End loop on time steps
     }
+    if (reduced_diags->m_plot_rd != 0) {
+        reduced_diags->Finalize();
+    }
     multi_diags->FilterComputePackFlushLastTimestep( istep[0] );
 
     if (do_back_transformed_diagnostics) {
         myBFD->Flush(geom[0]);
     }
+
+    // Make sure the asynchronous output is on disk when Evolve returns. The writer thread
+    // is only stopped at the end of the run, since Evolve can be called again (e.g., from Python)
+    if (istep[0] >= max_step || cur_time >= stop_time - 1.e-3*dt[0]) {
+        FlushFormat::FinishAsyncOutput();
+    } else {
+        FlushFormat::WaitForAsyncOutput();
+    }
 }
 
 /* /brief Perform one PIC iteration, without subcycling
@@ -414,8 +432,8 @@ WarpX::OneStep_nosub (Real cur_time)
         PushParticlesandDepose(cur_time);
     }
 #ifndef WARPX_MAG_LLG
-    if (WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon) {
-        amrex::Print() << " in evolve london j\n";
+    // With london.fused_update, J is advanced in MacroscopicEvolveE instead
+    if (WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon && !m_london->m_fused_update) {
         m_london->EvolveLondonJ(dt[0]); // J^(n-1/2) to J^(n+1/2) using E^(n)
         EvolveBLondon(0.5_rt * dt[0], DtType::FirstHalf); // We now have B^{n+1/2}
         FillBoundaryJ(guard_cells.ng_alloc_EB);
@@ -492,15 +510,35 @@ WarpX::OneStep_nosub (Real cur_time)
             NodalSyncPML();
         }
     } else {
+        // With warpx.do_comm_overlap, the guard cells of B (or H and M) and then of E are
+        // exchanged while the cells that do not read them are pushed. The excitations are
+        // applied before the exchanges, which then fill the guard cells with excited values.
+        const auto push_E = [&] () {
+            if (WarpX::em_solver_medium == MediumForEM::Vacuum) {
+                // vacuum medium
+                EvolveE(dt[0]); // We now have E^{n+1}
+            } else if (WarpX::em_solver_medium == MediumForEM::Macroscopic) {
+                // macroscopic medium
+                MacroscopicEvolveE(dt[0]); // We now have E^{n+1}
+            } else {
+                amrex::Abort(Utils::TextMsg::Err("Medium for EM is unknown"));
+            }
+        };
+
         EvolveF(0.5_rt * dt[0], DtType::FirstHalf);
         EvolveG(0.5_rt * dt[0], DtType::FirstHalf);
         FillBoundaryF(guard_cells.ng_FieldSolverF);
         FillBoundaryG(guard_cells.ng_FieldSolverG);
 #ifndef WARPX_MAG_LLG
         EvolveB(0.5_rt * dt[0], DtType::FirstHalf); // We now have B^{n+1/2}
-        FillBoundaryB(guard_cells.ng_FieldSolver);
-        // ApplyExternalFieldExcitation
-        ApplyExternalFieldExcitationOnGrid(ExternalFieldType::BfieldExternal, DtType::FirstHalf); // apply B external excitation; soft source to be fixed
+        if (do_comm_overlap) {
+            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::BfieldExternal, DtType::FirstHalf);
+            FillBoundaryB_nowait(guard_cells.ng_FieldSolver);
+        } else {
+            FillBoundaryB(guard_cells.ng_FieldSolver);
+            // ApplyExternalFieldExcitation
+            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::BfieldExternal, DtType::FirstHalf); // apply B external excitation; soft source to be fixed
+        }
 #endif
 
 #ifdef WARPX_MAG_LLG
@@ -513,39 +551,87 @@ WarpX::OneStep_nosub (Real cur_time)
             } else {
                 amrex::Abort("unsupported mag_time_scheme_order for M field");
             }
-            FillBoundaryH(guard_cells.ng_FieldSolver);
-            FillBoundaryM(guard_cells.ng_FieldSolver);
-            // ApplyExternalFieldExcitation
-            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HfieldExternal, DtType::FirstHalf); // apply H external excitation; soft source to be fixed
-            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HbiasfieldExternal, DtType::FirstHalf); // apply H external excitation; soft source to be fixed
+            if (do_comm_overlap) {
+                ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HfieldExternal, DtType::FirstHalf);
+                ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HbiasfieldExternal, DtType::FirstHalf);
+                FillBoundaryH_nowait(guard_cells.ng_FieldSolver);
+                FillBoundaryM_nowait(guard_cells.ng_FieldSolver);
+            } else {
+                FillBoundaryH(guard_cells.ng_FieldSolver);
+                FillBoundaryM(guard_cells.ng_FieldSolver);
+                // ApplyExternalFieldExcitation
+                ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HfieldExternal, DtType::FirstHalf); // apply H external excitation; soft source to be fixed
+                ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HbiasfieldExternal, DtType::FirstHalf); // apply H external excitation; soft source to be fixed
+            }
 
         } else {
             amrex::Abort("unsupported em_solver_medium for M field");
         }
 #endif // ifndef WARPX_DIM_RZ
 #endif
-        if (WarpX::em_solver_medium == MediumForEM::Vacuum) {
-            // vacuum medium
-            EvolveE(dt[0]); // We now have E^{n+1}
-        } else if (WarpX::em_solver_medium == MediumForEM::Macroscopic) {
-            // macroscopic medium
-            MacroscopicEvolveE(dt[0]); // We now have E^{n+1}
+        if (do_comm_overlap) {
+            SetFieldPushRegion(PushRegion::Interior);
+            push_E();
+#ifndef WARPX_MAG_LLG
+            FillBoundaryB_finish();
+#else
+            FillBoundaryH_finish();
+            FillBoundaryM_finish();
+#endif
+            SetFieldPushRegion(PushRegion::Boundary);
+            push_E();
+            SetFieldPushRegion(PushRegion::All);
         } else {
-            amrex::Abort(Utils::TextMsg::Err("Medium for EM is unknown"));
+            push_E();
         }
 
-        FillBoundaryE(guard_cells.ng_FieldSolver);
-        // ApplyExternalFieldExcitation
-        ApplyExternalFieldExcitationOnGrid(ExternalFieldType::EfieldExternal); // apply E external excitation; soft source to be fixed
-        if (WarpX::ApplyExcitationInPML == 1) {
-            // Apply Efiled excitation in the pml region
-            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::EfieldExternalPML);
+        // The second-order M update is iterative and is not split
+#ifndef WARPX_MAG_LLG
+        const bool overlap_E_exchange = do_comm_overlap;
+#else
+        const bool overlap_E_exchange = do_comm_overlap && mag_time_scheme_order == 1;
+#endif
+        if (overlap_E_exchange) {
+            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::EfieldExternal);
+            if (WarpX::ApplyExcitationInPML == 1) {
+                ApplyExternalFieldExcitationOnGrid(ExternalFieldType::EfieldExternalPML);
+            }
+            FillBoundaryE_nowait(guard_cells.ng_FieldSolver);
+            SetFieldPushRegion(PushRegion::Interior);
+#ifndef WARPX_MAG_LLG
+            EvolveB(0.5_rt * dt[0], DtType::SecondHalf);
+#else
+            MacroscopicEvolveHM(0.5*dt[0]);
+#endif
+            FillBoundaryE_finish();
+        } else {
+            FillBoundaryE(guard_cells.ng_FieldSolver);
+        }
+#ifndef WARPX_MAG_LLG
+        if (WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon && m_london->m_fused_update) {
+            // J^(n+1/2) was computed in the E-update. The Yee curl of J on the B_sc faces
+            // only reads valid edges, so the exchange of J is only needed for wider stencils.
+            if (WarpX::maxwell_solver_id != MaxwellSolverAlgo::Yee) {
+                FillBoundaryJ(guard_cells.ng_alloc_EB);
+            }
+            EvolveBLondon(0.5_rt * dt[0], DtType::FirstHalf);
+        }
+#endif
+        if (!overlap_E_exchange) {
+            // ApplyExternalFieldExcitation
+            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::EfieldExternal); // apply E external excitation; soft source to be fixed
+            if (WarpX::ApplyExcitationInPML == 1) {
+                // Apply Efiled excitation in the pml region
+                ApplyExternalFieldExcitationOnGrid(ExternalFieldType::EfieldExternalPML);
+            }
         }
 
         EvolveF(0.5_rt * dt[0], DtType::SecondHalf);
         EvolveG(0.5_rt * dt[0], DtType::SecondHalf);
+        if (overlap_E_exchange) SetFieldPushRegion(PushRegion::Boundary);
 #ifndef WARPX_MAG_LLG
         EvolveB(0.5_rt * dt[0], DtType::SecondHalf); // We now have B^{n+1}
+        if (overlap_E_exchange) SetFieldPushRegion(PushRegion::All);
 
         // Synchronize E and B fields on nodal points
         NodalSync(Efield_fp, Efield_cp);
@@ -564,6 +650,7 @@ WarpX::OneStep_nosub (Real cur_time)
         if (WarpX::em_solver_medium == MediumForEM::Macroscopic) {
             if (mag_time_scheme_order==1){
                 MacroscopicEvolveHM(0.5*dt[0]); // we now have M^{n+1} and H^{n+1}
+                if (overlap_E_exchange) SetFieldPushRegion(PushRegion::All);
             } else if (mag_time_scheme_order==2){
                 MacroscopicEvolveHM_2nd(0.5*dt[0]); // we now have M^{n+1} and H^{n+1}
             } else {
@@ -572,8 +659,8 @@ WarpX::OneStep_nosub (Real cur_time)
             // H and M are up-to-date in the domain, but all guard cells are
             // outdated.
             if ( safe_guard_cells ){
-                FillBoundaryH(guard_cells.ng_alloc_EB);
-                FillBoundaryM(guard_cells.ng_alloc_EB);
+                FillBoundaryH(guard_cells.ng_alloc_H);
+                FillBoundaryM(guard_cells.ng_alloc_M);
             }
             // ApplyExternalFieldExcitation
             ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HfieldExternal, DtType::SecondHalf); // redundant for hs; need to fix the way to increment ss
@@ -1072,6 +1159,27 @@ WarpX::CheckSignals()
     SignalHandling::CheckSignals();
 }
 
+void
+WarpX::FlushBufferedDiagnostics ()
+{
+    if (reduced_diags->m_plot_rd != 0) { reduced_diags->Flush(); }
+    multi_diags->FlushBufferedData();
+}
+
+void
+WarpX::WriteDiagnosticsCheckpointData (const std::string& dir)
+{
+    if (reduced_diags->m_plot_rd != 0) { reduced_diags->WriteCheckpointData(dir); }
+    multi_diags->WriteCheckpointData(dir);
+}
+
+void
+WarpX::ReadDiagnosticsCheckpointData (const std::string& dir)
+{
+    if (reduced_diags->m_plot_rd != 0) { reduced_diags->ReadCheckpointData(dir); }
+    multi_diags->ReadCheckpointData(dir);
+}
+
 void
 WarpX::HandleSignals()
 {
@@ -1080,6 +1188,10 @@ WarpX::HandleSignals()
     // SIGNAL_REQUESTS_BREAK is handled directly in WarpX::Evolve
 
     if (SignalHandling::TestAndResetActionRequestFlag(SignalHandling::SIGNAL_REQUESTS_CHECKPOINT)) {
+        // The buffered diags are also written when no checkpoint diagnostic is defined
+        FlushBufferedDiagnostics();
         multi_diags->FilterComputePackFlushLastTimestep( istep[0] );
+        // The job may be terminated soon after the signal: do not leave the dump in flight
+        FlushFormat::WaitForAsyncOutput();
     }
 }
@@ -0,0 +1,299 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "ExcitationSources.H"
+
+#include "Utils/TextMsg.H"
+#include "Utils/VoxelMaterialMap.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX.H>
+#include <AMReX_Array4.H>
+#include <AMReX_Box.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Scan.H>
+
+#include <vector>
+
+using namespace amrex;
+
+SeparableExcitation::SeparableExcitation (std::array<std::string, 3> const& names)
+{
+    ParmParse pp_warpx("warpx");
+    for (int icomp = 0; icomp < 3; ++icomp) {
+        Store_parserString(pp_warpx, names[icomp] + "_excitation_spatial_function(x,y,z)",
+                           m_str_spatial_functions[icomp]);
+        m_spatial_parsers[icomp] = std::make_unique<amrex::Parser>(
+            makeParser(m_str_spatial_functions[icomp], {"x","y","z"}));
+
+        std::string waveform_style = "parse_waveform_function";
+        pp_warpx.query((names[icomp] + "_excitation_waveform_style").c_str(), waveform_style);
+        const auto it = WarpXExcitationWaveforms::excitation_waveforms_dictionary.find(waveform_style);
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+            it != WarpXExcitationWaveforms::excitation_waveforms_dictionary.end(),
+            "Unknown excitation waveform style " + waveform_style + " for " + names[icomp]);
+        m_waveforms[icomp] = it->second();
+        m_waveforms[icomp]->init(pp_warpx, names[icomp]);
+    }
+}
+
+std::array<amrex::Real, 3>
+SeparableExcitation::EvaluateWaveforms (amrex::Real t)
+{
+    std::array<amrex::Real, 3> amplitudes;
+    for (int icomp = 0; icomp < 3; ++icomp) {
+        m_waveforms[icomp]->update(t);
+        amplitudes[icomp] = m_waveforms[icomp]->evaluate(t);
+    }
+    return amplitudes;
+}
+
+ExcitationSources::ExcitationSources (int nlevs_max)
+{
+    m_cells.resize(nlevs_max);
+    m_profile.resize(nlevs_max);
+    m_is_built.resize(nlevs_max, 0);
+}
+
+void
+ExcitationSources::Build (std::array<amrex::MultiFab*, 3> const& fields,
+                          std::array<amrex::ParserExecutor<3>, 3> const& flag_parsers,
+                          int lev,
+                          std::array<amrex::ParserExecutor<3>, 3> const* spatial_parsers)
+{
+    WARPX_PROFILE("ExcitationSources::Build()");
+
+    auto& warpx = WarpX::GetInstance();
+    const auto problo = warpx.Geom(lev).ProbLoArray();
+    const auto dx = warpx.Geom(lev).CellSizeArray();
+    VoxelMaterialMap const* const material_map =
+        m_map_flag_names[0].empty() ? nullptr : &warpx.GetMaterialMap();
+
+    for (int icomp = 0; icomp < 3; ++icomp) {
+        amrex::MultiFab* mf = fields[icomp];
+        m_cells[lev][icomp] = std::make_unique<
+            amrex::LayoutData< amrex::Gpu::DeviceVector<ExcitationCell> > >(
+                mf->boxArray(), mf->DistributionMap());
+        if (spatial_parsers) {
+            m_profile[lev][icomp] = std::make_unique<
+                amrex::LayoutData< amrex::Gpu::DeviceVector<amrex::Real> > >(
+                    mf->boxArray(), mf->DistributionMap());
+        }
+
+        GpuArray<int,3> mf_stag{0, 0, 0};
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            mf_stag[idim] = mf->ixType()[idim];
+        }
+        ParserExecutor<3> const flag_parser = flag_parsers[icomp];
+
+        // Flag of each material, when the flags are read from the material map
+        amrex::Gpu::DeviceVector<int> material_flags;
+        if (material_map) {
+            const amrex::Vector<amrex::Real> values = material_map->MaterialValues(
+                m_map_flag_names[icomp] + "_excitation_flag", 0._rt);
+            std::vector<int> h_flags(values.size());
+            for (std::size_t imat = 0; imat < values.size(); ++imat) {
+                WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+                    values[imat] == 0._rt || values[imat] == 1._rt || values[imat] == 2._rt,
+                    "flag type for excitation must be 0, or 1, or 2!");
+                h_flags[imat] = static_cast<int>(values[imat]);
+            }
+            material_flags.resize(h_flags.size());
+            amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, h_flags.begin(), h_flags.end(),
+                                  material_flags.begin());
+        }
+        int const* const material_flags_ptr = material_flags.dataPtr();
+
+        for ( MFIter mfi(*mf); mfi.isValid(); ++mfi ) {
+            // Guard cells are included, as in the full-domain evaluation
+            const amrex::Box bx = mfi.fabbox();
+            const int ncells = static_cast<int>(bx.numPts());
+
+            // Evaluate the flag once per point
+            amrex::Gpu::DeviceVector<int> flags(ncells);
+            if (material_map) {
+                // The material ids are replaced by the flags of the materials
+                material_map->SampleIds(bx, mf->ixType(), lev, flags);
+                int* const flags_ptr = flags.dataPtr();
+                amrex::ParallelFor(ncells,
+                    [=] AMREX_GPU_DEVICE (int icell) {
+                        flags_ptr[icell] = material_flags_ptr[flags_ptr[icell]];
+                    });
+            } else {
+                int* const flags_ptr = flags.dataPtr();
+                amrex::ParallelFor(ncells,
+                    [=] AMREX_GPU_DEVICE (int icell) {
+                        const amrex::Dim3 cell = bx.atOffset(icell).dim3();
+                        amrex::Real x, y, z;
+                        WarpXUtilAlgo::getCellCoordinates(cell.x, cell.y, cell.z, mf_stag,
+                                                          problo, dx, x, y, z);
+                        const amrex::Real flag_type = flag_parser(x,y,z);
+                        if (flag_type != 0._rt && flag_type != 1._rt && flag_type != 2._rt) {
+                            amrex::Abort("flag type for excitation must be 0, or 1, or 2!");
+                        }
+                        flags_ptr[icell] = static_cast<int>(flag_type);
+                    });
+            }
+            int* const flags_ptr = flags.dataPtr();
+
+            // Position of each point with a non-zero flag in the list
+            amrex::Gpu::DeviceVector<int> offsets(ncells);
+            int* const offsets_ptr = offsets.dataPtr();
+            const int nsources = amrex::Scan::PrefixSum<int>(ncells,
+                [=] AMREX_GPU_DEVICE (int icell) -> int {
+                    return (flags_ptr[icell] > 0) ? 1 : 0;
+                },
+                [=] AMREX_GPU_DEVICE (int icell, int ps) {
+                    offsets_ptr[icell] = ps;
+                },
+                amrex::Scan::Type::exclusive);
+
+            // Compact the points with a non-zero flag
+            auto& cells = (*m_cells[lev][icomp])[mfi];
+            cells.resize(nsources);
+            if (nsources == 0) continue;
+            ExcitationCell* const cells_ptr = cells.dataPtr();
+            amrex::ParallelFor(ncells,
+                [=] AMREX_GPU_DEVICE (int icell) {
+                    if (flags_ptr[icell] > 0) {
+                        const amrex::Dim3 cell = bx.atOffset(icell).dim3();
+                        cells_ptr[offsets_ptr[icell]] =
+                            ExcitationCell{cell.x, cell.y, cell.z, flags_ptr[icell]};
+                    }
+                });
+
+            // Cache the spatial profile of a separable excitation on the source points
+            if (spatial_parsers) {
+                ParserExecutor<3> const spatial_parser = (*spatial_parsers)[icomp];
+                auto& profile = (*m_profile[lev][icomp])[mfi];
+                profile.resize(nsources);
+                amrex::Real* const profile_ptr = profile.dataPtr();
+                amrex::ParallelFor(nsources,
+                    [=] AMREX_GPU_DEVICE (int p) {
+                        const ExcitationCell c = cells_ptr[p];
+                        amrex::Real x, y, z;
+                        WarpXUtilAlgo::getCellCoordinates(c.i, c.j, c.k, mf_stag,
+                                                          problo, dx, x, y, z);
+                        profile_ptr[p] = spatial_parser(x,y,z);
+                    });
+            }
+        }
+    }
+    amrex::Gpu::synchronize();
+    m_is_built[lev] = 1;
+}
+
+void
+ExcitationSources::Apply (std::array<amrex::MultiFab*, 3> const& fields,
+                          std::array<amrex::ParserExecutor<4>, 3> const& field_parsers,
+                          amrex::Real t, bool half_step, int lev)
+{
+    auto& warpx = WarpX::GetInstance();
+    const auto problo = warpx.Geom(lev).ProbLoArray();
+    const auto dx = warpx.Geom(lev).CellSizeArray();
+
+    for (int icomp = 0; icomp < 3; ++icomp) {
+        amrex::MultiFab* mf = fields[icomp];
+        GpuArray<int,3> mf_stag{0, 0, 0};
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            mf_stag[idim] = mf->ixType()[idim];
+        }
+        // If not split pml fields, the excitation is applied to the regular field.
+        // If pml field, then the excitation is applied to all the split field components.
+        const int ncomp = mf->nComp();
+        ParserExecutor<4> const field_parser = field_parsers[icomp];
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for ( MFIter mfi(*mf); mfi.isValid(); ++mfi ) {
+            auto const& cells = (*m_cells[lev][icomp])[mfi];
+            const int nsources = static_cast<int>(cells.size());
+            if (nsources == 0) continue;
+            ExcitationCell const* const cells_ptr = cells.dataPtr();
+            amrex::Array4<amrex::Real> const& F = mf->array(mfi);
+
+            amrex::ParallelFor(nsources,
+                [=] AMREX_GPU_DEVICE (int p) {
+                    const ExcitationCell c = cells_ptr[p];
+                    amrex::Real x, y, z;
+                    WarpXUtilAlgo::getCellCoordinates(c.i, c.j, c.k, mf_stag,
+                                                      problo, dx, x, y, z);
+                    // For soft source and FirstHalf/SecondHalf evolve
+                    // the excitation is split with a prefactor of 0.5
+                    const amrex::Real dt_type_factor = (c.flag == 2 && half_step) ? 0.5_rt : 1._rt;
+                    const amrex::Real excitation = dt_type_factor * field_parser(x,y,z,t);
+                    // hard source (flag 1): field = excitation
+                    // soft source (flag 2): field += excitation
+                    const amrex::Real keep = static_cast<amrex::Real>(c.flag - 1);
+                    for (int n = 0; n < ncomp; ++n) {
+                        F(c.i, c.j, c.k, n) = F(c.i, c.j, c.k, n) * keep + excitation;
+                    }
+                });
+        }
+    }
+}
+
+void
+ExcitationSources::ApplySeparable (std::array<amrex::MultiFab*, 3> const& fields,
+                                   std::array<amrex::Real, 3> const& amplitudes,
+                                   bool half_step, int lev)
+{
+    for (int icomp = 0; icomp < 3; ++icomp) {
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_profile[lev][icomp] != nullptr,
+            "ExcitationSources::ApplySeparable: the spatial profile was not built");
+        amrex::MultiFab* mf = fields[icomp];
+        const int ncomp = mf->nComp();
+        const amrex::Real amplitude = amplitudes[icomp];
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for ( MFIter mfi(*mf); mfi.isValid(); ++mfi ) {
+            auto const& cells = (*m_cells[lev][icomp])[mfi];
+            const int nsources = static_cast<int>(cells.size());
+            if (nsources == 0) continue;
+            ExcitationCell const* const cells_ptr = cells.dataPtr();
+            amrex::Real const* const profile_ptr = (*m_profile[lev][icomp])[mfi].dataPtr();
+            amrex::Array4<amrex::Real> const& F = mf->array(mfi);
+
+            amrex::ParallelFor(nsources,
+                [=] AMREX_GPU_DEVICE (int p) {
+                    const ExcitationCell c = cells_ptr[p];
+                    const amrex::Real dt_type_factor = (c.flag == 2 && half_step) ? 0.5_rt : 1._rt;
+                    const amrex::Real excitation = dt_type_factor * amplitude * profile_ptr[p];
+                    const amrex::Real keep = static_cast<amrex::Real>(c.flag - 1);
+                    for (int n = 0; n < ncomp; ++n) {
+                        F(c.i, c.j, c.k, n) = F(c.i, c.j, c.k, n) * keep + excitation;
+                    }
+                });
+        }
+    }
+}
+
+void
+ExcitationSources::Clear (int lev)
+{
+    for (int icomp = 0; icomp < 3; ++icomp) {
+        m_cells[lev][icomp].reset();
+        m_profile[lev][icomp].reset();
+    }
+    m_is_built[lev] = 0;
+}
+
+void
+ExcitationSources::ClearAll ()
+{
+    for (int lev = 0; lev < static_cast<int>(m_cells.size()); ++lev) {
+        Clear(lev);
+    }
+}
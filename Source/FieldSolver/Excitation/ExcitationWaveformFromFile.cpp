@@ -0,0 +1,194 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "ExcitationWaveforms.H"
+
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXUtil.H"
+
+#include <AMReX.H>
+#include <AMReX_Algorithm.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Vector.H>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+using namespace amrex;
+
+void
+WarpXExcitationWaveforms::FromFileExcitationWaveform::init (
+    const amrex::ParmParse& pp, const std::string& name)
+{
+    const std::string prefix = name + "_excitation_waveform_";
+
+    pp.get((prefix + "file_name").c_str(), m_file_name);
+
+    std::string file_format = "text";
+    pp.query((prefix + "file_format").c_str(), file_format);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(file_format == "text" || file_format == "binary",
+        prefix + "file_format must be text or binary");
+    m_is_binary = (file_format == "binary");
+
+    std::string interpolation = "linear";
+    pp.query((prefix + "interpolation").c_str(), interpolation);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(interpolation == "linear" || interpolation == "cubic",
+        prefix + "interpolation must be linear or cubic");
+    m_is_cubic = (interpolation == "cubic");
+
+    queryWithParser(pp, (prefix + "chunk_size").c_str(), m_chunk_size);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_chunk_size >= 4,
+        prefix + "chunk_size must be >= 4");
+
+    queryWithParser(pp, (prefix + "delay").c_str(), m_delay);
+
+    if (ParallelDescriptor::IOProcessor()) {
+        const auto mode = m_is_binary ? std::ios::in | std::ios::binary : std::ios::in;
+        m_file.open(m_file_name, mode);
+        if (!m_file) Abort("Failed to open excitation waveform file " + m_file_name);
+        if (m_is_binary) {
+            std::uint64_t ns = 0;
+            m_file.read(reinterpret_cast<char*>(&ns), sizeof(std::uint64_t));
+            if (!m_file) Abort("Failed to read the number of samples from " + m_file_name);
+            m_samples_left = static_cast<long>(ns);
+        }
+    }
+
+    // Read first chunk
+    read_next_chunk();
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_t.size() >= 2,
+        "The excitation waveform file " + m_file_name + " must contain at least 2 samples");
+    m_t_first = m_t.front();
+}
+
+void
+WarpXExcitationWaveforms::FromFileExcitationWaveform::update (amrex::Real t)
+{
+    t -= m_delay;
+
+    // Number of samples needed after t to interpolate
+    const long n_right = m_is_cubic ? 2 : 1;
+    while (!m_end_of_file) {
+        const auto it = std::upper_bound(m_t.begin(), m_t.end(), t);
+        if (std::distance(it, m_t.end()) >= n_right) break;
+        read_next_chunk();
+    }
+}
+
+amrex::Real
+WarpXExcitationWaveforms::FromFileExcitationWaveform::evaluate (amrex::Real t) const
+{
+    t -= m_delay;
+
+    // The waveform is 0 if time is out of the tabulated range
+    if (t < m_t_first) return 0._rt;
+    if (t > m_t.back()) {
+        if (!m_end_of_file) Abort("Excitation waveform evaluated before being updated");
+        return 0._rt;
+    }
+    if (t < m_t.front()) {
+        Abort("Something bad has happened with the simulation time");
+    }
+
+    const int n = static_cast<int>(m_t.size());
+    const int idx = static_cast<int>(
+        std::distance(m_t.begin(), std::upper_bound(m_t.begin(), m_t.end(), t)));
+    const int i1 = std::min(std::max(idx, 1), n-1);
+    const int i0 = i1 - 1;
+
+    const amrex::Real h = m_t[i1] - m_t[i0];
+    const amrex::Real s = (t - m_t[i0]) / h;
+    if (!m_is_cubic) {
+        return m_g[i0] + s * (m_g[i1] - m_g[i0]);
+    }
+
+    // Cubic Hermite interpolation, with centered (one-sided at the ends) slopes
+    const amrex::Real slope = (m_g[i1] - m_g[i0]) / h;
+    const amrex::Real m0 = (i0 > 0) ?
+        (m_g[i1] - m_g[i0-1]) / (m_t[i1] - m_t[i0-1]) : slope;
+    const amrex::Real m1 = (i1 < n-1) ?
+        (m_g[i1+1] - m_g[i0]) / (m_t[i1+1] - m_t[i0]) : slope;
+    const amrex::Real s2 = s*s;
+    const amrex::Real s3 = s2*s;
+    return (2._rt*s3 - 3._rt*s2 + 1._rt) * m_g[i0]
+         + (s3 - 2._rt*s2 + s) * h * m0
+         + (-2._rt*s3 + 3._rt*s2) * m_g[i1]
+         + (s3 - s2) * h * m1;
+}
+
+void
+WarpXExcitationWaveforms::FromFileExcitationWaveform::read_next_chunk ()
+{
+    // Keep the last samples, needed to interpolate across the chunk boundary: a new chunk is
+    // read when fewer than n_right samples are after t (see update), so the stencil of t
+    // (i0 and i1 for linear, i0-1 to i1+1 for cubic) starts at most 2 or 3 samples from the end
+    const int n_keep = std::min(static_cast<int>(m_t.size()), m_is_cubic ? 3 : 2);
+    amrex::Vector<amrex::Real> t(m_t.end() - n_keep, m_t.end());
+    amrex::Vector<amrex::Real> g(m_g.end() - n_keep, m_g.end());
+
+    const int n_new = m_chunk_size - n_keep;
+    int n_read = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        n_read = read_samples(n_new, t, g);
+        if (!std::is_sorted(t.begin(), t.end()) ||
+            std::adjacent_find(t.begin(), t.end()) != t.end()) {
+            Abort("Times are not strictly increasing in " + m_file_name);
+        }
+    }
+
+    // Broadcast the new samples
+    ParallelDescriptor::Bcast(&n_read, 1, ParallelDescriptor::IOProcessorNumber());
+    if (n_read < n_new) m_end_of_file = true;
+    t.resize(n_keep + n_read);
+    g.resize(n_keep + n_read);
+    ParallelDescriptor::Bcast(t.dataPtr() + n_keep, n_read,
+        ParallelDescriptor::IOProcessorNumber());
+    ParallelDescriptor::Bcast(g.dataPtr() + n_keep, n_read,
+        ParallelDescriptor::IOProcessorNumber());
+
+    m_t = std::move(t);
+    m_g = std::move(g);
+
+    if (m_end_of_file && m_file.is_open()) m_file.close();
+}
+
+int
+WarpXExcitationWaveforms::FromFileExcitationWaveform::read_samples (
+    int n, amrex::Vector<amrex::Real>& t, amrex::Vector<amrex::Real>& g)
+{
+    int n_read = 0;
+    if (m_is_binary) {
+        n_read = static_cast<int>(std::min(static_cast<long>(n), m_samples_left));
+        amrex::Vector<double> buf(2*n_read);
+        m_file.read(reinterpret_cast<char*>(buf.dataPtr()), 2*n_read*sizeof(double));
+        if (!m_file) Abort("Failed to read samples from " + m_file_name);
+        for (int i = 0; i < n_read; ++i) {
+            t.push_back(static_cast<amrex::Real>(buf[2*i]));
+            g.push_back(static_cast<amrex::Real>(buf[2*i+1]));
+        }
+        m_samples_left -= n_read;
+    }
+    else {
+        std::string line;
+        while (n_read < n && std::getline(m_file, line)) {
+            std::replace(line.begin(), line.end(), ',', ' ');
+            std::istringstream iss(line);
+            double ti, gi;
+            if (!(iss >> ti)) continue; // empty line or comment
+            if (!(iss >> gi)) Abort("Failed to read sample '" + line + "' from " + m_file_name);
+            t.push_back(static_cast<amrex::Real>(ti));
+            g.push_back(static_cast<amrex::Real>(gi));
+            ++n_read;
+        }
+    }
+    return n_read;
+}
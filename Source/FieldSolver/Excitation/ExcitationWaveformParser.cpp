@@ -0,0 +1,32 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "ExcitationWaveforms.H"
+
+#include "Utils/WarpXUtil.H"
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_REAL.H>
+
+#include <string>
+
+using namespace amrex;
+
+void
+WarpXExcitationWaveforms::ParserExcitationWaveform::init (
+    const amrex::ParmParse& pp, const std::string& name)
+{
+    Store_parserString(pp, name + "_excitation_waveform_function(t)",
+                       m_str_waveform_function);
+    m_parser = makeParser(m_str_waveform_function, {"t"});
+    m_waveform = m_parser.compileHost<1>();
+}
+
+amrex::Real
+WarpXExcitationWaveforms::ParserExcitationWaveform::evaluate (amrex::Real t) const
+{
+    return m_waveform(t);
+}
@@ -141,7 +141,7 @@ void FiniteDifferenceSolver::EvolveBCartesian (
         Box const& tbz  = mfi.tilebox(Bfield[2]->ixType().toIntVect());
 
         // Loop over the cells and update the fields
-        amrex::ParallelFor(tbx, tby, tbz,
+        ParallelForPushRegion(mfi.validbox(), tbx, tby, tbz,
 
             [=] AMREX_GPU_DEVICE (int i, int j, int k){
 
@@ -172,7 +172,7 @@ void FiniteDifferenceSolver::EvolveBCartesian (
             Array4<Real> G = Gfield->array(mfi);
 
             // Loop over cells and update G
-            amrex::ParallelFor(tbx, tby, tbz,
+            ParallelForPushRegion(mfi.validbox(), tbx, tby, tbz,
 
                 [=] AMREX_GPU_DEVICE (int i, int j, int k)
                 {
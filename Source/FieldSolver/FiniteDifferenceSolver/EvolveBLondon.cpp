@@ -55,13 +55,14 @@ void FiniteDifferenceSolver::EvolveBLondon (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& /* Venl */,
     std::array< std::unique_ptr<amrex::iMultiFab>, 3 >& /* flag_info_cell */,
     std::array< std::unique_ptr<amrex::LayoutData<FaceInfoBox> >, 3 >& /* borrowing */,
-    int lev, amrex::Real const dt, amrex::Real const penetration_depth ) {
+    int lev, amrex::Real const dt, amrex::Real const penetration_depth,
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& lambdasq_mu0 ) {
 
    // Select algorithm (The choice of algorithm is a runtime option,
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
     amrex::ignore_unused(Bfield, current, Gfield, face_areas,
-                         lev, dt, penetration_depth);
+                         lev, dt, penetration_depth, lambdasq_mu0);
     amrex::Abort("EvolveBLondon: RZ not implemented");
 #else
     if(m_do_nodal or m_fdtd_algo != MaxwellSolverAlgo::ECT){
@@ -70,15 +71,15 @@ void FiniteDifferenceSolver::EvolveBLondon (
 
     if (m_do_nodal) {
 
-        EvolveBLondonCartesian <CartesianNodalAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth);
+        EvolveBLondonCartesian <CartesianNodalAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth, lambdasq_mu0 );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
 
-        EvolveBLondonCartesian <CartesianYeeAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth );
+        EvolveBLondonCartesian <CartesianYeeAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth, lambdasq_mu0 );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
 
-        EvolveBLondonCartesian <CartesianCKCAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth );
+        EvolveBLondonCartesian <CartesianCKCAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth, lambdasq_mu0 );
     } else {
         amrex::Abort("EvolveBLondon: Unknown algorithm");
     }
@@ -93,11 +94,13 @@ void FiniteDifferenceSolver::EvolveBLondonCartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Bfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& current,
     std::unique_ptr<amrex::MultiFab> const& /* Gfield */,
-    int lev, amrex::Real const /* dt */, amrex::Real const penetration_depth ) {
+    int lev, amrex::Real const /* dt */, amrex::Real const penetration_depth,
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& lambdasq_mu0 ) {
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
     amrex::Real const lambdasq_mu0_fac = penetration_depth * penetration_depth * PhysConst::mu0;
-    amrex::Print() << lambdasq_mu0_fac << "\n";
+    // lambda^2 mu0 is stored on the B faces when the penetration depth is spatially varying
+    bool const varying_lambda = (lambdasq_mu0[0] != nullptr);
     // Loop through the grids, and over the tiles within each grid
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
@@ -131,32 +134,65 @@ void FiniteDifferenceSolver::EvolveBLondonCartesian (
         Box const& tbz  = mfi.tilebox(Bfield[2]->ixType().toIntVect());
 
         // Loop over the cells and update the fields
-        amrex::ParallelFor(tbx, tby, tbz,
+        if (varying_lambda) {
+            Array4<Real const> const& lx = lambdasq_mu0[0]->const_array(mfi);
+            Array4<Real const> const& ly = lambdasq_mu0[1]->const_array(mfi);
+            Array4<Real const> const& lz = lambdasq_mu0[2]->const_array(mfi);
 
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+            amrex::ParallelFor(tbx, tby, tbz,
 
-                Bx(i, j, k) =  (T_Algo::UpwardDz(jy, coefs_z, n_coefs_z, i, j, k)
-                             - T_Algo::UpwardDy(jz, coefs_y, n_coefs_y, i, j, k) )
-                             * lambdasq_mu0_fac;
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
 
-            },
+                    Bx(i, j, k) =  (T_Algo::UpwardDz(jy, coefs_z, n_coefs_z, i, j, k)
+                                 - T_Algo::UpwardDy(jz, coefs_y, n_coefs_y, i, j, k) )
+                                 * lx(i, j, k);
 
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                },
 
-                By(i, j, k) = ( T_Algo::UpwardDx(jz, coefs_x, n_coefs_x, i, j, k)
-                             - T_Algo::UpwardDz(jx, coefs_z, n_coefs_z, i, j, k) )
-                              * lambdasq_mu0_fac;
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
 
-            },
+                    By(i, j, k) = ( T_Algo::UpwardDx(jz, coefs_x, n_coefs_x, i, j, k)
+                                 - T_Algo::UpwardDz(jx, coefs_z, n_coefs_z, i, j, k) )
+                                  * ly(i, j, k);
 
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                },
 
-                Bz(i, j, k) = ( T_Algo::UpwardDy(jx, coefs_y, n_coefs_y, i, j, k)
-                             - T_Algo::UpwardDx(jy, coefs_x, n_coefs_x, i, j, k))
-                              * lambdasq_mu0_fac;
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
 
-            }
-        );
+                    Bz(i, j, k) = ( T_Algo::UpwardDy(jx, coefs_y, n_coefs_y, i, j, k)
+                                 - T_Algo::UpwardDx(jy, coefs_x, n_coefs_x, i, j, k))
+                                  * lz(i, j, k);
+
+                }
+            );
+        } else {
+            amrex::ParallelFor(tbx, tby, tbz,
+
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
+
+                    Bx(i, j, k) =  (T_Algo::UpwardDz(jy, coefs_z, n_coefs_z, i, j, k)
+                                 - T_Algo::UpwardDy(jz, coefs_y, n_coefs_y, i, j, k) )
+                                 * lambdasq_mu0_fac;
+
+                },
+
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
+
+                    By(i, j, k) = ( T_Algo::UpwardDx(jz, coefs_x, n_coefs_x, i, j, k)
+                                 - T_Algo::UpwardDz(jx, coefs_z, n_coefs_z, i, j, k) )
+                                  * lambdasq_mu0_fac;
+
+                },
+
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
+
+                    Bz(i, j, k) = ( T_Algo::UpwardDy(jx, coefs_y, n_coefs_y, i, j, k)
+                                 - T_Algo::UpwardDx(jy, coefs_x, n_coefs_x, i, j, k))
+                                  * lambdasq_mu0_fac;
+
+                }
+            );
+        }
 
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
@@ -150,7 +150,7 @@ void FiniteDifferenceSolver::EvolveECartesian (
         Box const& tez  = mfi.tilebox(Efield[2]->ixType().toIntVect());
 
         // Loop over the cells and update the fields
-        amrex::ParallelFor(tex, tey, tez,
+        ParallelForPushRegion(mfi.validbox(), tex, tey, tez,
 
             [=] AMREX_GPU_DEVICE (int i, int j, int k){
 #ifdef AMREX_USE_EB
@@ -197,7 +197,7 @@ void FiniteDifferenceSolver::EvolveECartesian (
             Array4<Real> F = Ffield->array(mfi);
 
             // Loop over the cells and update the fields
-            amrex::ParallelFor(tex, tey, tez,
+            ParallelForPushRegion(mfi.validbox(), tex, tey, tez,
 
                 [=] AMREX_GPU_DEVICE (int i, int j, int k){
                     Ex(i, j, k) += c2 * dt * T_Algo::UpwardDx(F, coefs_x, n_coefs_x, i, j, k);
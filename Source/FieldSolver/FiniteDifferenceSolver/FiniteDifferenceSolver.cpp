@@ -20,6 +20,7 @@
 #endif
 
 #include <AMReX.H>
+#include <AMReX_BoxList.H>
 #include <AMReX_GpuDevice.H>
 #include <AMReX_PODVector.H>
 #include <AMReX_Vector.H>
@@ -98,3 +99,30 @@ FiniteDifferenceSolver::FiniteDifferenceSolver (
     amrex::Gpu::synchronize();
 #endif
 }
+
+std::array<amrex::Box, 2*AMREX_SPACEDIM>
+FiniteDifferenceSolver::PushRegionBoxes (amrex::Box const& tilebox, amrex::Box const& validbox) const
+{
+    std::array<amrex::Box, 2*AMREX_SPACEDIM> boxes;
+    if (m_push_region == PushRegion::All) {
+        boxes[0] = tilebox;
+        return boxes;
+    }
+    // The points of the tilebox whose stencil (of radius one) stays within the valid points
+    const amrex::Box interior =
+        tilebox & amrex::grow(amrex::convert(validbox, tilebox.ixType()), -1);
+    if (m_push_region == PushRegion::Interior) {
+        if (interior.ok()) boxes[0] = interior;
+        return boxes;
+    }
+    if (!interior.ok()) {
+        boxes[0] = tilebox;
+        return boxes;
+    }
+    const amrex::BoxList shell = amrex::boxDiff(tilebox, interior);
+    int ib = 0;
+    for (amrex::Box const& bx : shell) {
+        boxes[ib++] = bx;
+    }
+    return boxes;
+}
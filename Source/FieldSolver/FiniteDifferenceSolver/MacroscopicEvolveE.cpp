@@ -7,6 +7,7 @@
 #   include "FiniteDifferenceAlgorithms/CartesianCKCAlgorithm.H"
 #   include "FiniteDifferenceAlgorithms/FieldAccessorFunctors.H"
 #endif
+#include "FieldSolver/London/London.H"
 #include "MacroscopicProperties/MacroscopicProperties.H"
 #include "Utils/CoarsenIO.H"
 #include "Utils/TextMsg.H"
@@ -44,16 +45,17 @@ void FiniteDifferenceSolver::MacroscopicEvolveE (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& edge_lengths,
     amrex::Real const dt,
-    std::unique_ptr<MacroscopicProperties> const& macroscopic_properties)
+    std::unique_ptr<MacroscopicProperties> const& macroscopic_properties,
+    LondonEdgeLists const* london_edges)
 {
 
    // Select algorithm (The choice of algorithm is a runtime option,
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
 #    ifndef WARPX_MAG_LLG
-    amrex::ignore_unused(Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+    amrex::ignore_unused(Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties, london_edges);
 #    else
-    amrex::ignore_unused(Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties);
+    amrex::ignore_unused(Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties, london_edges);
 #endif
     amrex::Abort(Utils::TextMsg::Err(
         "currently macro E-push does not work for RZ"));
@@ -68,18 +70,18 @@ void FiniteDifferenceSolver::MacroscopicEvolveE (
 
             MacroscopicEvolveECartesian <CartesianYeeAlgorithm, LaxWendroffAlgo>
 #ifndef WARPX_MAG_LLG
-                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties, london_edges);
 #else
-                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties);
+                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties, london_edges);
 #endif
         }
         if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::BackwardEuler) {
 
             MacroscopicEvolveECartesian <CartesianYeeAlgorithm, BackwardEulerAlgo>
 #ifndef WARPX_MAG_LLG
-                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties, london_edges);
 #else
-                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties);
+                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties, london_edges);
 #endif
 
         }
@@ -92,17 +94,17 @@ void FiniteDifferenceSolver::MacroscopicEvolveE (
 
             MacroscopicEvolveECartesian <CartesianCKCAlgorithm, LaxWendroffAlgo>
 #ifndef WARPX_MAG_LLG
-                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties, london_edges);
 #else
-                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties);
+                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties, london_edges);
 #endif
         } else if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::BackwardEuler) {
 
             MacroscopicEvolveECartesian <CartesianCKCAlgorithm, BackwardEulerAlgo>
 #ifndef WARPX_MAG_LLG
-                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties, london_edges);
 #else
-                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties);
+                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties, london_edges);
 #endif
         }
 
@@ -128,7 +130,8 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& edge_lengths,
     amrex::Real const dt,
-    std::unique_ptr<MacroscopicProperties> const& macroscopic_properties)
+    std::unique_ptr<MacroscopicProperties> const& macroscopic_properties,
+    LondonEdgeLists const* london_edges)
 {
 #ifndef AMREX_USE_EB
     amrex::ignore_unused(edge_lengths);
@@ -149,11 +152,17 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
     amrex::GpuArray<int, 3> const& Ey_stag = macroscopic_properties->Ey_IndexType;
     amrex::GpuArray<int, 3> const& Ez_stag = macroscopic_properties->Ez_IndexType;
 
+    // With the fused London update, J^{n+1/2} = J^{n-1/2} + dt/(lambda^2 mu) E^{n} is
+    // computed on the superconducting edges of each box just before its E-update. The
+    // edges are stored per box, hence the boxes are not tiled. When the interior and the
+    // boundary of the boxes are pushed separately, J is only updated before the interior.
+    bool const fuse_london = (london_edges != nullptr) && (m_push_region != PushRegion::Boundary);
+
     // Loop through the grids, and over the tiles within each grid
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-    for ( MFIter mfi(*Efield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+    for ( MFIter mfi(*Efield[0], TilingIfNotGPU() && !fuse_london); mfi.isValid(); ++mfi ) {
 
         // Extract field data for this grid/tile
         Array4<Real> const& Ex = Efield[0]->array(mfi);
@@ -162,6 +171,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
         Array4<Real> const& jx = Jfield[0]->array(mfi);
         Array4<Real> const& jy = Jfield[1]->array(mfi);
         Array4<Real> const& jz = Jfield[2]->array(mfi);
+        if (fuse_london) {
+            London::EvolveLondonJ((*(*london_edges)[0])[mfi], jx, Efield[0]->const_array(mfi), dt);
+            London::EvolveLondonJ((*(*london_edges)[1])[mfi], jy, Efield[1]->const_array(mfi), dt);
+            London::EvolveLondonJ((*(*london_edges)[2])[mfi], jz, Efield[2]->const_array(mfi), dt);
+        }
 #ifndef WARPX_MAG_LLG
         Array4<Real> const& Bx = Bfield[0]->array(mfi);
         Array4<Real> const& By = Bfield[1]->array(mfi);
@@ -209,7 +223,7 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
         // starting component to interpolate macro properties to Ex, Ey, Ez locations
         const int scomp = 0;
         // Loop over the cells and update the fields
-        amrex::ParallelFor(tex, tey, tez,
+        ParallelForPushRegion(mfi.validbox(), tex, tey, tez,
             [=] AMREX_GPU_DEVICE (int i, int j, int k){
 #ifdef AMREX_USE_EB
                 // Skip field push if this cell is fully covered by embedded boundaries
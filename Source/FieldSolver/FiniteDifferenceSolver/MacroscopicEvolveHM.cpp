@@ -67,8 +67,12 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
     int mag_exchange_coupling = warpx.mag_LLG_exchange_coupling;
     int mag_anisotropy_coupling = warpx.mag_LLG_anisotropy_coupling;
 
-    // temporary Multifab storing M from previous timestep (old_time) before updating to M(new_time)
-    std::array<std::unique_ptr<amrex::MultiFab>, 3> Mfield_old; // Mfield_old is M(old_time)
+    // Multifab storing M from previous timestep (old_time) before updating to M(new_time)
+    std::array<std::unique_ptr<amrex::MultiFab>, 3>& Mfield_old = m_Mfield_old; // Mfield_old is M(old_time)
+
+    // M does not read E: with a split push (see SetPushRegion), M is updated in the
+    // Interior push, and only H and B are updated in the Boundary push
+    bool const update_M = (m_push_region != PushRegion::Boundary);
 
     amrex::GpuArray<int, 3> const& mu_stag = macroscopic_properties->mu_IndexType;
     amrex::GpuArray<int, 3> const& Hx_stag = macroscopic_properties->Hx_IndexType;
@@ -80,17 +84,22 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
     amrex::GpuArray<int, 3> const& macro_cr= macroscopic_properties->macro_cr_ratio;
     amrex::GpuArray<amrex::Real, 3> const& anisotropy_axis = macroscopic_properties->mag_LLG_anisotropy_axis;
 
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < 3 && update_M; i++)
     {
-        // Mfield_old is M(n)
-        Mfield_old[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
-        // initialize temporary multifab, Mfield_old, with values from Mfield(old_time)
-        MultiFab::Copy(*Mfield_old[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrow());
+        // Mfield_old is M(n), reallocated only if the grids have changed
+        if (!Mfield_old[i] || Mfield_old[i]->boxArray() != Mfield[i]->boxArray()
+            || Mfield_old[i]->DistributionMap() != Mfield[i]->DistributionMap()
+            || Mfield_old[i]->nGrowVect() != Mfield[i]->nGrowVect()) {
+            Mfield_old[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrowVect()));
+        }
+        // initialize multifab, Mfield_old, with values from Mfield(old_time)
+        MultiFab::Copy(*Mfield_old[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrowVect());
     }
 
     // obtain the maximum relative amount we let M deviate from Ms before aborting
     amrex::Real mag_normalized_error = macroscopic_properties->getmag_normalized_error();
 
+    if (update_M) {
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
@@ -514,9 +523,13 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                 } // end if (mag_Ms_zface_arr(i,j,k)(i,j,k) > 0...
             });
     }
+    } // if (update_M)
 
     amrex::MultiFab& mu_mf = macroscopic_properties->getmu_mf();
     // Update H(new_time) = f(H(old_time), M(new_time), M(old_time), E(old_time))
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
     for (MFIter mfi(*Hfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
         auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
@@ -562,7 +575,7 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
         amrex::Real const mu0_inv = 1. / PhysConst::mu0;
 
         // Loop over the cells and update the fields
-        amrex::ParallelFor(tbx, tby, tbz,
+        ParallelForPushRegion(mfi.validbox(), tbx, tby, tbz,
             [=] AMREX_GPU_DEVICE(int i, int j, int k) {
 
                 if (mag_Ms_xface_arr(i,j,k) == 0._rt){ // nonmagnetic region
@@ -611,6 +624,9 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
     }
 
     // update B
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
     for (MFIter mfi(*Bfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
 
@@ -646,7 +662,7 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
         amrex::Array4<amrex::Real> const& mu_arr = mu_mf.array(mfi);
 
         // Loop over the cells and update the fields
-        amrex::ParallelFor(tbx, tby, tbz,
+        ParallelForPushRegion(mfi.validbox(), tbx, tby, tbz,
 
             [=] AMREX_GPU_DEVICE(int i, int j, int k) {
 
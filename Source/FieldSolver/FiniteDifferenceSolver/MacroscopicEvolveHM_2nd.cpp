@@ -87,25 +87,28 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
 
     // Initialize Hfield_old (H^(old_time)), Mfield_old (M^(old_time)), Mfield_prev (M^[(new_time),r-1]), Mfield_error
     for (int i = 0; i < 3; i++){
-        Hfield_old[i].reset(new MultiFab(Hfield[i]->boxArray(), Hfield[i]->DistributionMap(), 1, Hfield[i]->nGrow()));
-        Mfield_old[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
-        Mfield_prev[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
-        Mfield_error[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
+        Hfield_old[i].reset(new MultiFab(Hfield[i]->boxArray(), Hfield[i]->DistributionMap(), 1, Hfield[i]->nGrowVect()));
+        Mfield_old[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrowVect()));
+        Mfield_prev[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrowVect()));
+        Mfield_error[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrowVect()));
         Mfield_error[i]->setVal(0.); // reset Mfield_error to zero
-        MultiFab::Copy(*Hfield_old[i], *Hfield[i], 0, 0, 1, Hfield[i]->nGrow());
-        MultiFab::Copy(*Mfield_old[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrow());
-        MultiFab::Copy(*Mfield_prev[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrow());
+        MultiFab::Copy(*Hfield_old[i], *Hfield[i], 0, 0, 1, Hfield[i]->nGrowVect());
+        MultiFab::Copy(*Mfield_old[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrowVect());
+        MultiFab::Copy(*Mfield_prev[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrowVect());
     }
     // initialize a_temp, a_temp_static, b_temp_static
     for (int i = 0; i < 3; i++){
-        a_temp[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
-        a_temp_static[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
-        b_temp_static[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
+        a_temp[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrowVect()));
+        a_temp_static[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrowVect()));
+        b_temp_static[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrowVect()));
     }
 
     amrex::MultiFab& mu_mf = macroscopic_properties->getmu_mf();
 
     // calculate the b_temp_static, a_temp_static
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
     for (MFIter mfi(*a_temp_static[0], TilingIfNotGPU()); mfi.isValid(); ++mfi) {
 
         auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
@@ -443,8 +446,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
     // begin the iteration
     while (!stop_iter){
 
-        warpx.FillBoundaryH(warpx.getngEB());
+        warpx.FillBoundaryH(warpx.getngH());
 
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
         for (MFIter mfi(*Mfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi){
 
             auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
@@ -877,6 +883,9 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
         }
 
         // update H
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
         for (MFIter mfi(*Hfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi){
 
             auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
@@ -994,6 +1003,9 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
             // normalize M
             if (M_normalization == 2){
 
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
                 for (MFIter mfi(*Mfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi){
 
                     auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
@@ -1086,7 +1098,7 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
             const auto& period = warpx.Geom(lev).periodicity();
             // Copy Mfield to Mfield_previous and fill periodic/interior ghost cells
             for (int i = 0; i < 3; i++){
-                MultiFab::Copy(*Mfield_prev[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrow());
+                MultiFab::Copy(*Mfield_prev[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrowVect());
                 (*Mfield_prev[i]).FillBoundary(Mfield[i]->nGrowVect(), period);
             }
         }
@@ -1103,6 +1115,9 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
     } // end the iteration
 
     // update B
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
     for (MFIter mfi(*Bfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi){
 
         auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
@@ -1,6 +1,9 @@
 #include "MacroscopicProperties.H"
 
+#include "Parallelization/ThreadPlacement.H"
 #include "Utils/TextMsg.H"
+#include "Utils/VoxelMaterialMap.H"
+#include "Utils/WarpXProfilerWrapper.H"
 #include "Utils/WarpXUtil.H"
 #include "WarpX.H"
 
@@ -13,15 +16,21 @@
 #include <AMReX_IndexType.H>
 #include <AMReX_IntVect.H>
 #include <AMReX_MFIter.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Print.H>
 #include <AMReX_RealBox.H>
 #include <AMReX_Parser.H>
+#include <AMReX_Utility.H>
 
 #include <AMReX_BaseFwd.H>
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <sstream>
+#include <string>
+#include <utility>
 
 using namespace amrex;
 
@@ -39,6 +48,14 @@ MacroscopicProperties::ReadParameters ()
     // The vacuum values are used as default for the macroscopic parameters
     // with a warning message to the user to indicate that no value was specified.
 
+    // With macroscopic.use_material_map, the properties given per material in the
+    // voxel material map replace the constant values and the parser functions.
+    // The constant value is then used for the materials that do not define the property.
+    int use_material_map = 0;
+    pp_macroscopic.query("use_material_map", use_material_map);
+    auto from_material_map = [use_material_map] (std::string const& property) -> bool {
+        return use_material_map && WarpX::GetInstance().GetMaterialMap().DefinesProperty(property);
+    };
 
     // Query input for material conductivity, sigma.
     bool sigma_specified = false;
@@ -50,6 +67,10 @@ MacroscopicProperties::ReadParameters ()
         m_sigma_s = "parse_sigma_function";
         sigma_specified = true;
     }
+    if (from_material_map("sigma")) {
+        m_sigma_s = "material_map";
+        sigma_specified = true;
+    }
     if (!sigma_specified) {
         std::stringstream warnMsg;
         warnMsg << "Material conductivity is not specified. Using default vacuum value of " <<
@@ -73,6 +94,10 @@ MacroscopicProperties::ReadParameters ()
         m_epsilon_s = "parse_epsilon_function";
         epsilon_specified = true;
     }
+    if (from_material_map("epsilon")) {
+        m_epsilon_s = "material_map";
+        epsilon_specified = true;
+    }
     if (!epsilon_specified) {
         std::stringstream warnMsg;
         warnMsg << "Material permittivity is not specified. Using default vacuum value of " <<
@@ -98,6 +123,10 @@ MacroscopicProperties::ReadParameters ()
         m_mu_s = "parse_mu_function";
         mu_specified = true;
     }
+    if (from_material_map("mu")) {
+        m_mu_s = "material_map";
+        mu_specified = true;
+    }
     if (!mu_specified) {
         std::stringstream warnMsg;
         warnMsg << "Material permittivity is not specified. Using default vacuum value of " <<
@@ -208,38 +237,7 @@ MacroscopicProperties::InitData ()
     // mu is cell-centered MultiFab
     m_mu_mf = std::make_unique<amrex::MultiFab>(ba, dmap, 1, ng_EB_alloc);
 
-    // Initialize sigma
-    if (m_sigma_s == "constant") {
-
-        m_sigma_mf->setVal(m_sigma);
-
-    } else if (m_sigma_s == "parse_sigma_function") {
-
-        InitializeMacroMultiFabUsingParser(m_sigma_mf.get(), m_sigma_parser->compile<3>(), lev);
-    }
-    // Initialize epsilon
-    if (m_epsilon_s == "constant") {
-
-        m_eps_mf->setVal(m_epsilon);
-
-    } else if (m_epsilon_s == "parse_epsilon_function") {
-
-        InitializeMacroMultiFabUsingParser(m_eps_mf.get(), m_epsilon_parser->compile<3>(), lev);
-
-    }
-
-    // Initialize mu
-    if (m_mu_s == "constant") {
-
-        m_mu_mf->setVal(m_mu);
-
-    } else if (m_mu_s == "parse_mu_function") {
-
-        InitializeMacroMultiFabUsingParser(m_mu_mf.get(), m_mu_parser->compile<3>(), lev);
-
-    }
 #ifdef WARPX_MAG_LLG
-
     // all magnetic macroparameters are stored on faces
     for (int i=0; i<3; ++i) {
         m_mag_Ms_mf[i]         = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
@@ -248,91 +246,26 @@ MacroscopicProperties::InitData ()
         m_mag_exchange_mf[i]   = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
         m_mag_anisotropy_mf[i] = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
     }
+#endif
 
-    // mag_Ms - defined at cell centers
-    if (m_mag_Ms_s == "constant") {
-        m_mag_Ms_mf[0]->setVal(m_mag_Ms);
-        m_mag_Ms_mf[1]->setVal(m_mag_Ms);
-        m_mag_Ms_mf[2]->setVal(m_mag_Ms);
-    }
-    else if (m_mag_Ms_s == "parse_mag_Ms_function"){
-        InitializeMacroMultiFabUsingParser(m_mag_Ms_mf[0].get(), m_mag_Ms_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_Ms_mf[1].get(), m_mag_Ms_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_Ms_mf[2].get(), m_mag_Ms_parser->compile<3>(), lev);
-    }
-    // if there are regions with Ms=0, the user must provide mur value there
-    for (int i=0; i<3; ++i) {
-        if (m_mag_Ms_mf[i]->min(0,m_mag_Ms_mf[i]->nGrow()) < 0._rt){
-            amrex::Abort("Ms must be non-negative values");
-        }
-    }
-    for (int i=0; i<3; ++i) {
-        if (m_mag_Ms_mf[i]->min(0,m_mag_Ms_mf[i]->nGrow()) == 0._rt){
-            if (m_mu_s != "constant" && m_mu_s != "parse_mu_function"){
-                amrex::Abort("permeability must be specified since part of the simulation domain is non-magnetic !");
-            }
-        }
-    }
-
-    // mag_alpha - defined at faces
-    if (m_mag_alpha_s == "constant") {
-        m_mag_alpha_mf[0]->setVal(m_mag_alpha);
-        m_mag_alpha_mf[1]->setVal(m_mag_alpha);
-        m_mag_alpha_mf[2]->setVal(m_mag_alpha);
-    }
-    else if (m_mag_alpha_s == "parse_mag_alpha_function"){
-        InitializeMacroMultiFabUsingParser(m_mag_alpha_mf[0].get(), m_mag_alpha_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_alpha_mf[1].get(), m_mag_alpha_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_alpha_mf[2].get(), m_mag_alpha_parser->compile<3>(), lev);
-    }
-    for (int i=0; i<3; ++i) {
-        if (m_mag_alpha_mf[i]->min(0,m_mag_alpha_mf[i]->nGrow()) < 0._rt) {
-            amrex::Abort("alpha should be positive, but the user input has negative values");
+#ifndef AMREX_USE_GPU
+    if (WarpX::do_numa_first_touch) {
+        // The material map and the checkpoint reader fill each box with a single thread
+        for (auto& static_mf : GetStaticMultiFabs()) {
+            ThreadPlacement::FirstTouch(*static_mf.second);
         }
     }
+#endif
 
-    // mag_gamma - defined at faces
-    if (m_mag_gamma_s == "constant") {
-        m_mag_gamma_mf[0]->setVal(m_mag_gamma);
-        m_mag_gamma_mf[1]->setVal(m_mag_gamma);
-        m_mag_gamma_mf[2]->setVal(m_mag_gamma);
-    }
-    else if (m_mag_gamma_s == "parse_mag_gamma_function"){
-        InitializeMacroMultiFabUsingParser(m_mag_gamma_mf[0].get(), m_mag_gamma_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_gamma_mf[1].get(), m_mag_gamma_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_gamma_mf[2].get(), m_mag_gamma_parser->compile<3>(), lev);
-    }
-    for (int i=0; i<3; ++i) {
-        if (m_mag_gamma_mf[i]->min(0,m_mag_gamma_mf[i]->nGrow()) > 0._rt) {
-            amrex::Abort("gamma should be negative, but the user input has positive values");
+    if (warpx.RestartStaticDataDir().empty()) {
+        InitializeFromInput(lev);
+    } else {
+        // Restart from a checkpoint whose static part contains the properties
+        for (auto& static_mf : GetStaticMultiFabs()) {
+            warpx.ReadStaticData(*static_mf.second, lev, static_mf.first);
         }
     }
 
-    // mag_exchange - defined at faces
-    if (m_mag_exchange_s == "constant") {
-        m_mag_exchange_mf[0]->setVal(m_mag_exchange);
-        m_mag_exchange_mf[1]->setVal(m_mag_exchange);
-        m_mag_exchange_mf[2]->setVal(m_mag_exchange);
-    }
-    else if (m_mag_exchange_s == "parse_mag_exchange_function"){
-        InitializeMacroMultiFabUsingParser(m_mag_exchange_mf[0].get(), m_mag_exchange_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_exchange_mf[1].get(), m_mag_exchange_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_exchange_mf[2].get(), m_mag_exchange_parser->compile<3>(), lev);
-    }
-
-    // mag_anisotropy - defined at faces
-    if (m_mag_anisotropy_s == "constant") {
-        m_mag_anisotropy_mf[0]->setVal(m_mag_anisotropy);
-        m_mag_anisotropy_mf[1]->setVal(m_mag_anisotropy);
-        m_mag_anisotropy_mf[2]->setVal(m_mag_anisotropy);
-    }
-    else if (m_mag_anisotropy_s == "parse_mag_anisotropy_function"){
-        InitializeMacroMultiFabUsingParser(m_mag_anisotropy_mf[0].get(), m_mag_anisotropy_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_anisotropy_mf[1].get(), m_mag_anisotropy_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_anisotropy_mf[2].get(), m_mag_anisotropy_parser->compile<3>(), lev);
-    }
-#endif
-
 
     amrex::IntVect sigma_stag = m_sigma_mf->ixType().toIntVect();
     amrex::IntVect epsilon_stag = m_eps_mf->ixType().toIntVect();
@@ -395,39 +328,213 @@ MacroscopicProperties::InitData ()
 #endif
 }
 
+void
+MacroscopicProperties::InitializeFromInput (int lev)
+{
+    WARPX_PROFILE("MacroscopicProperties::InitializeFromInput()");
+    auto & warpx = WarpX::GetInstance();
+    const auto t_start = static_cast<amrex::Real>(amrex::second());
+
+    // The properties given by functions of (x,y,z) are evaluated together, in one pass over
+    // the points of each index type: the cell-centered sigma, epsilon and mu, and with LLG
+    // the magnetic properties on each of the three faces.
+    amrex::Vector<std::pair<amrex::MultiFab*, amrex::ParserExecutor<3>>> cc_parsers;
+    // Likewise, the properties given by the material map are filled together, the material
+    // ids being sampled once per box and index type
+    amrex::Vector<std::pair<amrex::MultiFab*, amrex::Vector<amrex::Real>>> map_fields;
+
+    // Initialize sigma
+    if (m_sigma_s == "constant") {
+
+        m_sigma_mf->setVal(m_sigma);
+
+    } else if (m_sigma_s == "parse_sigma_function") {
+
+        cc_parsers.emplace_back(m_sigma_mf.get(), m_sigma_parser->compile<3>());
+    } else if (m_sigma_s == "material_map") {
+
+        map_fields.emplace_back(m_sigma_mf.get(), warpx.GetMaterialMap().MaterialValues("sigma", m_sigma));
+    }
+    // Initialize epsilon
+    if (m_epsilon_s == "constant") {
+
+        m_eps_mf->setVal(m_epsilon);
+
+    } else if (m_epsilon_s == "parse_epsilon_function") {
+
+        cc_parsers.emplace_back(m_eps_mf.get(), m_epsilon_parser->compile<3>());
+
+    } else if (m_epsilon_s == "material_map") {
+
+        map_fields.emplace_back(m_eps_mf.get(), warpx.GetMaterialMap().MaterialValues("epsilon", m_epsilon));
+
+    }
+
+    // Initialize mu
+    if (m_mu_s == "constant") {
+
+        m_mu_mf->setVal(m_mu);
+
+    } else if (m_mu_s == "parse_mu_function") {
+
+        cc_parsers.emplace_back(m_mu_mf.get(), m_mu_parser->compile<3>());
+
+    } else if (m_mu_s == "material_map") {
+
+        map_fields.emplace_back(m_mu_mf.get(), warpx.GetMaterialMap().MaterialValues("mu", m_mu));
+
+    }
+    InitializeMacroMultiFabsUsingParsers(cc_parsers, lev);
+    if (!map_fields.empty()) warpx.GetMaterialMap().Fill(map_fields, lev);
+    map_fields.clear();
+
+#ifdef WARPX_MAG_LLG
+    // all magnetic macroparameters are stored on faces, and each parser is compiled
+    // once and evaluated on the three faces
+    std::array<amrex::Vector<std::pair<amrex::MultiFab*, amrex::ParserExecutor<3>>>, 3> face_parsers;
+    auto init_mag_property = [&] (std::string const& name, std::string const& style, amrex::Real value,
+                                  std::unique_ptr<amrex::Parser> const& parser,
+                                  std::array<std::unique_ptr<amrex::MultiFab>, 3> const& mag_mf) {
+        if (style == "constant") {
+            for (int i=0; i<3; ++i) mag_mf[i]->setVal(value);
+        } else if (style == "parse_mag_" + name + "_function") {
+            const amrex::ParserExecutor<3> mag_parser = parser->compile<3>();
+            for (int i=0; i<3; ++i) face_parsers[i].emplace_back(mag_mf[i].get(), mag_parser);
+        } else if (style == "material_map") {
+            const auto values = warpx.GetMaterialMap().MaterialValues("mag_" + name, 0._rt);
+            for (int i=0; i<3; ++i) map_fields.emplace_back(mag_mf[i].get(), values);
+        }
+    };
+    init_mag_property("Ms", m_mag_Ms_s, m_mag_Ms, m_mag_Ms_parser, m_mag_Ms_mf);
+    init_mag_property("alpha", m_mag_alpha_s, m_mag_alpha, m_mag_alpha_parser, m_mag_alpha_mf);
+    init_mag_property("gamma", m_mag_gamma_s, m_mag_gamma, m_mag_gamma_parser, m_mag_gamma_mf);
+    init_mag_property("exchange", m_mag_exchange_s, m_mag_exchange, m_mag_exchange_parser, m_mag_exchange_mf);
+    init_mag_property("anisotropy", m_mag_anisotropy_s, m_mag_anisotropy, m_mag_anisotropy_parser, m_mag_anisotropy_mf);
+    for (int i=0; i<3; ++i) {
+        InitializeMacroMultiFabsUsingParsers(face_parsers[i], lev);
+    }
+    if (!map_fields.empty()) warpx.GetMaterialMap().Fill(map_fields, lev);
+
+    // if there are regions with Ms=0, the user must provide mur value there
+    for (int i=0; i<3; ++i) {
+        if (m_mag_Ms_mf[i]->min(0,m_mag_Ms_mf[i]->nGrow()) < 0._rt){
+            amrex::Abort("Ms must be non-negative values");
+        }
+    }
+    for (int i=0; i<3; ++i) {
+        if (m_mag_Ms_mf[i]->min(0,m_mag_Ms_mf[i]->nGrow()) == 0._rt){
+            if (m_mu_s != "constant" && m_mu_s != "parse_mu_function" && m_mu_s != "material_map"){
+                amrex::Abort("permeability must be specified since part of the simulation domain is non-magnetic !");
+            }
+        }
+    }
+    for (int i=0; i<3; ++i) {
+        if (m_mag_alpha_mf[i]->min(0,m_mag_alpha_mf[i]->nGrow()) < 0._rt) {
+            amrex::Abort("alpha should be positive, but the user input has negative values");
+        }
+    }
+    for (int i=0; i<3; ++i) {
+        if (m_mag_gamma_mf[i]->min(0,m_mag_gamma_mf[i]->nGrow()) > 0._rt) {
+            amrex::Abort("gamma should be negative, but the user input has positive values");
+        }
+    }
+#endif
+
+    if (warpx.Verbose()) {
+        auto t_init = static_cast<amrex::Real>(amrex::second()) - t_start;
+        amrex::ParallelDescriptor::ReduceRealMax(t_init, amrex::ParallelDescriptor::IOProcessorNumber());
+        amrex::Print() << "Material properties init time  : " << t_init << '\n';
+    }
+}
+
+amrex::Vector<std::pair<std::string, amrex::MultiFab*>>
+MacroscopicProperties::GetStaticMultiFabs ()
+{
+    amrex::Vector<std::pair<std::string, amrex::MultiFab*>> static_mfs = {
+        {"sigma", m_sigma_mf.get()},
+        {"epsilon", m_eps_mf.get()},
+        {"mu", m_mu_mf.get()}
+    };
+#ifdef WARPX_MAG_LLG
+    const std::array<std::string, 3> dir_names = {"x", "y", "z"};
+    for (int i=0; i<3; ++i) {
+        static_mfs.emplace_back("mag_Ms_" + dir_names[i], m_mag_Ms_mf[i].get());
+        static_mfs.emplace_back("mag_alpha_" + dir_names[i], m_mag_alpha_mf[i].get());
+        static_mfs.emplace_back("mag_gamma_" + dir_names[i], m_mag_gamma_mf[i].get());
+        static_mfs.emplace_back("mag_exchange_" + dir_names[i], m_mag_exchange_mf[i].get());
+        static_mfs.emplace_back("mag_anisotropy_" + dir_names[i], m_mag_anisotropy_mf[i].get());
+    }
+#endif
+    return static_mfs;
+}
+
 void
 MacroscopicProperties::InitializeMacroMultiFabUsingParser (
                        amrex::MultiFab *macro_mf,
                        amrex::ParserExecutor<3> const& macro_parser,
                        const int lev)
 {
+    InitializeMacroMultiFabsUsingParsers({{macro_mf, macro_parser}}, lev);
+}
+
+void
+MacroscopicProperties::InitializeMacroMultiFabsUsingParsers (
+    amrex::Vector<std::pair<amrex::MultiFab*, amrex::ParserExecutor<3>>> const& macro_parsers,
+    const int lev)
+{
+    WARPX_PROFILE("MacroscopicProperties::InitializeMacroMultiFabsUsingParsers()");
+
     WarpX& warpx = WarpX::GetInstance();
     const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx_lev = warpx.Geom(lev).CellSizeArray();
     const amrex::RealBox& real_box = warpx.Geom(lev).ProbDomain();
-    amrex::IntVect iv = macro_mf->ixType().toIntVect();
-    for ( amrex::MFIter mfi(*macro_mf, TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
-        // Initialize ghost cells in addition to valid cells
-
-        const amrex::Box& tb = mfi.tilebox( iv, macro_mf->nGrowVect());
-        amrex::Array4<amrex::Real> const& macro_fab =  macro_mf->array(mfi);
-        amrex::ParallelFor (tb,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                // Shift x, y, z position based on index type
-                amrex::Real fac_x = (1._rt - iv[0]) * dx_lev[0] * 0.5_rt;
-                amrex::Real x = i * dx_lev[0] + real_box.lo(0) + fac_x;
+
+    const int nparsers_total = static_cast<int>(macro_parsers.size());
+    for (int first = 0; first < nparsers_total; first += max_fused_parsers) {
+        const int nparsers = std::min(max_fused_parsers, nparsers_total - first);
+        amrex::MultiFab* const mf0 = macro_parsers[first].first;
+        amrex::GpuArray<amrex::ParserExecutor<3>, max_fused_parsers> parsers;
+        for (int p = 0; p < nparsers; ++p) {
+            amrex::MultiFab const* const mf = macro_parsers[first+p].first;
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+                mf->ixType() == mf0->ixType() && mf->boxArray() == mf0->boxArray() &&
+                mf->DistributionMap() == mf0->DistributionMap() && mf->nGrowVect() == mf0->nGrowVect(),
+                "The MultiFabs initialized together must have the same layout");
+            parsers[p] = macro_parsers[first+p].second;
+        }
+
+        amrex::IntVect iv = mf0->ixType().toIntVect();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for ( amrex::MFIter mfi(*mf0, TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+            // Initialize ghost cells in addition to valid cells
+
+            const amrex::Box& tb = mfi.tilebox( iv, mf0->nGrowVect());
+            amrex::GpuArray<amrex::Array4<amrex::Real>, max_fused_parsers> macro_fabs;
+            for (int p = 0; p < nparsers; ++p) {
+                macro_fabs[p] = macro_parsers[first+p].first->array(mfi);
+            }
+            amrex::ParallelFor (tb,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                    // Shift x, y, z position based on index type
+                    amrex::Real fac_x = (1._rt - iv[0]) * dx_lev[0] * 0.5_rt;
+                    amrex::Real x = i * dx_lev[0] + real_box.lo(0) + fac_x;
 #if defined(WARPX_DIM_XZ) || defined(WARPX_DIM_RZ)
-                amrex::Real y = 0._rt;
-                amrex::Real fac_z = (1._rt - iv[1]) * dx_lev[1] * 0.5_rt;
-                amrex::Real z = j * dx_lev[1] + real_box.lo(1) + fac_z;
+                    amrex::Real y = 0._rt;
+                    amrex::Real fac_z = (1._rt - iv[1]) * dx_lev[1] * 0.5_rt;
+                    amrex::Real z = j * dx_lev[1] + real_box.lo(1) + fac_z;
 #else
-                amrex::Real fac_y = (1._rt - iv[1]) * dx_lev[1] * 0.5_rt;
-                amrex::Real y = j * dx_lev[1] + real_box.lo(1) + fac_y;
-                amrex::Real fac_z = (1._rt - iv[2]) * dx_lev[2] * 0.5_rt;
-                amrex::Real z = k * dx_lev[2] + real_box.lo(2) + fac_z;
+                    amrex::Real fac_y = (1._rt - iv[1]) * dx_lev[1] * 0.5_rt;
+                    amrex::Real y = j * dx_lev[1] + real_box.lo(1) + fac_y;
+                    amrex::Real fac_z = (1._rt - iv[2]) * dx_lev[2] * 0.5_rt;
+                    amrex::Real z = k * dx_lev[2] + real_box.lo(2) + fac_z;
 #endif
-                // initialize the macroparameter
-                macro_fab(i,j,k) = macro_parser(x,y,z);
-        });
+                    // initialize the macroparameters, with the position computed once
+                    for (int p = 0; p < nparsers; ++p) {
+                        macro_fabs[p](i,j,k) = parsers[p](x,y,z);
+                    }
+            });
 
+        }
     }
 }
@@ -1,5 +1,10 @@
 #include "London.H"
 #include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#include "Utils/TextMsg.H"
+#include "Utils/VoxelMaterialMap.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXProfilerWrapper.H"
 #include "Utils/WarpXUtil.H"
 #include "Utils/CoarsenIO.H"
 #include "WarpX.H"
@@ -9,7 +14,6 @@
 #include <AMReX_REAL.H>
 #include <AMReX_GpuQualifiers.H>
 #include <AMReX_MultiFab.H>
-#include <AMReX_iMultiFab.H>
 #include <AMReX_Scan.H>
 
 #include <AMReX_BaseFwd.H>
@@ -19,149 +23,293 @@
 
 London::London ()
 {
-    amrex::Print() << " London class is constructed\n";
     ReadParameters();
+
+    const int nlevs_max = WarpX::GetInstance().maxLevel() + 1;
+    m_edges.resize(nlevs_max);
+    m_lambdasq_mu0_mf.resize(nlevs_max);
+    m_is_built.resize(nlevs_max, 0);
 }
 
 void
 London::ReadParameters ()
 {
+    using namespace amrex::literals;
+
     amrex::ParmParse pp_london("london");
-    pp_london.get("penetration_depth", m_penetration_depth);
 
-    Store_parserString(pp_london, "superconductor_function(x,y,z)", m_str_superconductor_function);
-    m_superconductor_parser = std::make_unique<amrex::Parser>(
-                                   makeParser(m_str_superconductor_function, {"x", "y", "z"}));
+    // The penetration depth is either a constant or a function of (x,y,z),
+    // to model superconducting regions made of different materials.
+    bool penetration_depth_specified = false;
+    m_penetration_depth = 0._rt;
+    if (queryWithParser(pp_london, "penetration_depth", m_penetration_depth)) {
+        m_penetration_depth_s = "constant";
+        penetration_depth_specified = true;
+    }
+    if (pp_london.query("penetration_depth_function(x,y,z)", m_str_penetration_depth_function)) {
+        m_penetration_depth_s = "parse_penetration_depth_function";
+        penetration_depth_specified = true;
+    }
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(penetration_depth_specified,
+        "london.penetration_depth or london.penetration_depth_function(x,y,z) must be specified");
+    if (m_penetration_depth_s == "parse_penetration_depth_function") {
+        Store_parserString(pp_london, "penetration_depth_function(x,y,z)", m_str_penetration_depth_function);
+        m_penetration_depth_parser = std::make_unique<amrex::Parser>(
+                                   makeParser(m_str_penetration_depth_function, {"x", "y", "z"}));
+    }
+
+    pp_london.query("fused_update", m_fused_update);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_fused_update == 0 || WarpX::em_solver_medium == MediumForEM::Macroscopic,
+        "london.fused_update requires algo.em_solver_medium = macroscopic");
+
+    // The superconducting region is either given by material_map.<material>.superconductor
+    // (0 or 1) in the voxel material map, or by a function of (x,y,z)
+    pp_london.query("use_material_map", m_use_material_map);
+    if (m_use_material_map) {
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+            WarpX::GetInstance().GetMaterialMap().DefinesProperty("superconductor"),
+            "london.use_material_map requires material_map.<material>.superconductor for some material");
+    } else {
+        Store_parserString(pp_london, "superconductor_function(x,y,z)", m_str_superconductor_function);
+        m_superconductor_parser = std::make_unique<amrex::Parser>(
+                                       makeParser(m_str_superconductor_function, {"x", "y", "z"}));
+    }
 }
 
 void
 London::InitData()
 {
     auto& warpx = WarpX::GetInstance();
-
-    const int lev = 0;
-    amrex::BoxArray ba = warpx.boxArray(lev);
-    amrex::DistributionMapping dmap = warpx.DistributionMap(lev);
-    // number of guard cells used in EB solver
-    const amrex::IntVect ng_EB_alloc = warpx.getngEB();
-    // Define a nodal multifab to store if region is on super conductor (1) or not (0)
-    const amrex::IntVect nodal_flag = amrex::IntVect::TheNodeVector();
-    const int ncomps = 1;
-    m_superconductor_mf = std::make_unique<amrex::MultiFab>(amrex::convert(ba,nodal_flag), dmap, ncomps, ng_EB_alloc);
-
-    InitializeSuperconductorMultiFabUsingParser(m_superconductor_mf.get(), m_superconductor_parser->compile<3>(), lev);
-
-    amrex::IntVect jx_stag = warpx.get_pointer_current_fp(lev,0)->ixType().toIntVect();
-    amrex::IntVect jy_stag = warpx.get_pointer_current_fp(lev,1)->ixType().toIntVect();
-    amrex::IntVect jz_stag = warpx.get_pointer_current_fp(lev,2)->ixType().toIntVect();
-
-    for ( int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-        jx_IndexType[idim]      = jx_stag[idim];
-        jy_IndexType[idim]      = jy_stag[idim];
-        jz_IndexType[idim]      = jz_stag[idim];
+    for (int lev = 0; lev <= warpx.finestLevel(); ++lev) {
+        Build(lev);
     }
-
 }
 
 void
-London::EvolveLondonJ (amrex::Real dt)
+London::Build (int lev)
 {
-    amrex::Print() << " evolve london J using E\n";
-    auto & warpx = WarpX::GetInstance();
-    const int lev = 0;
+    WARPX_PROFILE("London::Build()");
+    using namespace amrex::literals;
 
-    amrex::MultiFab * jx = warpx.get_pointer_current_fp(lev, 0);
-    amrex::MultiFab * jy = warpx.get_pointer_current_fp(lev, 1);
-    amrex::MultiFab * jz = warpx.get_pointer_current_fp(lev, 2);
+    auto& warpx = WarpX::GetInstance();
+    const amrex::BoxArray& ba = warpx.boxArray(lev);
+    const amrex::DistributionMapping& dmap = warpx.DistributionMap(lev);
+    const auto problo = warpx.Geom(lev).ProbLoArray();
+    const auto dx = warpx.Geom(lev).CellSizeArray();
 
-    amrex::MultiFab * Ex = warpx.get_pointer_Efield_fp(lev, 0);
-    amrex::MultiFab * Ey = warpx.get_pointer_Efield_fp(lev, 1);
-    amrex::MultiFab * Ez = warpx.get_pointer_Efield_fp(lev, 2);
+    // The superconductor region is only needed on the nodes of the valid J edges,
+    // while the edges are gathered
+    amrex::MultiFab sc_mf(amrex::convert(ba, amrex::IntVect::TheNodeVector()), dmap, 1, 0);
+    FillSuperconductor(sc_mf, lev);
 
-    MacroscopicProperties &macroscopic = warpx.GetMacroscopicProperties();
-    amrex::MultiFab& mu_mf = macroscopic.getmu_mf();
-    amrex::GpuArray<int, 3> const& mu_stag = macroscopic.mu_IndexType;
-    amrex::GpuArray<int, 3> const& jx_stag = jx_IndexType;
-    amrex::GpuArray<int, 3> const& jy_stag = jy_IndexType;
-    amrex::GpuArray<int, 3> const& jz_stag = jz_IndexType;
-    amrex::GpuArray<int, 3> const& macro_cr     = macroscopic.macro_cr_ratio;
+    // Penetration depth, either constant or evaluated at the edge location
+    const bool lambda_is_constant = (m_penetration_depth_s == "constant");
+    const amrex::Real lambda_const = m_penetration_depth;
+    amrex::ParserExecutor<3> lambda_parser;
+    if (!lambda_is_constant) lambda_parser = m_penetration_depth_parser->compile<3>();
 
-    // evolve J  = 1/( (lambda*lambda) * mu) * E * dt
+    // Permeability: on level 0 the macroscopic mu multifab is interpolated to the edges,
+    // as done in the macroscopic E update. On finer levels, where the macroscopic multifabs
+    // are not defined, mu is evaluated from the user input directly at the edge location.
+    bool mu_from_mf = false;
+    bool mu_is_constant = true;
+    amrex::Real mu_const = PhysConst::mu0;
+    amrex::ParserExecutor<3> mu_parser;
+    amrex::MultiFab* mu_mf = nullptr;
+    amrex::GpuArray<int, 3> mu_stag{0, 0, 0};
+    amrex::GpuArray<int, 3> macro_cr{1, 1, 1};
+    if (WarpX::em_solver_medium == MediumForEM::Macroscopic) {
+        MacroscopicProperties &macroscopic = warpx.GetMacroscopicProperties();
+        if (lev == 0) {
+            mu_from_mf = true;
+            mu_mf = macroscopic.get_pointer_mu();
+            mu_stag = macroscopic.mu_IndexType;
+            macro_cr = macroscopic.macro_cr_ratio;
+        } else if (macroscopic.m_mu_s == "constant") {
+            mu_const = macroscopic.m_mu;
+        } else {
+            mu_is_constant = false;
+            mu_parser = macroscopic.m_mu_parser->compile<3>();
+        }
+    }
 
-    amrex::Real lambda_sq_inv = 1.0/(m_penetration_depth*m_penetration_depth);
     const int scomp = 0;
-    for (amrex::MFIter mfi(*jx, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-        //Extract field data
-        amrex::Array4<amrex::Real> const& jx_arr = jx->array(mfi);
-        amrex::Array4<amrex::Real> const& jy_arr = jy->array(mfi);
-        amrex::Array4<amrex::Real> const& jz_arr = jz->array(mfi);
-        amrex::Array4<amrex::Real> const& Ex_arr = Ex->array(mfi);
-        amrex::Array4<amrex::Real> const& Ey_arr = Ey->array(mfi);
-        amrex::Array4<amrex::Real> const& Ez_arr = Ez->array(mfi);
-        amrex::Array4<amrex::Real> const& mu_arr = mu_mf.array(mfi);
-        amrex::Array4<amrex::Real> const& sc_arr = m_superconductor_mf->array(mfi);
-        amrex::Box const& tjx = mfi.tilebox(jx->ixType().toIntVect());
-        amrex::Box const& tjy = mfi.tilebox(jy->ixType().toIntVect());
-        amrex::Box const& tjz = mfi.tilebox(jz->ixType().toIntVect());
-
-
-    amrex::ParallelFor(tjx, tjy, tjz,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-            if (sc_arr(i,j,k)==1 and sc_arr(i+1,j,k)==1) {
-                amrex::Real const mu_interp = CoarsenIO::Interp(mu_arr, mu_stag, jx_stag,
-                                                                macro_cr, i, j, k, scomp);
-                jx_arr(i,j,k) += dt * lambda_sq_inv/mu_interp * Ex_arr(i,j,k);
-            }
-        },
-        [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-            if (sc_arr(i,j,k)==1 and sc_arr(i,j+1,k)==1) {
-                amrex::Real const mu_interp = CoarsenIO::Interp(mu_arr, mu_stag, jy_stag,
-                                                                macro_cr, i, j, k, scomp);
-                jy_arr(i,j,k) += dt * lambda_sq_inv/mu_interp * Ey_arr(i,j,k);
-            }
-        },
-        [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-            if (sc_arr(i,j,k)==1 and sc_arr(i,j,k+1)==1) {
-                amrex::Real const mu_interp = CoarsenIO::Interp(mu_arr, mu_stag, jz_stag,
-                                                                macro_cr, i, j, k, scomp);
-                jz_arr(i,j,k) += dt * lambda_sq_inv/mu_interp * Ez_arr(i,j,k);
+    for (int idir = 0; idir < 3; ++idir) {
+        amrex::MultiFab* j_mf = warpx.get_pointer_current_fp(lev, idir);
+        m_edges[lev][idir] = std::make_unique<
+            amrex::LayoutData< amrex::Gpu::DeviceVector<LondonEdge> > >(ba, dmap);
+        amrex::GpuArray<int, 3> edge_stag{0, 0, 0};
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) edge_stag[idim] = j_mf->ixType()[idim];
+        // index shift to the second node of the edge
+        const int di = (idir == 0) ? 1 : 0;
+        const int dj = (idir == 1) ? 1 : 0;
+        const int dk = (idir == 2) ? 1 : 0;
+
+        for (amrex::MFIter mfi(*j_mf); mfi.isValid(); ++mfi) {
+            // Only the valid edges are updated, the guard cells are filled by FillBoundary
+            const amrex::Box bx = mfi.validbox();
+            const int ncells = static_cast<int>(bx.numPts());
+            amrex::Array4<amrex::Real const> const& sc_arr = sc_mf.const_array(mfi);
+            amrex::Array4<amrex::Real const> mu_arr;
+            if (mu_from_mf) mu_arr = mu_mf->const_array(mfi);
+
+            // Position of each superconducting edge in the list
+            amrex::Gpu::DeviceVector<int> offsets(ncells);
+            int* const offsets_ptr = offsets.dataPtr();
+            const int nedges = amrex::Scan::PrefixSum<int>(ncells,
+                [=] AMREX_GPU_DEVICE (int icell) -> int {
+                    const amrex::Dim3 c = bx.atOffset(icell).dim3();
+                    return (sc_arr(c.x,c.y,c.z)==1 and sc_arr(c.x+di,c.y+dj,c.z+dk)==1) ? 1 : 0;
+                },
+                [=] AMREX_GPU_DEVICE (int icell, int ps) {
+                    offsets_ptr[icell] = ps;
+                },
+                amrex::Scan::Type::exclusive);
+
+            auto& edges = (*m_edges[lev][idir])[mfi];
+            edges.resize(nedges);
+            if (nedges == 0) continue;
+            LondonEdge* const edges_ptr = edges.dataPtr();
+            amrex::ParallelFor(ncells,
+                [=] AMREX_GPU_DEVICE (int icell) {
+                    const amrex::Dim3 c = bx.atOffset(icell).dim3();
+                    if (sc_arr(c.x,c.y,c.z)==1 and sc_arr(c.x+di,c.y+dj,c.z+dk)==1) {
+                        amrex::Real x, y, z;
+                        WarpXUtilAlgo::getCellCoordinates(c.x, c.y, c.z, edge_stag,
+                                                          problo, dx, x, y, z);
+                        amrex::Real mu = mu_const;
+                        if (mu_from_mf) {
+                            mu = CoarsenIO::Interp(mu_arr, mu_stag, edge_stag, macro_cr,
+                                                   c.x, c.y, c.z, scomp);
+                        } else if (!mu_is_constant) {
+                            mu = mu_parser(x,y,z);
+                        }
+                        amrex::Real const lambda = (lambda_is_constant) ? lambda_const : lambda_parser(x,y,z);
+                        edges_ptr[offsets_ptr[icell]] =
+                            LondonEdge{c.x, c.y, c.z, 1._rt / (lambda * lambda * mu)};
+                    }
+            });
+        }
+    }
+
+    // lambda^2 mu0 on the B_sc faces, used to compute B_sc
+    if (!lambda_is_constant) {
+        for (int idir = 0; idir < 3; ++idir) {
+            const amrex::IndexType B_ixtype = warpx.get_pointer_Bfield_sc_fp(lev,idir)->ixType();
+            m_lambdasq_mu0_mf[lev][idir] = std::make_unique<amrex::MultiFab>(
+                amrex::convert(ba,B_ixtype), dmap, 1, 0);
+            amrex::MultiFab* lambdasq_mf = m_lambdasq_mu0_mf[lev][idir].get();
+            amrex::GpuArray<int, 3> face_stag{0, 0, 0};
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) face_stag[idim] = B_ixtype[idim];
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+            for (amrex::MFIter mfi(*lambdasq_mf, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+                amrex::Array4<amrex::Real> const& lambdasq_mu0 = lambdasq_mf->array(mfi);
+                amrex::Box const& tb = mfi.tilebox();
+                amrex::ParallelFor(tb,
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                        amrex::Real x, y, z;
+                        WarpXUtilAlgo::getCellCoordinates(i, j, k, face_stag, problo, dx, x, y, z);
+                        amrex::Real const lambda = lambda_parser(x,y,z);
+                        lambdasq_mu0(i,j,k) = lambda * lambda * PhysConst::mu0;
+                });
             }
         }
-    );
     }
 
+    amrex::Gpu::synchronize();
+    m_is_built[lev] = 1;
 }
 
 void
-London::InitializeSuperconductorMultiFabUsingParser (
-                       amrex::MultiFab *sc_mf,
-                       amrex::ParserExecutor<3> const& sc_parser,
-                       const int lev)
+London::Clear (int lev)
 {
-    using namespace amrex::literals;
+    for (int idir = 0; idir < 3; ++idir) {
+        m_edges[lev][idir].reset();
+        m_lambdasq_mu0_mf[lev][idir].reset();
+    }
+    m_is_built[lev] = 0;
+}
 
-    WarpX& warpx = WarpX::GetInstance();
-    const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx_lev = warpx.Geom(lev).CellSizeArray();
-    const amrex::RealBox& real_box = warpx.Geom(lev).ProbDomain();
-    amrex::IntVect iv = sc_mf->ixType().toIntVect();
-    for ( amrex::MFIter mfi(*sc_mf, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
-        // Initialize ghost cells in addition to valid cells
+void
+London::ClearAll ()
+{
+    for (int lev = 0; lev < static_cast<int>(m_is_built.size()); ++lev) {
+        Clear(lev);
+    }
+}
+
+void
+London::EvolveLondonJ (amrex::Real dt)
+{
+    auto & warpx = WarpX::GetInstance();
+    for (int lev = 0; lev <= warpx.finestLevel(); ++lev) {
+        EvolveLondonJ(lev, dt);
+    }
+}
+
+void
+London::EvolveLondonJ (int lev, amrex::Real dt)
+{
+    WARPX_PROFILE("London::EvolveLondonJ()");
+    auto & warpx = WarpX::GetInstance();
+    if (!IsBuilt(lev)) Build(lev);
 
-        const amrex::Box& tb = mfi.tilebox( iv, sc_mf->nGrowVect());
-        amrex::Array4<amrex::Real> const& sc_fab =  sc_mf->array(mfi);
+    // evolve J  = 1/( (lambda*lambda) * mu) * E * dt
+    // Only the edges inside the superconductor are visited.
+    for (int idir = 0; idir < 3; ++idir) {
+        amrex::MultiFab * j_mf = warpx.get_pointer_current_fp(lev, idir);
+        amrex::MultiFab * E_mf = warpx.get_pointer_Efield_fp(lev, idir);
+        for (amrex::MFIter mfi(*j_mf); mfi.isValid(); ++mfi) {
+            EvolveLondonJ((*m_edges[lev][idir])[mfi], j_mf->array(mfi), E_mf->const_array(mfi), dt);
+        }
+    }
+}
+
+void
+London::EvolveLondonJ (amrex::Gpu::DeviceVector<LondonEdge> const& edges,
+                       amrex::Array4<amrex::Real> const& j,
+                       amrex::Array4<amrex::Real const> const& E, amrex::Real dt)
+{
+    const int nedges = static_cast<int>(edges.size());
+    if (nedges == 0) return;
+    LondonEdge const* const edges_ptr = edges.dataPtr();
+    amrex::ParallelFor(nedges,
+        [=] AMREX_GPU_DEVICE (int p) {
+            const LondonEdge e = edges_ptr[p];
+            j(e.i,e.j,e.k) += dt * e.coef * E(e.i,e.j,e.k);
+    });
+}
+
+void
+London::FillSuperconductor (amrex::MultiFab& sc_mf, int lev) const
+{
+    auto& warpx = WarpX::GetInstance();
+    if (m_use_material_map) {
+        warpx.GetMaterialMap().Fill(sc_mf,
+            warpx.GetMaterialMap().MaterialValues("superconductor", amrex::Real(0.)), lev);
+        return;
+    }
+
+    amrex::ParserExecutor<3> const sc_parser = m_superconductor_parser->compile<3>();
+    const auto problo = warpx.Geom(lev).ProbLoArray();
+    const auto dx = warpx.Geom(lev).CellSizeArray();
+    amrex::GpuArray<int, 3> sc_stag{0, 0, 0};
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) sc_stag[idim] = sc_mf.ixType()[idim];
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( amrex::MFIter mfi(sc_mf, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+        // Initialize ghost cells in addition to valid cells
+        const amrex::Box& tb = mfi.growntilebox();
+        amrex::Array4<amrex::Real> const& sc_fab = sc_mf.array(mfi);
         amrex::ParallelFor (tb,
             [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                // Shift x, y, z position based on index type (only 3D supported for now)
-                amrex::Real fac_x = (1._rt - iv[0]) * dx_lev[0] * 0.5_rt;
-                amrex::Real x = i * dx_lev[0] + real_box.lo(0) + fac_x;
-                amrex::Real fac_y = (1._rt - iv[1]) * dx_lev[1] * 0.5_rt;
-                amrex::Real y = j * dx_lev[1] + real_box.lo(1) + fac_y;
-                amrex::Real fac_z = (1._rt - iv[2]) * dx_lev[2] * 0.5_rt;
-                amrex::Real z = k * dx_lev[2] + real_box.lo(2) + fac_z;
-                // initialize the macroparameter
+                amrex::Real x, y, z;
+                WarpXUtilAlgo::getCellCoordinates(i, j, k, sc_stag, problo, dx, x, y, z);
                 sc_fab(i,j,k) = sc_parser(x,y,z);
         });
-
     }
 }
-
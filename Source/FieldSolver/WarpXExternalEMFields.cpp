@@ -1,11 +1,17 @@
 #include "WarpX.H"
 #include "BoundaryConditions/PML.H"
 #include "Evolve/WarpXDtType.H"
+#include "FieldSolver/Excitation/ExcitationSources.H"
 #include "Utils/WarpXConst.H"
+#include "Utils/WarpXProfilerWrapper.H"
 #include "Utils/WarpXUtil.H"
 #include <AMReX_MultiFab.H>
 #include <AMReX_Parser.H>
 
+#include <array>
+#include <memory>
+#include <string>
+
 using namespace amrex;
 
 /**
@@ -22,16 +28,28 @@ WarpX::ApplyExternalFieldExcitationOnGrid (int const externalfieldtype, DtType a
     for (int lev = 0; lev <= finest_level; ++lev) {
         if (externalfieldtype == ExternalFieldType::AllExternal || externalfieldtype == ExternalFieldType::EfieldExternal) {
             if (E_excitation_grid_s == "parse_e_excitation_grid_function") {
-                ApplyExternalFieldExcitationOnGrid(Efield_fp[lev][0].get(),
+                if (m_E_separable_excitation) {
+                    ApplySeparableExcitationOnGrid(*m_E_excitation_sources, *m_E_separable_excitation,
+                                                   Efield_fp[lev][0].get(),
                                                    Efield_fp[lev][1].get(),
                                                    Efield_fp[lev][2].get(),
-                                                   Exfield_xt_grid_parser->compile<4>(),
-                                                   Eyfield_xt_grid_parser->compile<4>(),
-                                                   Ezfield_xt_grid_parser->compile<4>(),
-                                                   Exfield_flag_parser->compile<3>(),
-                                                   Eyfield_flag_parser->compile<3>(),
-                                                   Ezfield_flag_parser->compile<3>(),
+                                                   *Exfield_flag_parser,
+                                                   *Eyfield_flag_parser,
+                                                   *Ezfield_flag_parser,
                                                    lev, a_dt_type );
+                } else {
+                    ApplyExternalFieldExcitationOnGrid(*m_E_excitation_sources,
+                                                       Efield_fp[lev][0].get(),
+                                                       Efield_fp[lev][1].get(),
+                                                       Efield_fp[lev][2].get(),
+                                                       Exfield_xt_grid_parser->compile<4>(),
+                                                       Eyfield_xt_grid_parser->compile<4>(),
+                                                       Ezfield_xt_grid_parser->compile<4>(),
+                                                       *Exfield_flag_parser,
+                                                       *Eyfield_flag_parser,
+                                                       *Ezfield_flag_parser,
+                                                       lev, a_dt_type );
+                }
             }
         }
         // The excitation, especially when used to set an internal PEC, will be extended
@@ -39,59 +57,107 @@ WarpX::ApplyExternalFieldExcitationOnGrid (int const externalfieldtype, DtType a
         // As clarified in the documentation, it is important that the parser is valid in the pml region
         if (WarpX::isAnyBoundaryPML() and externalfieldtype == ExternalFieldType::EfieldExternalPML) {
             if (E_excitation_grid_s == "parse_e_excitation_grid_function") {
-                    ApplyExternalFieldExcitationOnGrid(pml[lev]->GetE_fp(0),
+                if (m_E_separable_excitation) {
+                    ApplySeparableExcitationOnGrid(*m_E_pml_excitation_sources, *m_E_separable_excitation,
+                                                   pml[lev]->GetE_fp(0),
+                                                   pml[lev]->GetE_fp(1),
+                                                   pml[lev]->GetE_fp(2),
+                                                   *Exfield_flag_parser,
+                                                   *Eyfield_flag_parser,
+                                                   *Ezfield_flag_parser,
+                                                   lev, a_dt_type );
+                } else {
+                    ApplyExternalFieldExcitationOnGrid(*m_E_pml_excitation_sources,
+                                                       pml[lev]->GetE_fp(0),
                                                        pml[lev]->GetE_fp(1),
                                                        pml[lev]->GetE_fp(2),
                                                        Exfield_xt_grid_parser->compile<4>(),
                                                        Eyfield_xt_grid_parser->compile<4>(),
                                                        Ezfield_xt_grid_parser->compile<4>(),
-                                                       Exfield_flag_parser->compile<3>(),
-                                                       Eyfield_flag_parser->compile<3>(),
-                                                       Ezfield_flag_parser->compile<3>(),
+                                                       *Exfield_flag_parser,
+                                                       *Eyfield_flag_parser,
+                                                       *Ezfield_flag_parser,
                                                        lev, a_dt_type );
+                }
             }
         }
         if (externalfieldtype == ExternalFieldType::AllExternal || externalfieldtype == ExternalFieldType::BfieldExternal) {
             if (B_excitation_grid_s == "parse_b_excitation_grid_function") {
-                ApplyExternalFieldExcitationOnGrid(Bfield_fp[lev][0].get(),
+                if (m_B_separable_excitation) {
+                    ApplySeparableExcitationOnGrid(*m_B_excitation_sources, *m_B_separable_excitation,
+                                                   Bfield_fp[lev][0].get(),
                                                    Bfield_fp[lev][1].get(),
                                                    Bfield_fp[lev][2].get(),
-                                                   Bxfield_xt_grid_parser->compile<4>(),
-                                                   Byfield_xt_grid_parser->compile<4>(),
-                                                   Bzfield_xt_grid_parser->compile<4>(),
-                                                   Bxfield_flag_parser->compile<3>(),
-                                                   Byfield_flag_parser->compile<3>(),
-                                                   Bzfield_flag_parser->compile<3>(),
+                                                   *Bxfield_flag_parser,
+                                                   *Byfield_flag_parser,
+                                                   *Bzfield_flag_parser,
                                                    lev, a_dt_type );
+                } else {
+                    ApplyExternalFieldExcitationOnGrid(*m_B_excitation_sources,
+                                                       Bfield_fp[lev][0].get(),
+                                                       Bfield_fp[lev][1].get(),
+                                                       Bfield_fp[lev][2].get(),
+                                                       Bxfield_xt_grid_parser->compile<4>(),
+                                                       Byfield_xt_grid_parser->compile<4>(),
+                                                       Bzfield_xt_grid_parser->compile<4>(),
+                                                       *Bxfield_flag_parser,
+                                                       *Byfield_flag_parser,
+                                                       *Bzfield_flag_parser,
+                                                       lev, a_dt_type );
+                }
             }
         }
 #ifdef WARPX_MAG_LLG
         if (externalfieldtype == ExternalFieldType::AllExternal || externalfieldtype == ExternalFieldType::HfieldExternal) {
             if (H_excitation_grid_s == "parse_h_excitation_grid_function") {
-            ApplyExternalFieldExcitationOnGrid(Hfield_fp[lev][0].get(),
+            if (m_H_separable_excitation) {
+                ApplySeparableExcitationOnGrid(*m_H_excitation_sources, *m_H_separable_excitation,
+                                               Hfield_fp[lev][0].get(),
                                                Hfield_fp[lev][1].get(),
                                                Hfield_fp[lev][2].get(),
-                                               Hxfield_xt_grid_parser->compile<4>(),
-                                               Hyfield_xt_grid_parser->compile<4>(),
-                                               Hzfield_xt_grid_parser->compile<4>(),
-                                               Hxfield_flag_parser->compile<3>(),
-                                               Hyfield_flag_parser->compile<3>(),
-                                               Hzfield_flag_parser->compile<3>(),
+                                               *Hxfield_flag_parser,
+                                               *Hyfield_flag_parser,
+                                               *Hzfield_flag_parser,
                                                lev, a_dt_type );
+            } else {
+                ApplyExternalFieldExcitationOnGrid(*m_H_excitation_sources,
+                                                   Hfield_fp[lev][0].get(),
+                                                   Hfield_fp[lev][1].get(),
+                                                   Hfield_fp[lev][2].get(),
+                                                   Hxfield_xt_grid_parser->compile<4>(),
+                                                   Hyfield_xt_grid_parser->compile<4>(),
+                                                   Hzfield_xt_grid_parser->compile<4>(),
+                                                   *Hxfield_flag_parser,
+                                                   *Hyfield_flag_parser,
+                                                   *Hzfield_flag_parser,
+                                                   lev, a_dt_type );
+            }
             }
         }
         if (externalfieldtype == ExternalFieldType::AllExternal || externalfieldtype == ExternalFieldType::HbiasfieldExternal) {
             if (H_bias_excitation_grid_s == "parse_h_bias_excitation_grid_function") {
-            ApplyExternalFieldExcitationOnGrid(H_biasfield_fp[lev][0].get(),
+            if (m_H_bias_separable_excitation) {
+                ApplySeparableExcitationOnGrid(*m_H_bias_excitation_sources, *m_H_bias_separable_excitation,
+                                               H_biasfield_fp[lev][0].get(),
                                                H_biasfield_fp[lev][1].get(),
                                                H_biasfield_fp[lev][2].get(),
-                                               Hx_biasfield_xt_grid_parser->compile<4>(),
-                                               Hy_biasfield_xt_grid_parser->compile<4>(),
-                                               Hz_biasfield_xt_grid_parser->compile<4>(),
-                                               Hx_biasfield_flag_parser->compile<3>(),
-                                               Hy_biasfield_flag_parser->compile<3>(),
-                                               Hz_biasfield_flag_parser->compile<3>(),
+                                               *Hx_biasfield_flag_parser,
+                                               *Hy_biasfield_flag_parser,
+                                               *Hz_biasfield_flag_parser,
                                                lev, a_dt_type );
+            } else {
+                ApplyExternalFieldExcitationOnGrid(*m_H_bias_excitation_sources,
+                                                   H_biasfield_fp[lev][0].get(),
+                                                   H_biasfield_fp[lev][1].get(),
+                                                   H_biasfield_fp[lev][2].get(),
+                                                   Hx_biasfield_xt_grid_parser->compile<4>(),
+                                                   Hy_biasfield_xt_grid_parser->compile<4>(),
+                                                   Hz_biasfield_xt_grid_parser->compile<4>(),
+                                                   *Hx_biasfield_flag_parser,
+                                                   *Hy_biasfield_flag_parser,
+                                                   *Hz_biasfield_flag_parser,
+                                                   lev, a_dt_type );
+            }
             }
         }
 #endif
@@ -100,119 +166,83 @@ WarpX::ApplyExternalFieldExcitationOnGrid (int const externalfieldtype, DtType a
 
 void
 WarpX::ApplyExternalFieldExcitationOnGrid (
+       ExcitationSources& sources,
        amrex::MultiFab *mfx, amrex::MultiFab *mfy, amrex::MultiFab *mfz,
        ParserExecutor<4> const& xfield_parser,
        ParserExecutor<4> const& yfield_parser,
        ParserExecutor<4> const& zfield_parser,
-       ParserExecutor<3> const& xflag_parser,
-       ParserExecutor<3> const& yflag_parser,
-       ParserExecutor<3> const& zflag_parser, const int lev, DtType a_dt_type )
+       amrex::Parser const& xflag_parser,
+       amrex::Parser const& yflag_parser,
+       amrex::Parser const& zflag_parser, const int lev, DtType a_dt_type )
 {
+    WARPX_PROFILE("WarpX::ApplyExternalFieldExcitationOnGrid()");
+
     // This function adds the contribution from an external excitation to the fields.
     // A flag is used to determine the type of excitation.
     // If flag == 1, it is a hard source and the field = excitation
     // If flag == 2, if is a soft source and the field += excitation
     // If flag == 0, the excitation parser is not computed and the field is unchanged.
     // If flag is not 0, or 1, or 2, the code will Abort!
-
-    // Gpu vector to store Ex-Bz staggering (Hx-Hz for LLG)
-    GpuArray<int,3> mfx_stag, mfy_stag, mfz_stag;
-    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-        mfx_stag[idim] = mfx->ixType()[idim];
-        mfy_stag[idim] = mfy->ixType()[idim];
-        mfz_stag[idim] = mfz->ixType()[idim];
+    // The flags do not depend on time: the points with a non-zero flag are
+    // gathered once per level, and only these points are visited afterwards.
+    std::array<amrex::MultiFab*, 3> const fields{mfx, mfy, mfz};
+    if (!sources.IsBuilt(lev)) {
+        sources.Build(fields,
+                      {xflag_parser.compile<3>(), yflag_parser.compile<3>(), zflag_parser.compile<3>()},
+                      lev);
     }
-    amrex::Real t = gett_new(lev);
-    const auto problo = Geom(lev).ProbLoArray();
-    const auto dx = Geom(lev).CellSizeArray();
-    amrex::IntVect x_nodal_flag = mfx->ixType().toIntVect();
-    amrex::IntVect y_nodal_flag = mfy->ixType().toIntVect();
-    amrex::IntVect z_nodal_flag = mfz->ixType().toIntVect();
-    // For each multifab, apply excitation to ncomponents
-    // If not split pml fields, the excitation is applied to the regular Efield used in Maxwell's eq.
-    // If pml field, then the excitation is applied to all the split field components.
-    const int nComp_x = mfx->nComp();
-    const int nComp_y = mfy->nComp();
-    const int nComp_z = mfz->nComp();
+
     // Multiplication factor for field parser depending on dt_type
-    // If Full, then 1 (default), if FirstHalf or SecondHalf then 0.5
-    int dt_type_flag = 0;
-    if (a_dt_type == DtType::FirstHalf or a_dt_type == DtType::SecondHalf ) {
-        dt_type_flag = 1;
+    // If Full, then 1 (default), if FirstHalf or SecondHalf then 0.5 for soft sources
+    const bool half_step = (a_dt_type == DtType::FirstHalf or a_dt_type == DtType::SecondHalf);
+    sources.Apply(fields, {xfield_parser, yfield_parser, zfield_parser},
+                  gett_new(lev), half_step, lev);
+}
+
+void
+WarpX::ApplySeparableExcitationOnGrid (
+       ExcitationSources& sources, SeparableExcitation& separable,
+       amrex::MultiFab *mfx, amrex::MultiFab *mfy, amrex::MultiFab *mfz,
+       amrex::Parser const& xflag_parser,
+       amrex::Parser const& yflag_parser,
+       amrex::Parser const& zflag_parser, const int lev, DtType a_dt_type )
+{
+    WARPX_PROFILE("WarpX::ApplySeparableExcitationOnGrid()");
+
+    std::array<amrex::MultiFab*, 3> const fields{mfx, mfy, mfz};
+    if (!sources.IsBuilt(lev)) {
+        const std::array<amrex::ParserExecutor<3>, 3> spatial_parsers{
+            separable.m_spatial_parsers[0]->compile<3>(),
+            separable.m_spatial_parsers[1]->compile<3>(),
+            separable.m_spatial_parsers[2]->compile<3>()};
+        sources.Build(fields,
+                      {xflag_parser.compile<3>(), yflag_parser.compile<3>(), zflag_parser.compile<3>()},
+                      lev, &spatial_parsers);
     }
-#ifdef AMREX_USE_OMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-    for ( MFIter mfi(*mfx, TilingIfNotGPU()); mfi.isValid(); ++mfi)
-    {
-        // Extract field data for this grid/tile
-        amrex::Array4<amrex::Real> const& Fx = mfx->array(mfi);
-        amrex::Array4<amrex::Real> const& Fy = mfy->array(mfi);
-        amrex::Array4<amrex::Real> const& Fz = mfz->array(mfi);
 
-        const amrex::Box& tbx = mfi.tilebox( x_nodal_flag, mfx->nGrowVect() );
-        const amrex::Box& tby = mfi.tilebox( y_nodal_flag, mfy->nGrowVect() );
-        const amrex::Box& tbz = mfi.tilebox( z_nodal_flag, mfz->nGrowVect() );
+    // The waveforms only depend on time: they are evaluated once, on the host
+    const std::array<amrex::Real, 3> amplitudes = separable.EvaluateWaveforms(gett_new(lev));
+    const bool half_step = (a_dt_type == DtType::FirstHalf or a_dt_type == DtType::SecondHalf);
+    sources.ApplySeparable(fields, amplitudes, half_step, lev);
+}
 
-        // Loop over the cells and update the fields
-        amrex::ParallelFor(tbx, nComp_x,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
-                amrex::Real x, y, z;
-                WarpXUtilAlgo::getCellCoordinates(i, j, k, mfx_stag,
-                                                  problo, dx, x, y, z);
-                auto flag_type = xflag_parser(x,y,z);
-                amrex::Real dt_type_factor = 1._rt;
-                // For soft source and FirstHalf/SecondHalf evolve
-                // the excitation is split with a prefector of 0.5
-                if (flag_type == 2._rt and dt_type_flag == 1) {
-                    dt_type_factor = 0.5_rt;
-                }
-                if (flag_type != 0._rt && flag_type != 1._rt && flag_type != 2._rt) {
-                    amrex::Abort("flag type for excitation must be 0, or 1, or 2!");
-                } else if ( flag_type > 0._rt ) {
-                    Fx(i, j, k, n) = Fx(i,j,k,n)*(flag_type-1.0_rt)
-                                   + dt_type_factor * xfield_parser(x,y,z,t);
-                }
-            },
-            tby, nComp_y,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
-                amrex::Real x, y, z;
-                WarpXUtilAlgo::getCellCoordinates(i, j, k, mfy_stag,
-                                                  problo, dx, x, y, z);
-                auto flag_type = yflag_parser(x,y,z);
-                amrex::Real dt_type_factor = 1._rt;
-                // For soft source and FirstHalf/SecondHalf evolve
-                // the excitation is split with a prefector of 0.5
-                if (flag_type == 2._rt and dt_type_flag == 1) {
-                    dt_type_factor = 0.5_rt;
-                }
-                if (flag_type != 0._rt && flag_type != 1._rt && flag_type != 2._rt) {
-                    amrex::Abort("flag type for excitation must be 0, or 1, or 2!");
-                } else if ( flag_type > 0._rt ) {
-                    Fy(i, j, k, n) = Fy(i,j,k,n)*(flag_type-1.0_rt)
-                                   + dt_type_factor * yfield_parser(x,y,z,t);
-                }
-            },
-            tbz, nComp_z,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
-                amrex::Real x, y, z;
-                WarpXUtilAlgo::getCellCoordinates(i, j, k, mfz_stag,
-                                                  problo, dx, x, y, z);
-                auto flag_type = zflag_parser(x,y,z);
-                amrex::Real dt_type_factor = 1._rt;
-                // For soft source and FirstHalf/SecondHalf evolve
-                // the excitation is split with a prefector of 0.5
-                if (flag_type == 2._rt and dt_type_flag == 1) {
-                    dt_type_factor = 0.5_rt;
-                }
-                if (flag_type != 0._rt && flag_type != 1._rt && flag_type != 2._rt) {
-                    amrex::Abort("flag type for excitation must be 0, or 1, or 2!");
-                } else if ( flag_type > 0._rt ) {
-                    Fz(i, j, k,n) = Fz(i,j,k,n)*(flag_type-1.0_rt)
-                                  + dt_type_factor * zfield_parser(x,y,z,t);
-                }
-            }
-        );
+void
+WarpX::ClearExcitationSources (int lev)
+{
+    for (auto* sources : {m_E_excitation_sources.get(), m_E_pml_excitation_sources.get(),
+#ifdef WARPX_MAG_LLG
+                          m_H_excitation_sources.get(), m_H_bias_excitation_sources.get(),
+#endif
+                          m_B_excitation_sources.get()}) {
+        if (sources) sources->Clear(lev);
+    }
+}
+
+void
+WarpX::ClearExcitationSources ()
+{
+    for (int lev = 0; lev <= maxLevel(); ++lev) {
+        ClearExcitationSources(lev);
     }
 }
 
@@ -259,12 +289,21 @@ WarpX::ReadExcitationParser ()
         // source type (hard=1, soft=2) must be specified for all components
         // using the flag function. Note that a flag value of 0 will not update
         // the field with the excitation.
-        Store_parserString(pp_warpx, "Ex_excitation_flag_function(x,y,z)",
-                                str_Ex_excitation_flag_function);
-        Store_parserString(pp_warpx, "Ey_excitation_flag_function(x,y,z)",
-                                str_Ey_excitation_flag_function);
-        Store_parserString(pp_warpx, "Ez_excitation_flag_function(x,y,z)",
-                                str_Ez_excitation_flag_function);
+        int E_flags_from_map = 0;
+        pp_warpx.query("E_excitation_flag_from_material_map", E_flags_from_map);
+        if (E_flags_from_map) {
+            // The flags are given per material in the voxel material map
+            str_Ex_excitation_flag_function = "0";
+            str_Ey_excitation_flag_function = "0";
+            str_Ez_excitation_flag_function = "0";
+        } else {
+            Store_parserString(pp_warpx, "Ex_excitation_flag_function(x,y,z)",
+                                    str_Ex_excitation_flag_function);
+            Store_parserString(pp_warpx, "Ey_excitation_flag_function(x,y,z)",
+                                    str_Ey_excitation_flag_function);
+            Store_parserString(pp_warpx, "Ez_excitation_flag_function(x,y,z)",
+                                    str_Ez_excitation_flag_function);
+        }
         Exfield_flag_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Ex_excitation_flag_function,{"x","y","z"}));
         Eyfield_flag_parser = std::make_unique<amrex::Parser>(
@@ -273,24 +312,43 @@ WarpX::ReadExcitationParser ()
                    makeParser(str_Ez_excitation_flag_function,{"x","y","z"}));
 
         pp_warpx.query("Apply_E_excitation_in_pml_region", ApplyExcitationInPML);
+        m_E_excitation_sources = std::make_unique<ExcitationSources>(maxLevel()+1);
+        m_E_pml_excitation_sources = std::make_unique<ExcitationSources>(maxLevel()+1);
+        if (E_flags_from_map) {
+            m_E_excitation_sources->SetFlagsFromMaterialMap({"Ex", "Ey", "Ez"});
+            m_E_pml_excitation_sources->SetFlagsFromMaterialMap({"Ex", "Ey", "Ez"});
+        }
     }
     if (B_excitation_grid_s == "parse_b_excitation_grid_function") {
         // if B excitation type is set to parser then the corresponding
         // source type (hard=1, soft=2) must be specified for all components
         // using the flag function. Note that a flag value of 0 will not update
         // the field with the excitation.
-        Store_parserString(pp_warpx, "Bx_excitation_flag_function(x,y,z)",
-                                str_Bx_excitation_flag_function);
-        Store_parserString(pp_warpx, "By_excitation_flag_function(x,y,z)",
-                                str_By_excitation_flag_function);
-        Store_parserString(pp_warpx, "Bz_excitation_flag_function(x,y,z)",
-                                str_Bz_excitation_flag_function);
+        int B_flags_from_map = 0;
+        pp_warpx.query("B_excitation_flag_from_material_map", B_flags_from_map);
+        if (B_flags_from_map) {
+            // The flags are given per material in the voxel material map
+            str_Bx_excitation_flag_function = "0";
+            str_By_excitation_flag_function = "0";
+            str_Bz_excitation_flag_function = "0";
+        } else {
+            Store_parserString(pp_warpx, "Bx_excitation_flag_function(x,y,z)",
+                                    str_Bx_excitation_flag_function);
+            Store_parserString(pp_warpx, "By_excitation_flag_function(x,y,z)",
+                                    str_By_excitation_flag_function);
+            Store_parserString(pp_warpx, "Bz_excitation_flag_function(x,y,z)",
+                                    str_Bz_excitation_flag_function);
+        }
         Bxfield_flag_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Bx_excitation_flag_function,{"x","y","z"}));
         Byfield_flag_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_By_excitation_flag_function,{"x","y","z"}));
         Bzfield_flag_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Bz_excitation_flag_function,{"x","y","z"}));
+        m_B_excitation_sources = std::make_unique<ExcitationSources>(maxLevel()+1);
+        if (B_flags_from_map) {
+            m_B_excitation_sources->SetFlagsFromMaterialMap({"Bx", "By", "Bz"});
+        }
     }
 
 
@@ -300,36 +358,62 @@ WarpX::ReadExcitationParser ()
         // source type (hard=1, soft=2) must be specified for all components
         // using the flag function. Note that a flag value of 0 will not update
         // the field with the excitation.
-        Store_parserString(pp_warpx, "Hx_excitation_flag_function(x,y,z)",
-                                str_Hx_excitation_flag_function);
-        Store_parserString(pp_warpx, "Hy_excitation_flag_function(x,y,z)",
-                                str_Hy_excitation_flag_function);
-        Store_parserString(pp_warpx, "Hz_excitation_flag_function(x,y,z)",
-                                str_Hz_excitation_flag_function);
+        int H_flags_from_map = 0;
+        pp_warpx.query("H_excitation_flag_from_material_map", H_flags_from_map);
+        if (H_flags_from_map) {
+            // The flags are given per material in the voxel material map
+            str_Hx_excitation_flag_function = "0";
+            str_Hy_excitation_flag_function = "0";
+            str_Hz_excitation_flag_function = "0";
+        } else {
+            Store_parserString(pp_warpx, "Hx_excitation_flag_function(x,y,z)",
+                                    str_Hx_excitation_flag_function);
+            Store_parserString(pp_warpx, "Hy_excitation_flag_function(x,y,z)",
+                                    str_Hy_excitation_flag_function);
+            Store_parserString(pp_warpx, "Hz_excitation_flag_function(x,y,z)",
+                                    str_Hz_excitation_flag_function);
+        }
         Hxfield_flag_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Hx_excitation_flag_function,{"x","y","z"}));
         Hyfield_flag_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Hy_excitation_flag_function,{"x","y","z"}));
         Hzfield_flag_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Hz_excitation_flag_function,{"x","y","z"}));
+        m_H_excitation_sources = std::make_unique<ExcitationSources>(maxLevel()+1);
+        if (H_flags_from_map) {
+            m_H_excitation_sources->SetFlagsFromMaterialMap({"Hx", "Hy", "Hz"});
+        }
     }
     if (H_bias_excitation_grid_s == "parse_h_bias_excitation_grid_function") {
         // if H bias_excitation type is set to parser then the corresponding
         // source type (hard=1, soft=2) must be specified for all components
         // using the flag function. Note that a flag value of 0 will not update
         // the field with the excitation.
-        Store_parserString(pp_warpx, "Hx_bias_excitation_flag_function(x,y,z)",
-                                str_Hx_bias_excitation_flag_function);
-        Store_parserString(pp_warpx, "Hy_bias_excitation_flag_function(x,y,z)",
-                                str_Hy_bias_excitation_flag_function);
-        Store_parserString(pp_warpx, "Hz_bias_excitation_flag_function(x,y,z)",
-                                str_Hz_bias_excitation_flag_function);
+        int H_bias_flags_from_map = 0;
+        pp_warpx.query("H_bias_excitation_flag_from_material_map", H_bias_flags_from_map);
+        if (H_bias_flags_from_map) {
+            // The flags are given per material in the voxel material map
+            str_Hx_bias_excitation_flag_function = "0";
+            str_Hy_bias_excitation_flag_function = "0";
+            str_Hz_bias_excitation_flag_function = "0";
+        } else {
+            Store_parserString(pp_warpx, "Hx_bias_excitation_flag_function(x,y,z)",
+                                    str_Hx_bias_excitation_flag_function);
+            Store_parserString(pp_warpx, "Hy_bias_excitation_flag_function(x,y,z)",
+                                    str_Hy_bias_excitation_flag_function);
+            Store_parserString(pp_warpx, "Hz_bias_excitation_flag_function(x,y,z)",
+                                    str_Hz_bias_excitation_flag_function);
+        }
         Hx_biasfield_flag_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Hx_bias_excitation_flag_function,{"x","y","z"}));
         Hy_biasfield_flag_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Hy_bias_excitation_flag_function,{"x","y","z"}));
         Hz_biasfield_flag_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Hz_bias_excitation_flag_function,{"x","y","z"}));
+        m_H_bias_excitation_sources = std::make_unique<ExcitationSources>(maxLevel()+1);
+        if (H_bias_flags_from_map) {
+            m_H_bias_excitation_sources->SetFlagsFromMaterialMap({"Hx_bias", "Hy_bias", "Hz_bias"});
+        }
     }
 #endif
 
@@ -338,18 +422,25 @@ WarpX::ReadExcitationParser ()
 #ifdef WARPX_DIM_RZ
        amrex::Abort("E and B parser for external fields does not work with RZ -- TO DO");
 #endif
-       Store_parserString(pp_warpx, "Bx_excitation_grid_function(x,y,z,t)",
-                                                    str_Bx_excitation_grid_function);
-       Store_parserString(pp_warpx, "By_excitation_grid_function(x,y,z,t)",
-                                                    str_By_excitation_grid_function);
-       Store_parserString(pp_warpx, "Bz_excitation_grid_function(x,y,z,t)",
-                                                    str_Bz_excitation_grid_function);
-       Bxfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Bx_excitation_grid_function,{"x","y","z","t"}));
-       Byfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_By_excitation_grid_function,{"x","y","z","t"}));
-       Bzfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Bz_excitation_grid_function,{"x","y","z","t"}));
+       int B_excitation_separable = 0;
+       pp_warpx.query("B_excitation_separable", B_excitation_separable);
+       if (B_excitation_separable) {
+           m_B_separable_excitation = std::make_unique<SeparableExcitation>(
+               std::array<std::string, 3>{"Bx","By","Bz"});
+       } else {
+           Store_parserString(pp_warpx, "Bx_excitation_grid_function(x,y,z,t)",
+                                                        str_Bx_excitation_grid_function);
+           Store_parserString(pp_warpx, "By_excitation_grid_function(x,y,z,t)",
+                                                        str_By_excitation_grid_function);
+           Store_parserString(pp_warpx, "Bz_excitation_grid_function(x,y,z,t)",
+                                                        str_Bz_excitation_grid_function);
+           Bxfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Bx_excitation_grid_function,{"x","y","z","t"}));
+           Byfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_By_excitation_grid_function,{"x","y","z","t"}));
+           Bzfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Bz_excitation_grid_function,{"x","y","z","t"}));
+       }
     }
 
     // make parser for the external E-excitation in space-time
@@ -357,18 +448,25 @@ WarpX::ReadExcitationParser ()
 #ifdef WARPX_DIM_RZ
        amrex::Abort("E and B parser for external fields does not work with RZ -- TO DO");
 #endif
-       Store_parserString(pp_warpx, "Ex_excitation_grid_function(x,y,z,t)",
-                                                    str_Ex_excitation_grid_function);
-       Store_parserString(pp_warpx, "Ey_excitation_grid_function(x,y,z,t)",
-                                                    str_Ey_excitation_grid_function);
-       Store_parserString(pp_warpx, "Ez_excitation_grid_function(x,y,z,t)",
-                                                    str_Ez_excitation_grid_function);
-       Exfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Ex_excitation_grid_function,{"x","y","z","t"}));
-       Eyfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Ey_excitation_grid_function,{"x","y","z","t"}));
-       Ezfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Ez_excitation_grid_function,{"x","y","z","t"}));
+       int E_excitation_separable = 0;
+       pp_warpx.query("E_excitation_separable", E_excitation_separable);
+       if (E_excitation_separable) {
+           m_E_separable_excitation = std::make_unique<SeparableExcitation>(
+               std::array<std::string, 3>{"Ex","Ey","Ez"});
+       } else {
+           Store_parserString(pp_warpx, "Ex_excitation_grid_function(x,y,z,t)",
+                                                        str_Ex_excitation_grid_function);
+           Store_parserString(pp_warpx, "Ey_excitation_grid_function(x,y,z,t)",
+                                                        str_Ey_excitation_grid_function);
+           Store_parserString(pp_warpx, "Ez_excitation_grid_function(x,y,z,t)",
+                                                        str_Ez_excitation_grid_function);
+           Exfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Ex_excitation_grid_function,{"x","y","z","t"}));
+           Eyfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Ey_excitation_grid_function,{"x","y","z","t"}));
+           Ezfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Ez_excitation_grid_function,{"x","y","z","t"}));
+       }
     }
 
 #ifdef WARPX_MAG_LLG
@@ -377,36 +475,50 @@ WarpX::ReadExcitationParser ()
 #ifdef WARPX_DIM_RZ
        amrex::Abort("H parser for external fields does not work with RZ -- TO DO");
 #endif
-       Store_parserString(pp_warpx, "Hx_excitation_grid_function(x,y,z,t)",
-                                                    str_Hx_excitation_grid_function);
-       Store_parserString(pp_warpx, "Hy_excitation_grid_function(x,y,z,t)",
-                                                    str_Hy_excitation_grid_function);
-       Store_parserString(pp_warpx, "Hz_excitation_grid_function(x,y,z,t)",
-                                                    str_Hz_excitation_grid_function);
-       Hxfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Hx_excitation_grid_function,{"x","y","z","t"}));
-       Hyfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Hy_excitation_grid_function,{"x","y","z","t"}));
-       Hzfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Hz_excitation_grid_function,{"x","y","z","t"}));
+       int H_excitation_separable = 0;
+       pp_warpx.query("H_excitation_separable", H_excitation_separable);
+       if (H_excitation_separable) {
+           m_H_separable_excitation = std::make_unique<SeparableExcitation>(
+               std::array<std::string, 3>{"Hx","Hy","Hz"});
+       } else {
+           Store_parserString(pp_warpx, "Hx_excitation_grid_function(x,y,z,t)",
+                                                        str_Hx_excitation_grid_function);
+           Store_parserString(pp_warpx, "Hy_excitation_grid_function(x,y,z,t)",
+                                                        str_Hy_excitation_grid_function);
+           Store_parserString(pp_warpx, "Hz_excitation_grid_function(x,y,z,t)",
+                                                        str_Hz_excitation_grid_function);
+           Hxfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Hx_excitation_grid_function,{"x","y","z","t"}));
+           Hyfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Hy_excitation_grid_function,{"x","y","z","t"}));
+           Hzfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Hz_excitation_grid_function,{"x","y","z","t"}));
+       }
     }
     // make parser for the external H-biasexcitation in space-time
     if (H_bias_excitation_grid_s == "parse_h_bias_excitation_grid_function") {
 #ifdef WARPX_DIM_RZ
        amrex::Abort("H parser for external fields does not work with RZ -- TO DO");
 #endif
-       Store_parserString(pp_warpx, "Hx_bias_excitation_grid_function(x,y,z,t)",
-                                                    str_Hx_bias_excitation_grid_function);
-       Store_parserString(pp_warpx, "Hy_bias_excitation_grid_function(x,y,z,t)",
-                                                    str_Hy_bias_excitation_grid_function);
-       Store_parserString(pp_warpx, "Hz_bias_excitation_grid_function(x,y,z,t)",
-                                                    str_Hz_bias_excitation_grid_function);
-       Hx_biasfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Hx_bias_excitation_grid_function,{"x","y","z","t"}));
-       Hy_biasfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Hy_bias_excitation_grid_function,{"x","y","z","t"}));
-       Hz_biasfield_xt_grid_parser = std::make_unique<amrex::Parser>(
-                   makeParser(str_Hz_bias_excitation_grid_function,{"x","y","z","t"}));
+       int H_bias_excitation_separable = 0;
+       pp_warpx.query("H_bias_excitation_separable", H_bias_excitation_separable);
+       if (H_bias_excitation_separable) {
+           m_H_bias_separable_excitation = std::make_unique<SeparableExcitation>(
+               std::array<std::string, 3>{"Hx_bias","Hy_bias","Hz_bias"});
+       } else {
+           Store_parserString(pp_warpx, "Hx_bias_excitation_grid_function(x,y,z,t)",
+                                                        str_Hx_bias_excitation_grid_function);
+           Store_parserString(pp_warpx, "Hy_bias_excitation_grid_function(x,y,z,t)",
+                                                        str_Hy_bias_excitation_grid_function);
+           Store_parserString(pp_warpx, "Hz_bias_excitation_grid_function(x,y,z,t)",
+                                                        str_Hz_bias_excitation_grid_function);
+           Hx_biasfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Hx_bias_excitation_grid_function,{"x","y","z","t"}));
+           Hy_biasfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Hy_bias_excitation_grid_function,{"x","y","z","t"}));
+           Hz_biasfield_xt_grid_parser = std::make_unique<amrex::Parser>(
+                       makeParser(str_Hz_bias_excitation_grid_function,{"x","y","z","t"}));
+       }
     }
 #endif
 }
@@ -563,33 +563,36 @@ void
 WarpX::EvolveBLondon (int lev, amrex::Real a_dt, DtType a_dt_type)
 {
     WARPX_PROFILE("WarpX::EvolveBLondon()");
+    // B_sc is only defined on the fine patch
     EvolveBLondon(lev, PatchType::fine, a_dt, a_dt_type);
-    if (lev > 0)
-    {
-        EvolveBLondon(lev, PatchType::coarse, a_dt, a_dt_type);
-    }
 }
 
 void
 WarpX::EvolveBLondon (int lev, PatchType patch_type, amrex::Real a_dt, DtType a_dt_type)
 {
     amrex::ignore_unused(a_dt_type);
-    // Evolve B field in regular cells
-    if (patch_type == PatchType::fine) {
-        m_fdtd_solver_fp[lev]->EvolveBLondon(Bfield_sc_fp[lev], current_fp[lev], G_fp[lev],
-                                       m_face_areas[lev], m_area_mod[lev], ECTRhofield[lev], Venl[lev],
-                                       m_flag_info_face[lev], m_borrowing[lev], lev, a_dt,
-                                       m_london->m_penetration_depth);
-    } else {
-        m_fdtd_solver_cp[lev]->EvolveBLondon(Bfield_sc_fp[lev], current_cp[lev], G_cp[lev],
-                                       m_face_areas[lev], m_area_mod[lev], ECTRhofield[lev], Venl[lev],
-                                       m_flag_info_face[lev], m_borrowing[lev], lev, a_dt,
-                                       m_london->m_penetration_depth);
-    }
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        patch_type == PatchType::fine,
+        "EvolveBLondon is only implemented for the fine patch.");
+    if (!m_london->IsBuilt(lev)) m_london->Build(lev);
+    m_fdtd_solver_fp[lev]->EvolveBLondon(Bfield_sc_fp[lev], current_fp[lev], G_fp[lev],
+                                   m_face_areas[lev], m_area_mod[lev], ECTRhofield[lev], Venl[lev],
+                                   m_flag_info_face[lev], m_borrowing[lev], lev, a_dt,
+                                   m_london->m_penetration_depth,
+                                   m_london->getlambdasq_mu0_mf(lev));
 
 }
 
 
+void
+WarpX::SetFieldPushRegion (PushRegion region)
+{
+    for (int lev = 0; lev <= finest_level; ++lev) {
+        m_fdtd_solver_fp[lev]->SetPushRegion(region);
+        if (lev > 0) m_fdtd_solver_cp[lev]->SetPushRegion(region);
+    }
+}
+
 void
 WarpX::EvolveB (amrex::Real a_dt, DtType a_dt_type)
 {
@@ -612,6 +615,8 @@ WarpX::EvolveB (int lev, amrex::Real a_dt, DtType a_dt_type)
 void
 WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real a_dt, DtType a_dt_type)
 {
+    // With a split push, the PML and the boundary conditions are applied after the Boundary push
+    const bool last_push = (m_fdtd_solver_fp[lev]->GetPushRegion() != PushRegion::Interior);
 
     // Evolve B field in regular cells
     if (patch_type == PatchType::fine) {
@@ -625,7 +630,7 @@ WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real a_dt, DtType a_dt_typ
     }
 
     // Evolve B field in PML cells
-    if (do_pml && pml[lev]->ok()) {
+    if (last_push && do_pml && pml[lev]->ok()) {
         if (patch_type == PatchType::fine) {
             m_fdtd_solver_fp[lev]->EvolveBPML(
                 pml[lev]->GetB_fp(), pml[lev]->GetE_fp(), a_dt, WarpX::do_dive_cleaning);
@@ -635,7 +640,7 @@ WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real a_dt, DtType a_dt_typ
         }
     }
 
-    ApplyBfieldBoundary(lev, patch_type, a_dt_type);
+    if (last_push) ApplyBfieldBoundary(lev, patch_type, a_dt_type);
 }
 
 
@@ -662,6 +667,9 @@ WarpX::EvolveE (int lev, amrex::Real a_dt)
 void
 WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
 {
+    // With a split push, the PML and the boundary conditions are applied after the Boundary push
+    const bool last_push = (m_fdtd_solver_fp[lev]->GetPushRegion() != PushRegion::Interior);
+
     // Evolve E field in regular cells
     if (patch_type == PatchType::fine) {
         m_fdtd_solver_fp[lev]->EvolveE(Efield_fp[lev], Bfield_fp[lev],
@@ -676,7 +684,7 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
     }
 
     // Evolve E field in PML cells
-    if (do_pml && pml[lev]->ok()) {
+    if (last_push && do_pml && pml[lev]->ok()) {
         if (patch_type == PatchType::fine) {
             m_fdtd_solver_fp[lev]->EvolveEPML(
                 pml[lev]->GetE_fp(),
@@ -704,7 +712,7 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
         }
     }
 
-    ApplyEfieldBoundary(lev, patch_type);
+    if (last_push) ApplyEfieldBoundary(lev, patch_type);
 
     // ECTRhofield must be recomputed at the very end of the Efield update to ensure
     // that ECTRhofield is consistent with Efield
@@ -840,11 +848,22 @@ WarpX::MacroscopicEvolveE (int lev, amrex::Real a_dt) {
 void
 WarpX::MacroscopicEvolveE (int lev, PatchType patch_type, amrex::Real a_dt) {
 
+    // With a split push, the PML and the boundary conditions are applied after the Boundary push
+    const bool last_push = (m_fdtd_solver_fp[lev]->GetPushRegion() != PushRegion::Interior);
+
     // Evolve E field in regular cells
     WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
         patch_type == PatchType::fine,
         "Macroscopic EvolveE is not implemented for lev>0, yet."
     );
+    // With the fused London update, J^{n+1/2} is computed from E^{n} in the E-update loop
+    LondonEdgeLists const* london_edges = nullptr;
+#ifndef WARPX_MAG_LLG
+    if (yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon && m_london->m_fused_update) {
+        if (!m_london->IsBuilt(lev)) m_london->Build(lev);
+        london_edges = &m_london->GetEdges(lev);
+    }
+#endif
     m_fdtd_solver_fp[lev]->MacroscopicEvolveE( Efield_fp[lev],
 #ifndef WARPX_MAG_LLG
                                                Bfield_fp[lev],
@@ -852,9 +871,9 @@ WarpX::MacroscopicEvolveE (int lev, PatchType patch_type, amrex::Real a_dt) {
                                                Hfield_fp[lev],
 #endif
                                                current_fp[lev], m_edge_lengths[lev], a_dt,
-                                               m_macroscopic_properties);
+                                               m_macroscopic_properties, london_edges);
     // Evolve E field in PML cells
-    if (do_pml && pml[lev]->ok()) {
+    if (last_push && do_pml && pml[lev]->ok()) {
         if (patch_type == PatchType::fine) {
             m_fdtd_solver_fp[lev]->MacroscopicEvolveEPML(
                 pml[lev]->GetE_fp(),
@@ -888,7 +907,7 @@ WarpX::MacroscopicEvolveE (int lev, PatchType patch_type, amrex::Real a_dt) {
         }
     }
 
-    ApplyEfieldBoundary(lev, patch_type);
+    if (last_push) ApplyEfieldBoundary(lev, patch_type);
 }
 
 #ifndef WARPX_DIM_RZ
@@ -915,6 +934,9 @@ WarpX::MacroscopicEvolveHM (int lev, amrex::Real a_dt) {
 void
 WarpX::MacroscopicEvolveHM (int lev, PatchType patch_type, amrex::Real a_dt) {
 
+    // With a split push, the PML is advanced after the Boundary push
+    const bool last_push = (m_fdtd_solver_fp[lev]->GetPushRegion() != PushRegion::Interior);
+
     // Evolve H field in regular cells
     if (patch_type == PatchType::fine) {
         m_fdtd_solver_fp[lev]->MacroscopicEvolveHM(Mfield_fp[lev], Hfield_fp[lev], Bfield_fp[lev], H_biasfield_fp[lev], Efield_fp[lev],
@@ -925,7 +947,7 @@ WarpX::MacroscopicEvolveHM (int lev, PatchType patch_type, amrex::Real a_dt) {
     }
 
     // Evolve H field in PML cells
-    if (do_pml && pml[lev]->ok()) {
+    if (last_push && do_pml && pml[lev]->ok()) {
         if (patch_type == PatchType::fine) {
             m_fdtd_solver_fp[lev]->EvolveHPML(
                 pml[lev]->GetH_fp(), pml[lev]->GetE_fp(), a_dt, WarpX::do_dive_cleaning);
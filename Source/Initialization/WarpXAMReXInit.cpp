@@ -10,6 +10,11 @@
 #include <AMReX.H>
 #include <AMReX_ParmParse.H>
 
+#include <array>
+#include <numeric>
+#include <string>
+#include <vector>
+
 namespace {
     /** Overwrite defaults in AMReX Inputs
      *
@@ -25,16 +30,34 @@ namespace {
         pp_amrex.queryAdd("abort_on_out_of_gpu_memory", abort_on_out_of_gpu_memory);
 
         // Work-around:
-        // If warpx.numprocs is used for the domain decomposition, we will not use blocking factor
-        // to generate grids. Nonetheless, AMReX has asserts in place that validate that the
-        // number of cells is a multiple of blocking factor. We set the blocking factor to 1 so those
-        // AMReX asserts will always pass.
+        // If warpx.numprocs is used for the domain decomposition, we will not use blocking
+        // factor to generate grids. Nonetheless, AMReX has asserts in place that validate that
+        // the number of cells is a multiple of blocking factor. We set the blocking factor to 1
+        // so those AMReX asserts will always pass.
+        // With warpx.thin_dim_decomposition, the boxes are cut at multiples of the blocking
+        // factor, which is reduced along each direction to its largest divisor that divides the
+        // number of cells (e.g. 4 along a thin direction of 4 cells with the default of 8).
         amrex::ParmParse pp_warpx("warpx");
+        bool thin_dim_decomposition = false;
+        pp_warpx.query("thin_dim_decomposition", thin_dim_decomposition);
+        amrex::ParmParse pp_amr("amr");
         if (pp_warpx.contains("numprocs"))
         {
-            amrex::ParmParse pp_amr("amr");
             pp_amr.add("blocking_factor", 1);
         }
+        else if (thin_dim_decomposition)
+        {
+            std::vector<int> n_cell;
+            pp_amr.queryarr("n_cell", n_cell);
+            std::vector<int> blocking_factor{8}; // AMReX' default
+            pp_amr.queryarr("blocking_factor", blocking_factor);
+            const std::array<std::string, 3> names{"blocking_factor_x", "blocking_factor_y",
+                                                   "blocking_factor_z"};
+            for (int idim = 0; idim < static_cast<int>(n_cell.size()) && idim < 3; ++idim) {
+                if (pp_amr.contains(names[idim].c_str())) continue;
+                pp_amr.add(names[idim].c_str(), std::gcd(blocking_factor[0], n_cell[idim]));
+            }
+        }
 
         // Here we override the default tiling option for particles, which is always
         // "false" in AMReX, to "false" if compiling for GPU execution and "true"
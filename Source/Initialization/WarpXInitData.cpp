@@ -21,6 +21,8 @@
 #include "Filter/BilinearFilter.H"
 #include "Filter/NCIGodfreyFilter.H"
 #include "Particles/MultiParticleContainer.H"
+#include "Parallelization/DomainLayout.H"
+#include "Parallelization/ThreadPlacement.H"
 #include "Parallelization/WarpXCommUtil.H"
 #include "Utils/MPIInitHelpers.H"
 #include "Utils/TextMsg.H"
@@ -50,6 +52,7 @@
 #include <AMReX_LayoutData.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_OpenMP.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Parser.H>
@@ -76,39 +79,23 @@ using namespace amrex;
 void
 WarpX::PostProcessBaseGrids (BoxArray& ba0) const
 {
+    const Box& dom = Geom(0).Domain();
     if (numprocs != 0) {
-        const Box& dom = Geom(0).Domain();
-        const IntVect& domlo = dom.smallEnd();
-        const IntVect& domlen = dom.size();
-        const IntVect sz = domlen / numprocs;
-        const IntVect extra = domlen - sz*numprocs;
-        BoxList bl;
-#if defined(WARPX_DIM_3D)
-        for (int k = 0; k < numprocs[2]; ++k) {
-            // The first extra[2] blocks get one extra cell with a total of
-            // sz[2]+1.  The rest get sz[2] cells.  The docomposition in y
-            // and x directions are similar.
-            int klo = (k < extra[2]) ? k*(sz[2]+1) : (k*sz[2]+extra[2]);
-            int khi = (k < extra[2]) ? klo+(sz[2]+1)-1 : klo+sz[2]-1;
-            klo += domlo[2];
-            khi += domlo[2];
-#endif
-#if (AMREX_SPACEDIM >= 2)
-            for (int j = 0; j < numprocs[1]; ++j) {
-                int jlo = (j < extra[1]) ? j*(sz[1]+1) : (j*sz[1]+extra[1]);
-                int jhi = (j < extra[1]) ? jlo+(sz[1]+1)-1 : jlo+sz[1]-1;
-                jlo += domlo[1];
-                jhi += domlo[1];
-#endif
-                for (int i = 0; i < numprocs[0]; ++i) {
-                    int ilo = (i < extra[0]) ? i*(sz[0]+1) : (i*sz[0]+extra[0]);
-                    int ihi = (i < extra[0]) ? ilo+(sz[0]+1)-1 : ilo+sz[0]-1;
-                    ilo += domlo[0];
-                    ihi += domlo[0];
-                    bl.push_back(Box(IntVect(AMREX_D_DECL(ilo,jlo,klo)),
-                                     IntVect(AMREX_D_DECL(ihi,jhi,khi))));
-        AMREX_D_TERM(},},})
-        ba0 = BoxArray(std::move(bl));
+        ba0 = DomainLayout::RegularDecomposition(dom, numprocs);
+    } else if (do_thin_dim_decomposition) {
+        // At least as many boxes as with max_grid_size, and one box per process,
+        // shaped so that the thin directions are not cut
+        const int nboxes = std::max(static_cast<int>(ba0.size()), ParallelDescriptor::NProcs());
+        const IntVect nboxes_dir = DomainLayout::MinimalSurfaceDecomposition(
+            dom, nboxes, m_thin_dims, maxGridSize(0), blockingFactor(0));
+        ba0 = DomainLayout::RegularDecomposition(dom, nboxes_dir, maxGridSize(0), blockingFactor(0));
+        const int nboxes_used = AMREX_D_TERM(nboxes_dir[0], *nboxes_dir[1], *nboxes_dir[2]);
+        if (nboxes_used != nboxes) {
+            WarpX::GetInstance().RecordWarning("Parallelization",
+                "warpx.thin_dim_decomposition: " + std::to_string(nboxes) + " boxes cannot be cut "
+                "from the domain with amr.max_grid_size and amr.blocking_factor, "
+                + std::to_string(nboxes_used) + " boxes are used instead");
+        }
     }
 }
 
@@ -305,6 +292,33 @@ WarpX::PrintMainPICparameters ()
 
     #endif // WARPX_USE_PSATD
     amrex::Print() << "-------------------------------------------------------------------------------" << "\n";
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+    // Print the placement of the OpenMP threads
+    ThreadPlacement::PrintReport();
+    amrex::Print() << "                      | - NUMA first touch = " << (do_numa_first_touch ? "ON" : "OFF") << "\n";
+    amrex::Print() << "-------------------------------------------------------------------------------\n";
+#endif
+    // Print the layout chosen for thin domains
+    if (do_thin_dim_decomposition) {
+      const BoxArray& ba = boxArray(0);
+      Box largest_box;
+      Long ncells = 0;
+      Long nguards = 0;
+      for (int i = 0; i < ba.size(); ++i) {
+        if (ba[i].numPts() > largest_box.numPts()) largest_box = ba[i];
+        ncells += ba[i].numPts();
+        nguards += amrex::grow(ba[i], guard_cells.ng_alloc_EB).numPts() - ba[i].numPts();
+      }
+      amrex::Print() << "Domain Decomposition: | " << ba.size() << " boxes on "
+                     << ParallelDescriptor::NProcs() << " MPI ranks \n";
+      amrex::Print() << "                      | - thin directions = " << m_thin_dims << "\n";
+      amrex::Print() << "                      | - largest box = " << largest_box.size() << "\n";
+      amrex::Print() << "                      | - tile size = " << FabArrayBase::mfiter_tile_size << "\n";
+      amrex::Print() << "                      | - ng_alloc_EB = " << guard_cells.ng_alloc_EB << "\n";
+      amrex::Print() << "                      | - guard/valid cells = "
+                     << static_cast<Real>(nguards)/static_cast<Real>(ncells) << "\n";
+      amrex::Print() << "-------------------------------------------------------------------------------\n";
+    }
     //Print main boosted frame algorithm's parameters
     if (WarpX::gamma_boost!=1){
     amrex::Print() << "Boosted Frame:        |    ON  \n";
@@ -375,10 +389,12 @@ WarpX::InitData ()
     }
 
     if (WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon) {
-        amrex::Print() << " calling london \n";
         m_london->InitData();
     }
 
+    // The static data of the checkpoint has been read
+    m_restart_static_dir.clear();
+
     InitDiagnostics();
 
     if (ParallelDescriptor::IOProcessor()) {
@@ -438,6 +454,7 @@ WarpX::InitDiagnostics () {
                                                particle_slice_width_lab);
     }
     reduced_diags->InitData();
+    if (!restart_chkfile.empty()) { ReadDiagnosticsCheckpointData(restart_chkfile); }
 }
 
 void
@@ -1168,6 +1185,9 @@ void WarpX::AverageParsedMtoFaces(MultiFab& Mx_cc,
                                   MultiFab& Mz_face)
 {
     // average Mx, My, Mz to faces
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
     for (MFIter mfi(Mx_face, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
         amrex::IntVect x_nodal_flag = Mx_face.ixType().toIntVect();
         amrex::IntVect y_nodal_flag = My_face.ixType().toIntVect();
@@ -1225,6 +1245,9 @@ WarpX::InitializeExternalFieldsOnGridUsingParser (
     // Number of multifab components
 #ifdef WARPX_MAG_LLG
     int ncomp = mfx->nComp();
+#endif
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
     for ( MFIter mfi(*mfx, TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
@@ -1414,6 +1437,29 @@ WarpX::PerformanceHints ()
         WarpX::GetInstance().RecordWarning("Performance", warnMsg.str(), WarnPriority::high);
     }
 
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+    // Check the placement of the OpenMP threads
+    if (amrex::OpenMP::get_max_threads() > 1) {
+        amrex::Vector<int> cpus, nodes;
+        ThreadPlacement::Query(cpus, nodes);
+        int max_nodes_per_rank = ThreadPlacement::NumNodes(nodes);
+        ParallelDescriptor::ReduceIntMax(max_nodes_per_rank);
+        if (!ThreadPlacement::ThreadsAreBound()) {
+            WarpX::GetInstance().RecordWarning("Performance",
+                "The OpenMP threads are not bound to CPUs and may migrate between sockets.\n"
+                "  Consider setting OMP_PROC_BIND=spread and OMP_PLACES=cores.");
+        }
+        if (max_nodes_per_rank > 1 && !do_numa_first_touch) {
+            std::stringstream warnMsg;
+            warnMsg << "The OpenMP threads of an MPI rank run on " << max_nodes_per_rank
+                    << " NUMA nodes, but the fields are not placed on the NUMA node of the threads "
+                    << "that update them.\n"
+                    << "  Consider warpx.numa_first_touch = 1, or one MPI rank per NUMA node.";
+            WarpX::GetInstance().RecordWarning("Performance", warnMsg.str());
+        }
+    }
+#endif
+
     // TODO: warn if some ranks have disproportionally more work than all others
     //       tricky: it can be ok to assign "vacuum" boxes to some ranks w/o slowing down
     //               all other ranks; we need to measure this with our load-balancing
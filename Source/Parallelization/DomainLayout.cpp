@@ -0,0 +1,194 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "DomainLayout.H"
+
+#include <AMReX_BoxList.H>
+#include <AMReX_SPACE.H>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace
+{
+    /** Blocking factor along idim, reduced to its largest divisor that divides the number
+     *  of cells of the domain */
+    int EffectiveBlockingFactor (const amrex::Box& domain, int idim,
+                                 const amrex::IntVect& blocking_factor)
+    {
+        return std::gcd(std::max(blocking_factor[idim], 1), domain.length(idim));
+    }
+
+    /** Smallest and largest numbers of boxes along idim such that the boxes of
+     *  RegularDecomposition have at most max_grid_size cells and at least one block */
+    std::pair<int,int> BoxCountRange (const amrex::Box& domain, int idim,
+                                      const amrex::IntVect& max_grid_size,
+                                      const amrex::IntVect& blocking_factor)
+    {
+        const int bf = EffectiveBlockingFactor(domain, idim, blocking_factor);
+        const int nblocks = domain.length(idim) / bf;
+        // A box has ceil(nblocks/n) blocks at most
+        const int max_blocks_per_box = std::max(max_grid_size[idim] / bf, 1);
+        const int nmin = (nblocks + max_blocks_per_box - 1) / max_blocks_per_box;
+        return {nmin, nblocks};
+    }
+
+    /** Recursively try all the numbers of boxes along the directions dir and above whose
+     *  product is remaining, and keep the one with the smallest total face area in best */
+    void SearchDecomposition (const amrex::Box& domain, const amrex::IntVect& thin,
+                              const amrex::IntVect& nmin, const amrex::IntVect& nmax, int dir,
+                              int remaining, amrex::IntVect& n, amrex::IntVect& best,
+                              double& best_area)
+    {
+        if (dir == AMREX_SPACEDIM - 1) {
+            n[dir] = remaining;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                if (n[idim] < nmin[idim] || n[idim] > nmax[idim]) return;
+            }
+            // Each cut along idim adds two faces of the area of the domain cross-section
+            double area = 0.;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                double cross_section = 1.;
+                for (int jdim = 0; jdim < AMREX_SPACEDIM; ++jdim) {
+                    if (jdim != idim) cross_section *= domain.length(jdim);
+                }
+                area += n[idim] * cross_section;
+            }
+            if (area < best_area) {
+                best_area = area;
+                best = n;
+            }
+            return;
+        }
+        for (int nd = nmin[dir]; nd <= std::min(remaining, nmax[dir]); ++nd) {
+            if (remaining % nd != 0) continue;
+            n[dir] = nd;
+            SearchDecomposition(domain, thin, nmin, nmax, dir+1, remaining/nd, n, best, best_area);
+        }
+    }
+}
+
+namespace DomainLayout
+{
+
+amrex::IntVect
+ThinDirections (const amrex::Box& domain, int max_thin_cells)
+{
+    amrex::IntVect thin(0);
+    const int longest = domain.longside();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (domain.length(idim) <= max_thin_cells && domain.length(idim) < longest) {
+            thin[idim] = 1;
+        }
+    }
+    return thin;
+}
+
+amrex::IntVect
+MinimalSurfaceDecomposition (const amrex::Box& domain, int nboxes, const amrex::IntVect& thin,
+                             const amrex::IntVect& max_grid_size,
+                             const amrex::IntVect& blocking_factor)
+{
+    // Range of the number of boxes along each direction, thin directions being only cut
+    // if they have more than max_grid_size cells
+    amrex::IntVect nmin(1), nmax(1);
+    long total_min = 1, total_max = 1;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const auto range = BoxCountRange(domain, idim, max_grid_size, blocking_factor);
+        nmin[idim] = range.first;
+        nmax[idim] = thin[idim] ? range.first : range.second;
+        total_min *= nmin[idim];
+        total_max *= nmax[idim];
+    }
+
+    // Closest number of boxes with a factorization in these ranges, the larger one first
+    const long nboxes_clamped = std::min(std::max(static_cast<long>(nboxes), total_min), total_max);
+    for (long dist = 0; dist <= total_max - total_min; ++dist) {
+        for (const long nb : {nboxes_clamped + dist, nboxes_clamped - dist}) {
+            if (nb < total_min || nb > total_max) continue;
+            amrex::IntVect n(1);
+            amrex::IntVect best(0);
+            double best_area = std::numeric_limits<double>::max();
+            SearchDecomposition(domain, thin, nmin, nmax, 0, static_cast<int>(nb), n, best, best_area);
+            if (best != amrex::IntVect(0)) return best;
+        }
+    }
+    // nmin is always a solution
+    return nmin;
+}
+
+amrex::BoxArray
+RegularDecomposition (const amrex::Box& domain, const amrex::IntVect& nboxes_in,
+                      const amrex::IntVect& max_grid_size, const amrex::IntVect& blocking_factor)
+{
+    const amrex::IntVect& domlo = domain.smallEnd();
+    // The domain is cut in blocks of bf cells
+    amrex::IntVect bf, nblocks, nboxes;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        bf[idim] = EffectiveBlockingFactor(domain, idim, blocking_factor);
+        nblocks[idim] = domain.length(idim) / bf[idim];
+        const auto range = BoxCountRange(domain, idim, max_grid_size, blocking_factor);
+        nboxes[idim] = std::min(std::max(nboxes_in[idim], range.first), range.second);
+    }
+    const amrex::IntVect sz = nblocks / nboxes;
+    const amrex::IntVect extra = nblocks - sz*nboxes;
+    const int ntot = AMREX_D_TERM(nboxes[0], *nboxes[1], *nboxes[2]);
+
+    amrex::BoxList bl;
+    for (int ib = 0; ib < ntot; ++ib) {
+        amrex::IntVect small, big;
+        int rest = ib;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            // Index of the box along idim, the boxes being ordered with x fastest
+            const int i = rest % nboxes[idim];
+            rest /= nboxes[idim];
+            // The first extra[idim] boxes get one extra block with a total of
+            // sz[idim]+1. The rest get sz[idim] blocks.
+            const int ilo = (i < extra[idim]) ? i*(sz[idim]+1) : (i*sz[idim]+extra[idim]);
+            const int ihi = (i < extra[idim]) ? ilo+(sz[idim]+1)-1 : ilo+sz[idim]-1;
+            small[idim] = domlo[idim] + ilo*bf[idim];
+            big[idim] = domlo[idim] + (ihi+1)*bf[idim] - 1;
+        }
+        bl.push_back(amrex::Box(small, big));
+    }
+    return amrex::BoxArray(std::move(bl));
+}
+
+amrex::IntVect
+TileSize (const amrex::Box& bx, const amrex::IntVect& thin,
+          const amrex::IntVect& default_tile, int nthreads)
+{
+    amrex::IntVect tile = default_tile;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (thin[idim]) tile[idim] = std::max(tile[idim], bx.length(idim));
+    }
+
+    // Longest direction that is tiled
+    int split_dir = -1;
+    for (int idim = 1; idim < AMREX_SPACEDIM; ++idim) {
+        if (!thin[idim] && (split_dir < 0 || bx.length(idim) > bx.length(split_dir))) {
+            split_dir = idim;
+        }
+    }
+    if (split_dir < 0 || nthreads <= 1) return tile;
+
+    const int len = bx.length(split_dir);
+    long best_load = std::numeric_limits<long>::max();
+    for (int t = 4; t <= std::min(2*default_tile[split_dir], len); ++t) {
+        const long ntiles = (len + t - 1) / t;
+        // Number of cells along split_dir updated by the thread with the most tiles
+        const long load = ((ntiles + nthreads - 1) / nthreads) * t;
+        if (load <= best_load) {
+            best_load = load;
+            tile[split_dir] = t;
+        }
+    }
+    return tile;
+}
+
+}
@@ -53,7 +53,9 @@ guardCellManager::Init (
     const bool do_pml,
     const int do_pml_in_domain,
     const int pml_ncell,
-    const amrex::Vector<amrex::IntVect>& ref_ratios)
+    const amrex::Vector<amrex::IntVect>& ref_ratios,
+    const bool do_mag_exchange_coupling,
+    const amrex::IntVect& reduced_halo_dims)
 {
 #ifdef WARPX_MAG_LLG
     amrex::ignore_unused(do_multi_J, fft_do_time_averaging);
@@ -127,6 +129,25 @@ guardCellManager::Init (
     ng_alloc_J = IntVect(ngJz);
 #endif
 
+    // Along thin periodic directions that are not cut (warpx.thin_dim_reduced_halo), the guard
+    // cells are periodic images of the box itself and, with a single level, do not need to
+    // be an even number for the interpolation between levels. Only the rounding up of the
+    // guard cells of the particle shape is removed: the stencil of the field solver, applied
+    // below, is still a lower bound, so that runs without particles save nothing.
+#if defined(WARPX_DIM_3D)
+    const IntVect ng_shape = IntVect(ngx_tmp,ngy_tmp,ngz_tmp);
+#elif defined(WARPX_DIM_XZ) || defined(WARPX_DIM_RZ)
+    const IntVect ng_shape = IntVect(ngx_tmp,ngz_tmp);
+#elif defined(WARPX_DIM_1D_Z)
+    const IntVect ng_shape = IntVect(ngz_tmp);
+#endif
+    for (int i_dim = 0; i_dim < AMREX_SPACEDIM; i_dim++) {
+        if (!reduced_halo_dims[i_dim] || do_moving_window) continue;
+        int ng_reduced = ng_shape[i_dim];
+        if (do_fdtd_nci_corr && i_dim == WARPX_ZINDEX) ng_reduced += nci_corr_stencil;
+        ng_alloc_EB[i_dim] = std::min(ng_alloc_EB[i_dim], ng_reduced);
+    }
+
     // TODO Adding one cell for rho should not be necessary, given that the number of guard cells
     // now takes into account the time step (see code block below). However, this does seem to be
     // necessary in order to avoid some remaining instances of out-of-bound array access in
@@ -280,6 +301,26 @@ guardCellManager::Init (
     ng_alloc_F.max( ng_FieldSolverF );
     ng_alloc_G.max( ng_FieldSolverG );
 
+#ifdef WARPX_MAG_LLG
+    // H and M are not gathered by the particles: their guard cells are only read by the
+    // curl of the E push and the face averages of the M push (H), and by the Laplacian of
+    // the exchange coupling term (M). The field probes gather them with an order of at
+    // most the particle shape (nox is 0 without particles or lasers).
+    const IntVect ng_probe = IntVect(AMREX_D_DECL(nox,nox,nox));
+    ng_alloc_H = ng_FieldSolver;
+    ng_alloc_H.max( ng_probe );
+    ng_alloc_M = (do_mag_exchange_coupling) ? ng_FieldSolver : IntVect::TheZeroVector();
+    ng_alloc_M.max( ng_probe );
+    // The interpolation between levels and the moving window need as many
+    // guard cells as for E and B
+    if (max_level > 0 || do_moving_window) {
+        ng_alloc_H = ng_alloc_EB;
+        ng_alloc_M = ng_alloc_EB;
+    }
+#else
+    amrex::ignore_unused(do_mag_exchange_coupling);
+#endif
+
     if (do_moving_window && maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
         ng_afterPushPSATD = ng_alloc_EB;
     }
@@ -0,0 +1,137 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "ThreadPlacement.H"
+
+#include <AMReX_GpuControl.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_Print.H>
+
+#ifdef AMREX_USE_OMP
+#   include <omp.h>
+#endif
+
+#if defined(__linux__)
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+#include <cstdlib>
+#include <set>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    /** CPU and NUMA node of the calling thread, -1 if unknown */
+    void GetCpu (int& cpu, int& node)
+    {
+        cpu = -1;
+        node = -1;
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned int c = 0, n = 0;
+        if (syscall(SYS_getcpu, &c, &n, nullptr) == 0) {
+            cpu = static_cast<int>(c);
+            node = static_cast<int>(n);
+        }
+#endif
+    }
+
+    /** Value of the environment variable name, or "unset" */
+    std::string EnvOrUnset (const char* name)
+    {
+        const char* value = std::getenv(name);
+        return value ? std::string(value) : std::string("unset");
+    }
+}
+
+namespace ThreadPlacement
+{
+
+void
+Query (amrex::Vector<int>& cpus, amrex::Vector<int>& nodes)
+{
+    const int nthreads = amrex::OpenMP::get_max_threads();
+    cpus.assign(nthreads, -1);
+    nodes.assign(nthreads, -1);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel num_threads(nthreads)
+#endif
+    {
+        const int ithread = amrex::OpenMP::get_thread_num();
+        GetCpu(cpus[ithread], nodes[ithread]);
+    }
+}
+
+int
+NumNodes (amrex::Vector<int> const& nodes)
+{
+    std::set<int> distinct;
+    for (const int node : nodes) {
+        if (node >= 0) distinct.insert(node);
+    }
+    return static_cast<int>(distinct.size());
+}
+
+bool
+ThreadsAreBound ()
+{
+#ifdef AMREX_USE_OMP
+    return omp_get_proc_bind() != omp_proc_bind_false;
+#else
+    return true;
+#endif
+}
+
+void
+PrintReport ()
+{
+    amrex::Vector<int> cpus, nodes;
+    Query(cpus, nodes);
+
+    int max_nodes_per_rank = NumNodes(nodes);
+    amrex::ParallelDescriptor::ReduceIntMax(max_nodes_per_rank);
+
+    std::stringstream placement;
+    for (int ithread = 0; ithread < static_cast<int>(cpus.size()); ++ithread) {
+        if (ithread > 0) placement << " ";
+        placement << cpus[ithread] << "(" << nodes[ithread] << ")";
+    }
+
+    amrex::Print() << "OpenMP threads:       | " << cpus.size() << " per MPI rank\n";
+    amrex::Print() << "                      | - OMP_PROC_BIND = " << EnvOrUnset("OMP_PROC_BIND")
+                   << ", OMP_PLACES = " << EnvOrUnset("OMP_PLACES")
+                   << (ThreadsAreBound() ? " (bound)" : " (not bound)") << "\n";
+    amrex::Print() << "                      | - CPU(NUMA node) of the threads of rank "
+                   << amrex::ParallelDescriptor::IOProcessorNumber() << ": " << placement.str() << "\n";
+    amrex::Print() << "                      | - max. NUMA nodes used by one rank = "
+                   << max_nodes_per_rank << "\n";
+}
+
+void
+FirstTouch (amrex::MultiFab& mf)
+{
+    const amrex::IntVect ng = mf.nGrowVect();
+    const int ncomp = mf.nComp();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (amrex::MFIter mfi(mf, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        // The guard cells belong to the tiles at the edges of the box
+        const amrex::Box& bx = mfi.growntilebox(ng);
+        amrex::Array4<amrex::Real> const& arr = mf.array(mfi);
+        amrex::ParallelFor(bx, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                arr(i,j,k,n) = amrex::Real(0.);
+            });
+    }
+}
+
+}
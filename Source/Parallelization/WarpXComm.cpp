@@ -473,6 +473,52 @@ WarpX::FillBoundaryE (IntVect ng)
     }
 }
 
+void
+WarpX::FillBoundaryB_nowait (IntVect ng)
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        FillBoundaryB(lev, PatchType::fine, ng, true);
+        if (lev > 0) FillBoundaryB(lev, PatchType::coarse, ng, true);
+    }
+}
+
+void
+WarpX::FillBoundaryB_finish ()
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            WarpXCommUtil::FillBoundary_finish(*Bfield_fp[lev][i]);
+            if (lev > 0) WarpXCommUtil::FillBoundary_finish(*Bfield_cp[lev][i]);
+        }
+    }
+}
+
+void
+WarpX::FillBoundaryE_nowait (IntVect ng)
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        FillBoundaryE(lev, PatchType::fine, ng, true);
+        if (lev > 0) FillBoundaryE(lev, PatchType::coarse, ng, true);
+    }
+}
+
+void
+WarpX::FillBoundaryE_finish ()
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            WarpXCommUtil::FillBoundary_finish(*Efield_fp[lev][i]);
+            if (lev > 0) WarpXCommUtil::FillBoundary_finish(*Efield_cp[lev][i]);
+        }
+    }
+}
+
 void
 WarpX::FillBoundaryF (IntVect ng)
 {
@@ -573,7 +619,8 @@ WarpX::FillBoundaryE(int lev, IntVect ng)
 }
 
 void
-WarpX::FillBoundaryE (const int lev, const PatchType patch_type, const amrex::IntVect ng)
+WarpX::FillBoundaryE (const int lev, const PatchType patch_type, const amrex::IntVect ng,
+                      const bool nowait)
 {
     std::array<amrex::MultiFab*,3> mf;
     amrex::Periodicity period;
@@ -618,7 +665,11 @@ WarpX::FillBoundaryE (const int lev, const PatchType patch_type, const amrex::In
             "Error: in FillBoundaryE, requested more guard cells than allocated");
 
         const amrex::IntVect nghost = (safe_guard_cells) ? mf[i]->nGrowVect() : ng;
-        WarpXCommUtil::FillBoundary(*mf[i], nghost, period);
+        if (nowait) {
+            WarpXCommUtil::FillBoundary_nowait(*mf[i], nghost, period);
+        } else {
+            WarpXCommUtil::FillBoundary(*mf[i], nghost, period);
+        }
     }
 }
 
@@ -630,7 +681,8 @@ WarpX::FillBoundaryB (int lev, IntVect ng)
 }
 
 void
-WarpX::FillBoundaryB (const int lev, const PatchType patch_type, const amrex::IntVect ng)
+WarpX::FillBoundaryB (const int lev, const PatchType patch_type, const amrex::IntVect ng,
+                      const bool nowait)
 {
     std::array<amrex::MultiFab*,3> mf;
     amrex::Periodicity period;
@@ -675,7 +727,11 @@ WarpX::FillBoundaryB (const int lev, const PatchType patch_type, const amrex::In
             "Error: in FillBoundaryB, requested more guard cells than allocated");
 
         const amrex::IntVect nghost = (safe_guard_cells) ? mf[i]->nGrowVect() : ng;
-        WarpXCommUtil::FillBoundary(*mf[i], nghost, period);
+        if (nowait) {
+            WarpXCommUtil::FillBoundary_nowait(*mf[i], nghost, period);
+        } else {
+            WarpXCommUtil::FillBoundary(*mf[i], nghost, period);
+        }
     }
 }
 
@@ -697,7 +753,8 @@ WarpX::FillBoundaryM (int lev, IntVect ng)
 }
 
 void
-WarpX::FillBoundaryM (int lev, PatchType patch_type, IntVect ng)
+WarpX::FillBoundaryM (const int lev, const PatchType patch_type, const amrex::IntVect ng,
+                      const bool nowait)
 {
     std::array<amrex::MultiFab*,3> mf;
     amrex::Periodicity period;
@@ -720,14 +777,39 @@ WarpX::FillBoundaryM (int lev, PatchType patch_type, IntVect ng)
     // Fill guard cells in valid domain
     for (int i = 0; i < 3; ++i)
     {
-        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-            ng <= mf[i]->nGrowVect(),
-            "Error: in FillBoundaryM, requested more guard cells than allocated");
+        // M may have fewer guard cells than E and B (see guardCellManager::ng_alloc_M),
+        // in which case only its allocated guard cells are filled
+        const amrex::IntVect nghost = (safe_guard_cells) ?
+            mf[i]->nGrowVect() : amrex::min(ng, mf[i]->nGrowVect());
+        if (nowait) {
+            WarpXCommUtil::FillBoundary_nowait(*mf[i], nghost, period);
+        } else {
+            WarpXCommUtil::FillBoundary(*mf[i], nghost, period);
+        }
+    }
 
-        const amrex::IntVect nghost = (safe_guard_cells) ? mf[i]->nGrowVect() : ng;
-        WarpXCommUtil::FillBoundary(*mf[i], nghost, period);
+}
+
+void
+WarpX::FillBoundaryM_nowait (IntVect ng)
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        FillBoundaryM(lev, PatchType::fine, ng, true);
+        if (lev > 0) FillBoundaryM(lev, PatchType::coarse, ng, true);
     }
+}
 
+void
+WarpX::FillBoundaryM_finish ()
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            WarpXCommUtil::FillBoundary_finish(*Mfield_fp[lev][i]);
+        }
+    }
 }
 
 void
@@ -747,7 +829,8 @@ WarpX::FillBoundaryH (int lev, IntVect ng)
 }
 
 void
-WarpX::FillBoundaryH (int lev, PatchType patch_type, IntVect ng)
+WarpX::FillBoundaryH (const int lev, const PatchType patch_type, const amrex::IntVect ng,
+                      const bool nowait)
 {
     std::array<amrex::MultiFab*,3> mf;
     amrex::Periodicity period;
@@ -779,14 +862,39 @@ WarpX::FillBoundaryH (int lev, PatchType patch_type, IntVect ng)
     // Fill guard cells in valid domain
     for (int i = 0; i < 3; ++i)
     {
-        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-            ng <= mf[i]->nGrowVect(),
-            "Error: in FillBoundaryH, requested more guard cells than allocated");
+        // H may have fewer guard cells than E and B (see guardCellManager::ng_alloc_H),
+        // in which case only its allocated guard cells are filled
+        const amrex::IntVect nghost = (safe_guard_cells) ?
+            mf[i]->nGrowVect() : amrex::min(ng, mf[i]->nGrowVect());
+        if (nowait) {
+            WarpXCommUtil::FillBoundary_nowait(*mf[i], nghost, period);
+        } else {
+            WarpXCommUtil::FillBoundary(*mf[i], nghost, period);
+        }
+    }
 
-        const amrex::IntVect nghost = (safe_guard_cells) ? mf[i]->nGrowVect() : ng;
-        WarpXCommUtil::FillBoundary(*mf[i], nghost, period);
+}
+
+void
+WarpX::FillBoundaryH_nowait (IntVect ng)
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        FillBoundaryH(lev, PatchType::fine, ng, true);
+        if (lev > 0) FillBoundaryH(lev, PatchType::coarse, ng, true);
     }
+}
 
+void
+WarpX::FillBoundaryH_finish ()
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            WarpXCommUtil::FillBoundary_finish(*Hfield_fp[lev][i]);
+        }
+    }
 }
 #endif
 
@@ -6,13 +6,190 @@
  */
 #include "WarpXCommUtil.H"
 
+#include "ablastr/profiler/ProfilerWrapper.H"
+
 #include <AMReX.H>
 #include <AMReX_BaseFab.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
+#include <AMReX_DistributionMapping.H>
 #include <AMReX_IntVect.H>
 #include <AMReX_FabArray.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_Loop.H>
+#include <AMReX_MFIter.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_TagParallelFor.H>
 #include <AMReX_iMultiFab.H>
 
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using CommFabArray = amrex::FabArray<amrex::BaseFab<WarpXCommUtil::comm_float_type> >;
+
+    struct CommBuffer
+    {
+        std::unique_ptr<CommFabArray> fab;
+        //! Number of guard cells and periodicity of the exchange started with FillBoundary_nowait
+        amrex::IntVect ng = amrex::IntVect::TheZeroVector();
+        amrex::Periodicity period = amrex::Periodicity::NonPeriodic();
+    };
+
+    /** Single-precision copies of the MultiFabs whose exchange was started with
+     *  FillBoundary_nowait, removed by FillBoundary_finish */
+    std::map<amrex::MultiFab const*, CommBuffer> pending_exchanges;
+
+    /** Valid cells of box i of ba that FillBoundary may send to the ng guard cells of the
+     *  other boxes: the cells within ng of the box boundaries, and within ng+1 along the
+     *  nodal directions, where the boundary points are shared with the neighbors */
+    amrex::BoxList SentCells (amrex::BoxArray const& ba, int i, amrex::IntVect const& ng)
+    {
+        const amrex::Box& vbx = ba[i];
+        const amrex::IntVect width = ng + vbx.type();
+        amrex::BoxList bl(vbx.ixType());
+        for (amrex::Box const& bx : amrex::boxDiff(vbx, amrex::grow(vbx, -width))) {
+            bl.push_back(bx);
+        }
+        return bl;
+    }
+
+    /** Guard cells of box i of ba that FillBoundary fills: the guard cells within ng that
+     *  overlap another box or a periodic image of a box. The other guard cells (physical
+     *  domain boundaries, PML) are left untouched by FillBoundary. */
+    amrex::BoxList ReceivedCells (amrex::BoxArray const& ba, int i, amrex::IntVect const& ng,
+                                  amrex::Periodicity const& period)
+    {
+        const amrex::Box& vbx = ba[i];
+        const amrex::Box gbx = amrex::grow(vbx, ng);
+        amrex::BoxList bl(vbx.ixType());
+        std::vector<std::pair<int,amrex::Box> > isects;
+        for (amrex::IntVect const& shift : period.shiftIntVect()) {
+            ba.intersections(gbx + shift, isects);
+            for (auto const& isect : isects) {
+                if (isect.first == i && shift == amrex::IntVect::TheZeroVector()) continue;
+                for (amrex::Box const& bx : amrex::boxDiff(isect.second - shift, vbx)) {
+                    bl.push_back(bx);
+                }
+            }
+        }
+        return bl;
+    }
+
+    /** Cells exchanged by FillBoundary(ng, period) for a BoxArray and a DistributionMapping */
+    struct ExchangedCells
+    {
+        //! Copies of the BoxArray and DistributionMapping, whose references keep their ids unique
+        amrex::BoxArray ba;
+        amrex::DistributionMapping dm;
+        amrex::IntVect ng;
+        amrex::IntVect period;
+        bool received;
+        //! Boxes of the exchanged cells of each local box, indexed by MFIter::LocalIndex
+        amrex::Vector<amrex::Vector<amrex::Box> > boxes;
+    };
+
+    /** Exchanged cells of the last BoxArrays and DistributionMappings, cleared by
+     *  WarpXCommUtil::ClearExchangedCellsCache when the grids change */
+    std::vector<ExchangedCells> exchanged_cells_cache;
+
+    /** Maximum number of entries of exchanged_cells_cache, the oldest one is removed first */
+    constexpr int max_exchanged_cells_cache_size = 64;
+
+    /** Cached exchanged cells of the local boxes of fa, see MixedCopyExchanged */
+    template <class FAB>
+    amrex::Vector<amrex::Vector<amrex::Box> > const&
+    GetExchangedCells (amrex::FabArray<FAB> const& fa, amrex::IntVect const& ng,
+                       amrex::Periodicity const& period, bool received)
+    {
+        const amrex::BoxArray& ba = fa.boxArray();
+        const amrex::DistributionMapping& dm = fa.DistributionMap();
+        // The BoxArrays of different index types or coarsening ratios share their id
+        for (auto const& cells : exchanged_cells_cache) {
+            if (cells.ba.getRefID() == ba.getRefID() && cells.dm.getRefID() == dm.getRefID()
+                && cells.ba.ixType() == ba.ixType() && cells.ba.crseRatio() == ba.crseRatio()
+                && cells.ng == ng && cells.period == period.intVect()
+                && cells.received == received) {
+                return cells.boxes;
+            }
+        }
+
+        if (static_cast<int>(exchanged_cells_cache.size()) >= max_exchanged_cells_cache_size) {
+            exchanged_cells_cache.erase(exchanged_cells_cache.begin());
+        }
+
+        ExchangedCells cells{ba, dm, ng, period.intVect(), received, {}};
+        cells.boxes.resize(fa.local_size());
+        for (amrex::MFIter mfi(fa); mfi.isValid(); ++mfi)
+        {
+            const int i = mfi.index();
+            const amrex::BoxList bl = received ? ReceivedCells(ba, i, ng, period)
+                                               : SentCells(ba, i, ng);
+            cells.boxes[mfi.LocalIndex()] = bl.data();
+        }
+        exchanged_cells_cache.push_back(std::move(cells));
+        return exchanged_cells_cache.back().boxes;
+    }
+
+    /** \brief Copy the cells of src that are exchanged by FillBoundary(ng, period) to dst.
+     *  On GPU, the cells of all the local boxes are copied in a single kernel.
+     *
+     * \param[in] received copy the guard cells that FillBoundary fills if true, the valid
+     *                     cells that it may send otherwise
+     */
+    template <class FAB1, class FAB2>
+    void MixedCopyExchanged (amrex::FabArray<FAB1>& dst, amrex::FabArray<FAB2> const& src,
+                             amrex::IntVect const& ng, amrex::Periodicity const& period,
+                             bool received)
+    {
+        using T1 = typename FAB1::value_type;
+        using T2 = typename FAB2::value_type;
+        const int ncomp = dst.nComp();
+        auto const& cells = GetExchangedCells(dst, ng, period, received);
+#ifdef AMREX_USE_GPU
+        if (amrex::Gpu::inLaunchRegion())
+        {
+            amrex::Vector<amrex::Array4CopyTag<T1, T2> > tags;
+            for (amrex::MFIter mfi(dst); mfi.isValid(); ++mfi)
+            {
+                auto const& d = dst.array(mfi);
+                auto const& s = src.const_array(mfi);
+                for (amrex::Box const& bx : cells[mfi.LocalIndex()]) {
+                    tags.push_back({d, s, bx, amrex::Dim3{0,0,0}});
+                }
+            }
+            amrex::ParallelFor(tags, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n,
+                                  amrex::Array4CopyTag<T1, T2> const& tag) noexcept
+            {
+                tag.dfab(i,j,k,n) = static_cast<T1>(tag.sfab(i,j,k,n));
+            });
+            amrex::Gpu::synchronize();
+        }
+        else
+#endif
+        {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+            for (amrex::MFIter mfi(dst); mfi.isValid(); ++mfi)
+            {
+                auto const& d = dst.array(mfi);
+                auto const& s = src.const_array(mfi);
+                for (amrex::Box const& bx : cells[mfi.LocalIndex()]) {
+                    amrex::LoopConcurrentOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+                    {
+                        d(i,j,k,n) = static_cast<T1>(s(i,j,k,n));
+                    });
+                }
+            }
+        }
+    }
+}
+
 namespace WarpXCommUtil {
 
 void ParallelCopy (amrex::MultiFab&            dst,
@@ -25,7 +202,7 @@ void ParallelCopy (amrex::MultiFab&            dst,
                    const amrex::Periodicity&   period,
                    amrex::FabArrayBase::CpOp   op)
 {
-    BL_PROFILE("WarpXCommUtil::ParallelCopy");
+    ABLASTR_PROFILE("WarpXCommUtil::ParallelCopy", false);
 
     using WarpXCommUtil::comm_float_type;
 
@@ -70,45 +247,30 @@ void ParallelAdd (amrex::MultiFab&            dst,
 
 void FillBoundary (amrex::MultiFab& mf, const amrex::Periodicity& period)
 {
-    BL_PROFILE("WarpXCommUtil::FillBoundary");
-
-    if (WarpX::do_single_precision_comms)
-    {
-        amrex::FabArray<amrex::BaseFab<comm_float_type> > mf_tmp(mf.boxArray(),
-                                                                 mf.DistributionMap(),
-                                                                 mf.nComp(),
-                                                                 mf.nGrowVect());
-
-        mixedCopy(mf_tmp, mf, 0, 0, mf.nComp(), mf.nGrowVect());
-
-        mf_tmp.FillBoundary(period);
-
-        mixedCopy(mf, mf_tmp, 0, 0, mf.nComp(), mf.nGrowVect());
-    }
-    else
-    {
-        mf.FillBoundary(period);
-    }
+    WarpXCommUtil::FillBoundary(mf, mf.nGrowVect(), period);
 }
 
 void FillBoundary (amrex::MultiFab&          mf,
                    amrex::IntVect            ng,
                    const amrex::Periodicity& period)
 {
-    BL_PROFILE("WarpXCommUtil::FillBoundary");
+    ABLASTR_PROFILE("WarpXCommUtil::FillBoundary", false);
+
+    // Nothing to exchange, e.g. for fields allocated without guard cells
+    if (ng == amrex::IntVect::TheZeroVector()) return;
 
     if (WarpX::do_single_precision_comms)
     {
-        amrex::FabArray<amrex::BaseFab<comm_float_type> > mf_tmp(mf.boxArray(),
-                                                            mf.DistributionMap(),
-                                                            mf.nComp(),
-                                                            mf.nGrowVect());
+        // Only the valid cells that are sent and the guard cells that are
+        // received are converted, the other cells keep their full precision.
+        // The copy only lives for the exchange (its memory is recycled by the arena).
+        CommFabArray mf_tmp(mf.boxArray(), mf.DistributionMap(), mf.nComp(), ng);
 
-        mixedCopy(mf_tmp, mf, 0, 0, mf.nComp(), mf.nGrowVect());
+        MixedCopyExchanged(mf_tmp, mf, ng, period, false);
 
         mf_tmp.FillBoundary(ng, period);
 
-        mixedCopy(mf, mf_tmp, 0, 0, mf.nComp(), mf.nGrowVect());
+        MixedCopyExchanged(mf, mf_tmp, ng, period, true);
     }
     else
     {
@@ -118,7 +280,7 @@ void FillBoundary (amrex::MultiFab&          mf,
 
 void FillBoundary (amrex::iMultiFab& imf, const amrex::Periodicity& period)
 {
-    BL_PROFILE("WarpXCommUtil::FillBoundary");
+    ABLASTR_PROFILE("WarpXCommUtil::FillBoundary", false);
 
     imf.FillBoundary(period);
 }
@@ -127,7 +289,7 @@ void FillBoundary (amrex::iMultiFab&         imf,
                    amrex::IntVect            ng,
                    const amrex::Periodicity& period)
 {
-    BL_PROFILE("WarpXCommUtil::FillBoundary");
+    ABLASTR_PROFILE("WarpXCommUtil::FillBoundary", false);
     imf.FillBoundary(ng, period);
 }
 
@@ -139,9 +301,58 @@ FillBoundary (amrex::Vector<amrex::MultiFab*> const& mf, const amrex::Periodicit
     }
 }
 
+void FillBoundary_nowait (amrex::MultiFab&          mf,
+                          amrex::IntVect            ng,
+                          const amrex::Periodicity& period)
+{
+    ABLASTR_PROFILE("WarpXCommUtil::FillBoundary_nowait", false);
+
+    if (ng == amrex::IntVect::TheZeroVector()) return;
+
+    if (WarpX::do_single_precision_comms)
+    {
+        CommBuffer& buffer = pending_exchanges[&mf];
+        buffer.fab = std::make_unique<CommFabArray>(mf.boxArray(), mf.DistributionMap(),
+                                                    mf.nComp(), ng);
+        buffer.ng = ng;
+        buffer.period = period;
+        MixedCopyExchanged(*buffer.fab, mf, ng, period, false);
+        buffer.fab->FillBoundary_nowait(ng, period);
+    }
+    else
+    {
+        mf.FillBoundary_nowait(ng, period);
+    }
+}
+
+void FillBoundary_finish (amrex::MultiFab& mf)
+{
+    ABLASTR_PROFILE("WarpXCommUtil::FillBoundary_finish", false);
+
+    if (WarpX::do_single_precision_comms)
+    {
+        // No buffer if no exchange was started for mf
+        auto it = pending_exchanges.find(&mf);
+        if (it == pending_exchanges.end()) return;
+        CommBuffer& buffer = it->second;
+        buffer.fab->FillBoundary_finish();
+        MixedCopyExchanged(mf, *buffer.fab, buffer.ng, buffer.period, true);
+        pending_exchanges.erase(it);
+    }
+    else
+    {
+        mf.FillBoundary_finish();
+    }
+}
+
+void ClearExchangedCellsCache ()
+{
+    exchanged_cells_cache.clear();
+}
+
 void SumBoundary (amrex::MultiFab& mf, const amrex::Periodicity& period)
 {
-    BL_PROFILE("WarpXCommUtil::SumBoundary");
+    ABLASTR_PROFILE("WarpXCommUtil::SumBoundary", false);
 
     if (WarpX::do_single_precision_comms)
     {
@@ -168,7 +379,7 @@ void SumBoundary (amrex::MultiFab&          mf,
                   amrex::IntVect            ng,
                   const amrex::Periodicity& period)
 {
-    BL_PROFILE("WarpXCommUtil::SumBoundary");
+    ABLASTR_PROFILE("WarpXCommUtil::SumBoundary", false);
 
     if (WarpX::do_single_precision_comms)
     {
@@ -195,7 +406,7 @@ void SumBoundary (amrex::MultiFab&          mf,
                   amrex::IntVect            dst_ng,
                   const amrex::Periodicity& period)
 {
-    BL_PROFILE("WarpXCommUtil::SumBoundary");
+    ABLASTR_PROFILE("WarpXCommUtil::SumBoundary", false);
 
     if (WarpX::do_single_precision_comms)
     {
@@ -10,6 +10,7 @@
 
 #include "Diagnostics/MultiDiagnostics.H"
 #include "Diagnostics/ReducedDiags/MultiReducedDiags.H"
+#include "Parallelization/WarpXCommUtil.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Particles/ParticleBoundaryBuffer.H"
 #include "Particles/WarpXParticleContainer.H"
@@ -158,6 +159,14 @@ RemakeMultiFab (std::unique_ptr<MultiFabType>& mf, const DistributionMapping& dm
 void
 WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const DistributionMapping& dm)
 {
+    // The excitation source points are stored per box, they are rebuilt on new grids. The
+    // superconducting edges of the London solver are also stored per box.
+    if (ba != boxArray(lev) || dm != DistributionMap(lev)) {
+        ClearExcitationSources(lev);
+        if (m_london) m_london->Clear(lev);
+        WarpXCommUtil::ClearExchangedCellsCache();
+    }
+
     if (ba == boxArray(lev))
     {
         if (ParallelDescriptor::NProcs() == 1) return;
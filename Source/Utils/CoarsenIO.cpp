@@ -6,6 +6,7 @@
 #include <AMReX_BLassert.H>
 #include <AMReX_Box.H>
 #include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
 #include <AMReX_Config.H>
 #include <AMReX_DistributionMapping.H>
 #include <AMReX_FArrayBox.H>
@@ -15,6 +16,9 @@
 #include <AMReX_IndexType.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_Vector.H>
+
+#include <utility>
 
 using namespace amrex;
 
@@ -25,7 +29,8 @@ CoarsenIO::Loop ( MultiFab& mf_dst,
                   const int scomp,
                   const int ncomp,
                   const IntVect ngrowvect,
-                  const IntVect crse_ratio )
+                  const IntVect crse_ratio,
+                  const Vector<int>& src_index )
 {
     // Staggering of source fine MultiFab and destination coarse MultiFab
     const IntVect stag_src = mf_src.boxArray().ixType().toIntVect();
@@ -87,7 +92,8 @@ CoarsenIO::Loop ( MultiFab& mf_dst,
         // Tiles defined at the coarse level
         const Box& bx = mfi.growntilebox( ngrowvect );
         Array4<Real> const& arr_dst = mf_dst.array( mfi );
-        Array4<Real const> const& arr_src = mf_src.const_array( mfi );
+        Array4<Real const> const& arr_src = src_index.empty() ?
+            mf_src.const_array( mfi ) : mf_src.const_array( src_index[mfi.index()] );
         ParallelFor( bx, ncomp,
                      [=] AMREX_GPU_DEVICE( int i, int j, int k, int n )
                      {
@@ -138,10 +144,27 @@ CoarsenIO::Coarsen ( MultiFab& mf_dst,
     else
     {
         // Cannot coarsen into MultiFab with different BoxArray or DistributionMapping:
-        // 1) create temporary MultiFab on coarsened version of source BoxArray with same DistributionMapping
-        MultiFab mf_tmp( ba_tmp, mf_src.DistributionMap(), ncomp, 0, MFInfo(), FArrayBoxFactory() );
+        // 1) create temporary MultiFab on the parts of the coarsened source boxes that intersect
+        //    the destination, each owned by the MPI rank of its source box. When the destination
+        //    covers a small region of interest, this avoids a temporary on the full domain.
+        const Box dst_bounds = mf_dst.boxArray().minimalBox();
+        BoxList bl_tmp( mf_dst.ixType() );
+        Vector<int> procs_tmp;
+        Vector<int> src_index;
+        for (int i = 0; i < static_cast<int>(ba_tmp.size()); ++i) {
+            const Box bx = ba_tmp[i] & dst_bounds;
+            if (bx.ok()) {
+                bl_tmp.push_back( bx );
+                procs_tmp.push_back( mf_src.DistributionMap()[i] );
+                src_index.push_back( i );
+            }
+        }
+        if ( bl_tmp.isEmpty() ) return;
+        const BoxArray ba_roi( std::move(bl_tmp) );
+        const DistributionMapping dm_roi( std::move(procs_tmp) );
+        MultiFab mf_tmp( ba_roi, dm_roi, ncomp, 0, MFInfo(), FArrayBoxFactory() );
         // 2) interpolate from mf_src to mf_tmp (start writing into component 0)
-        CoarsenIO::Loop( mf_tmp, mf_src, 0, scomp, ncomp, ngrowvect, crse_ratio );
+        CoarsenIO::Loop( mf_tmp, mf_src, 0, scomp, ncomp, ngrowvect, crse_ratio, src_index );
         // 3) copy from mf_tmp to mf_dst (with different BoxArray or DistributionMapping)
         mf_dst.ParallelCopy( mf_tmp, 0, dcomp, ncomp );
     }
@@ -0,0 +1,381 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "VoxelMaterialMap.H"
+
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX.H>
+#include <AMReX_Array4.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define WARPX_VOXEL_MAP_USE_MMAP
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+using namespace amrex;
+using namespace amrex::literals;
+
+namespace
+{
+    /** Number of text lines of the header */
+    constexpr int header_lines = 4;
+}
+
+VoxelMaterialMap::VoxelMaterialMap ()
+{
+    ParmParse pp_map("material_map");
+    pp_map.get("file", m_file);
+    pp_map.getarr("materials", m_material_names);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!m_material_names.empty(),
+        "material_map.materials must contain at least one material");
+    ReadFile();
+}
+
+VoxelMaterialMap::~VoxelMaterialMap ()
+{
+#ifdef WARPX_VOXEL_MAP_USE_MMAP
+    if (m_file_data && m_buffer.empty()) {
+        munmap(const_cast<unsigned char*>(m_file_data), m_file_size);
+    }
+#endif
+}
+
+void
+VoxelMaterialMap::ReadFile ()
+{
+    WARPX_PROFILE("VoxelMaterialMap::ReadFile()");
+
+    // Only the pages that are read are loaded from the file system, hence each MPI rank
+    // only loads the voxels under its boxes, and the ranks of a node share the pages.
+#ifdef WARPX_VOXEL_MAP_USE_MMAP
+    const int fd = open(m_file.c_str(), O_RDONLY);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(fd >= 0, "Could not open material_map.file " + m_file);
+    struct stat file_stat;
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(fstat(fd, &file_stat) == 0,
+        "Could not stat material_map.file " + m_file);
+    m_file_size = static_cast<std::size_t>(file_stat.st_size);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_file_size > 0, "material_map.file " + m_file + " is empty");
+    void* const addr = mmap(nullptr, m_file_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(addr != MAP_FAILED, "Could not map material_map.file " + m_file);
+    m_file_data = static_cast<unsigned char const*>(addr);
+#else
+    std::ifstream ifs(m_file, std::ios::binary);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(ifs.good(), "Could not open material_map.file " + m_file);
+    m_buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    m_file_size = m_buffer.size();
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_file_size > 0, "material_map.file " + m_file + " is empty");
+    m_file_data = m_buffer.data();
+#endif
+
+    // Text header, up to the end of its last line
+    std::size_t header_size = 0;
+    for (int line = 0; line < header_lines; ++line) {
+        unsigned char const* const eol = static_cast<unsigned char const*>(
+            std::memchr(m_file_data + header_size, '\n', m_file_size - header_size));
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(eol != nullptr,
+            "Incomplete header in material_map.file " + m_file);
+        header_size = static_cast<std::size_t>(eol - m_file_data) + 1;
+    }
+    std::istringstream header(std::string(reinterpret_cast<char const*>(m_file_data), header_size));
+    std::string magic, type, encoding;
+    int version = 0;
+    header >> magic >> version
+           >> m_n[0] >> m_n[1] >> m_n[2]
+           >> m_lo[0] >> m_lo[1] >> m_lo[2] >> m_hi[0] >> m_hi[1] >> m_hi[2]
+           >> type >> encoding;
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!header.fail() && magic == "WARPX_VOXEL_MAP" && version == 1,
+        "material_map.file " + m_file + " is not a version 1 voxel material map");
+    for (int idim = 0; idim < 3; ++idim) {
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_n[idim] > 0 && m_hi[idim] > m_lo[idim],
+            "Invalid dimensions or bounds in material_map.file " + m_file);
+    }
+    if (type == "uint8") {
+        m_bytes_per_voxel = 1;
+    } else if (type == "uint16") {
+        m_bytes_per_voxel = 2;
+    } else {
+        amrex::Abort(Utils::TextMsg::Err(
+            "The voxel type of material_map.file must be uint8 or uint16, not " + type));
+    }
+    if (encoding == "raw") {
+        m_rle = false;
+    } else if (encoding == "rle") {
+        m_rle = true;
+    } else {
+        amrex::Abort(Utils::TextMsg::Err(
+            "The encoding of material_map.file must be raw or rle, not " + encoding));
+    }
+
+    m_data = m_file_data + header_size;
+    const std::size_t data_size = m_file_size - header_size;
+    const std::size_t nrows = static_cast<std::size_t>(m_n[1])*static_cast<std::size_t>(m_n[2]);
+    if (m_rle) {
+        const std::size_t table_size = (nrows + 1)*sizeof(std::uint64_t);
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(data_size >= table_size,
+            "Truncated row offsets in material_map.file " + m_file);
+        m_rows = m_data + table_size;
+        // The rows are decoded without checking their offsets, which must thus be
+        // non-decreasing and end with the size of the encoded rows
+        std::uint64_t begin = 0;
+        for (std::size_t irow = 0; irow <= nrows; ++irow) {
+            std::uint64_t end = 0;
+            std::memcpy(&end, m_data + irow*sizeof(std::uint64_t), sizeof(std::uint64_t));
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(end >= begin && end <= data_size - table_size,
+                "Invalid row offsets in material_map.file " + m_file);
+            begin = end;
+        }
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(begin == data_size - table_size,
+            "Truncated rows in material_map.file " + m_file);
+    } else {
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+            data_size == nrows*static_cast<std::size_t>(m_n[0])*m_bytes_per_voxel,
+            "The size of material_map.file " + m_file + " does not match its header");
+    }
+}
+
+bool
+VoxelMaterialMap::DefinesProperty (std::string const& property) const
+{
+    for (auto const& name : m_material_names) {
+        ParmParse pp_material("material_map." + name);
+        if (pp_material.contains(property.c_str())) return true;
+    }
+    return false;
+}
+
+amrex::Vector<amrex::Real>
+VoxelMaterialMap::MaterialValues (std::string const& property, amrex::Real default_value) const
+{
+    amrex::Vector<amrex::Real> values(m_material_names.size(), default_value);
+    for (int imat = 0; imat < NumMaterials(); ++imat) {
+        ParmParse pp_material("material_map." + m_material_names[imat]);
+        queryWithParser(pp_material, property.c_str(), values[imat]);
+    }
+    return values;
+}
+
+int
+VoxelMaterialMap::ReadId (unsigned char const* p) const
+{
+    // The ids are little-endian
+    return (m_bytes_per_voxel == 1) ? static_cast<int>(p[0])
+                                    : static_cast<int>(p[0]) | (static_cast<int>(p[1]) << 8);
+}
+
+void
+VoxelMaterialMap::DecodeRow (int vy, int vz, int vx_lo, int vx_hi, std::vector<int>& row) const
+{
+    const std::size_t irow = static_cast<std::size_t>(vy)
+                           + static_cast<std::size_t>(m_n[1])*static_cast<std::size_t>(vz);
+    if (!m_rle) {
+        unsigned char const* p = m_data + irow*static_cast<std::size_t>(m_n[0])*m_bytes_per_voxel;
+        for (int vx = vx_lo; vx <= vx_hi; ++vx) {
+            row[vx] = ReadId(p + vx*m_bytes_per_voxel);
+        }
+        return;
+    }
+
+    std::uint64_t begin = 0, end = 0;
+    std::memcpy(&begin, m_data + irow*sizeof(std::uint64_t), sizeof(std::uint64_t));
+    std::memcpy(&end, m_data + (irow+1)*sizeof(std::uint64_t), sizeof(std::uint64_t));
+    unsigned char const* p = m_rows + begin;
+    unsigned char const* const p_end = m_rows + end;
+    const std::size_t run_size = sizeof(std::uint32_t) + m_bytes_per_voxel;
+    // The runs are read until the one containing vx_hi
+    int vx = 0;
+    while (vx <= vx_hi && p + run_size <= p_end) {
+        std::uint32_t count = 0;
+        std::memcpy(&count, p, sizeof(std::uint32_t));
+        if (count > static_cast<std::uint32_t>(m_n[0] - vx)) {
+            amrex::Abort(Utils::TextMsg::Err("Invalid run length in material_map.file " + m_file));
+        }
+        const int run_end = vx + static_cast<int>(count);
+        if (run_end > vx_lo) {
+            const int id = ReadId(p + sizeof(std::uint32_t));
+            std::fill(row.begin() + std::max(vx, vx_lo), row.begin() + std::min(run_end, vx_hi+1), id);
+        }
+        vx = run_end;
+        p += run_size;
+    }
+    if (vx <= vx_hi) {
+        amrex::Abort(Utils::TextMsg::Err("Incomplete row in material_map.file " + m_file));
+    }
+}
+
+void
+VoxelMaterialMap::SampleIds (amrex::Box const& bx, amrex::IndexType ixtype, int lev,
+                             amrex::Gpu::DeviceVector<int>& ids) const
+{
+    const amrex::Geometry& geom = WarpX::GetInstance().Geom(lev);
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+
+    // Voxel containing the position pos along the axis idim of the map
+    auto voxel_index = [this] (int idim, amrex::Real pos) -> int {
+        const amrex::Real voxel_size = (m_hi[idim] - m_lo[idim])/m_n[idim];
+        const int v = static_cast<int>(std::floor((pos - m_lo[idim])/voxel_size));
+        return std::min(std::max(v, 0), m_n[idim] - 1);
+    };
+
+    // The voxel index is computed once per index of the box in each direction
+#if defined(WARPX_DIM_XZ) || defined(WARPX_DIM_RZ)
+    const std::array<int, AMREX_SPACEDIM> map_axis{0, 2};
+#else
+    const std::array<int, AMREX_SPACEDIM> map_axis{0, 1, 2};
+#endif
+    std::array<std::vector<int>, 3> voxels{{std::vector<int>(1, 0), std::vector<int>(1, 0),
+                                            std::vector<int>(1, 0)}};
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const int len = bx.length(idim);
+        voxels[idim].resize(len);
+        for (int l = 0; l < len; ++l) {
+            const int index = bx.smallEnd(idim) + l;
+            const amrex::Real pos = problo[idim] + (index + 0.5_rt*(1 - ixtype[idim]))*dx[idim];
+            voxels[idim][l] = voxel_index(map_axis[idim], pos);
+        }
+    }
+#if defined(WARPX_DIM_XZ) || defined(WARPX_DIM_RZ)
+    // The simulation plane is y = 0
+    const int vy_plane = voxel_index(1, 0._rt);
+#endif
+
+    // Only the voxels of the rows that are under the box are decoded
+    const int vx_lo = voxels[0].front();
+    const int vx_hi = voxels[0].back();
+
+    const amrex::Dim3 len = amrex::length(bx);
+    const std::size_t npts = static_cast<std::size_t>(bx.numPts());
+    amrex::Gpu::PinnedVector<int> h_ids(npts);
+    int* const h_ids_ptr = h_ids.dataPtr();
+    int max_id = 0;
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel reduction(max:max_id)
+#endif
+    {
+        // Consecutive points often fall in the same voxel row, which is decoded only once
+        std::vector<int> row(m_n[0]);
+        int row_vy = -1, row_vz = -1;
+#ifdef AMREX_USE_OMP
+#pragma omp for collapse(2)
+#endif
+        for (int k = 0; k < len.z; ++k) {
+            for (int j = 0; j < len.y; ++j) {
+#if defined(WARPX_DIM_XZ) || defined(WARPX_DIM_RZ)
+                const int vy = vy_plane;
+                const int vz = voxels[1][j];
+#else
+                const int vy = voxels[1][j];
+                const int vz = voxels[2][k];
+#endif
+                if (vy != row_vy || vz != row_vz) {
+                    DecodeRow(vy, vz, vx_lo, vx_hi, row);
+                    row_vy = vy;
+                    row_vz = vz;
+                }
+                int* const line = h_ids_ptr + static_cast<std::size_t>(len.x)*(j + static_cast<std::size_t>(len.y)*k);
+                for (int i = 0; i < len.x; ++i) {
+                    line[i] = row[voxels[0][i]];
+                    max_id = std::max(max_id, line[i]);
+                }
+            }
+        }
+    }
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(max_id < NumMaterials(),
+        "material_map.file " + m_file + " contains ids beyond the number of material_map.materials");
+
+    ids.resize(npts);
+    amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, h_ids.begin(), h_ids.end(), ids.begin());
+    amrex::Gpu::streamSynchronize();
+}
+
+void
+VoxelMaterialMap::Fill (amrex::MultiFab& mf, amrex::Vector<amrex::Real> const& values, int lev) const
+{
+    Fill({{&mf, values}}, lev);
+}
+
+void
+VoxelMaterialMap::Fill (amrex::Vector<std::pair<amrex::MultiFab*, amrex::Vector<amrex::Real>>> const& fields,
+                        int lev) const
+{
+    WARPX_PROFILE("VoxelMaterialMap::Fill()");
+
+    // Value of each material for each field
+    amrex::Vector<amrex::Gpu::DeviceVector<amrex::Real>> d_values(fields.size());
+    for (std::size_t ifield = 0; ifield < fields.size(); ++ifield) {
+        auto const& values = fields[ifield].second;
+        d_values[ifield].resize(values.size());
+        amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, values.begin(), values.end(),
+                              d_values[ifield].begin());
+    }
+
+    // The fields are filled by index type, so that the ids of only one index type are kept
+    std::vector<std::size_t> order(fields.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&fields] (std::size_t a, std::size_t b) {
+        return fields[a].first->ixType().ixType().lexLT(fields[b].first->ixType().ixType());
+    });
+
+    // Material ids of each box, the box carrying the index type
+    auto box_less = [] (amrex::Box const& a, amrex::Box const& b) {
+        if (a.ixType() != b.ixType()) return a.ixType().ixType().lexLT(b.ixType().ixType());
+        if (a.smallEnd() != b.smallEnd()) return a.smallEnd().lexLT(b.smallEnd());
+        return a.bigEnd().lexLT(b.bigEnd());
+    };
+    std::map<amrex::Box, amrex::Gpu::DeviceVector<int>, decltype(box_less)> ids(box_less);
+
+    for (std::size_t ifield : order) {
+        amrex::MultiFab& mf = *fields[ifield].first;
+        if (!ids.empty() && ids.begin()->first.ixType() != mf.ixType()) ids.clear();
+        amrex::Real const* const table = d_values[ifield].dataPtr();
+
+        for ( amrex::MFIter mfi(mf); mfi.isValid(); ++mfi ) {
+            // Initialize ghost cells in addition to valid cells
+            const amrex::Box bx = mfi.fabbox();
+            auto it = ids.find(bx);
+            if (it == ids.end()) {
+                it = ids.emplace(bx, amrex::Gpu::DeviceVector<int>()).first;
+                SampleIds(bx, mf.ixType(), lev, it->second);
+            }
+            int const* const ids_ptr = it->second.dataPtr();
+            amrex::Array4<amrex::Real> const& fab = mf.array(mfi);
+            const int ncomp = mf.nComp();
+            amrex::ParallelFor(static_cast<int>(bx.numPts()),
+                [=] AMREX_GPU_DEVICE (int icell) {
+                    const amrex::Dim3 cell = bx.atOffset(icell).dim3();
+                    for (int n = 0; n < ncomp; ++n) {
+                        fab(cell.x, cell.y, cell.z, n) = table[ids_ptr[icell]];
+                    }
+                });
+        }
+    }
+    // The ids and values are freed on return
+    amrex::Gpu::streamSynchronize();
+}
@@ -523,4 +523,7 @@ WarpX::ResetProbDomain (const amrex::RealBox& rb)
         g.ProbDomain(rb);
         SetGeometry(lev, g);
     }
+    // The excitation source points and the superconducting edges are located with the old domain
+    ClearExcitationSources();
+    if (m_london) m_london->ClearAll();
 }
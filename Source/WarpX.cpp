@@ -15,6 +15,7 @@
 #include "Diagnostics/BackTransformedDiagnostic.H"
 #include "Diagnostics/MultiDiagnostics.H"
 #include "Diagnostics/ReducedDiags/MultiReducedDiags.H"
+#include "FieldSolver/Excitation/ExcitationSources.H"
 #include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
 #include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
 #ifdef WARPX_USE_PSATD
@@ -28,10 +29,14 @@
 #endif // use PSATD ifdef
 #include "FieldSolver/WarpX_FDTD.H"
 #include "Filter/NCIGodfreyFilter.H"
+#include "Parallelization/DomainLayout.H"
+#include "Parallelization/ThreadPlacement.H"
+#include "Parallelization/WarpXCommUtil.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Particles/ParticleBoundaryBuffer.H"
 #include "Utils/TextMsg.H"
 #include "Utils/MsgLogger/MsgLogger.H"
+#include "Utils/VoxelMaterialMap.H"
 #include "Utils/WarnManager.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
@@ -65,6 +70,7 @@
 #include <AMReX_MFIter.H>
 #include <AMReX_MakeType.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_OpenMP.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Print.H>
@@ -260,6 +266,8 @@ bool WarpX::do_subcycling = false;
 bool WarpX::do_multi_J = false;
 int WarpX::do_multi_J_n_depositions;
 bool WarpX::safe_guard_cells = 0;
+bool WarpX::do_comm_overlap = false;
+bool WarpX::do_numa_first_touch = false;
 
 IntVect WarpX::filter_npass_each_dir(1);
 
@@ -532,6 +540,13 @@ WarpX::~WarpX ()
     }
 }
 
+VoxelMaterialMap&
+WarpX::GetMaterialMap ()
+{
+    if (!m_material_map) m_material_map = std::make_unique<VoxelMaterialMap>();
+    return *m_material_map;
+}
+
 void
 WarpX::RecordWarning(
         std::string topic,
@@ -663,6 +678,15 @@ WarpX::ReadParameters ()
             }
         }
 
+        pp_warpx.query("thin_dim_decomposition", do_thin_dim_decomposition);
+        if (do_thin_dim_decomposition) {
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(numprocs == 0,
+                "warpx.thin_dim_decomposition cannot be used with warpx.numprocs");
+            queryWithParser(pp_warpx, "thin_dim_max_cells", thin_dim_max_cells);
+            pp_warpx.query("thin_dim_reduced_halo", do_thin_dim_reduced_halo);
+            m_thin_dims = DomainLayout::ThinDirections(Geom(0).Domain(), thin_dim_max_cells);
+        }
+
         using ablastr::utils::SignalHandling;
         std::vector<std::string> signals_in;
         pp_warpx.queryarr("break_signals", signals_in);
@@ -737,6 +761,8 @@ WarpX::ReadParameters ()
         }
         pp_warpx.query("use_hybrid_QED", use_hybrid_QED);
         pp_warpx.query("safe_guard_cells", safe_guard_cells);
+        pp_warpx.query("do_comm_overlap", do_comm_overlap);
+        pp_warpx.query("numa_first_touch", do_numa_first_touch);
         std::vector<std::string> override_sync_intervals_string_vec = {"1"};
         pp_warpx.queryarr("override_sync_intervals", override_sync_intervals_string_vec);
         override_sync_intervals = IntervalsParser(override_sync_intervals_string_vec);
@@ -1163,6 +1189,22 @@ WarpX::ReadParameters ()
 
         yee_coupled_solver_algo = GetAlgorithmInteger(pp_algo, "yee_coupled_solver");
 
+        if (do_comm_overlap) {
+#ifdef WARPX_DIM_RZ
+            amrex::Abort(Utils::TextMsg::Err(
+                "warpx.do_comm_overlap = 1 is not implemented in RZ geometry"));
+#endif
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+                maxwell_solver_id == MaxwellSolverAlgo::Yee || maxwell_solver_id == MaxwellSolverAlgo::CKC,
+                "warpx.do_comm_overlap = 1 is only implemented for the Yee and CKC solvers");
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+                maxLevel() == 0,
+                "warpx.do_comm_overlap = 1 is not implemented with mesh refinement");
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+                !do_dive_cleaning && !do_divb_cleaning,
+                "warpx.do_comm_overlap = 1 is not implemented with divergence cleaning");
+        }
+
         // Load balancing parameters
         std::vector<std::string> load_balance_intervals_string_vec = {"0"};
         pp_algo.queryarr("load_balance_intervals", load_balance_intervals_string_vec);
@@ -1703,6 +1745,8 @@ WarpX::MakeNewLevelFromCoarse (int /*lev*/, amrex::Real /*time*/, const amrex::B
 void
 WarpX::ClearLevel (int lev)
 {
+    WarpXCommUtil::ClearExchangedCellsCache();
+
     for (int i = 0; i < 3; ++i) {
         Efield_aux[lev][i].reset();
         Bfield_aux[lev][i].reset();
@@ -1752,6 +1796,8 @@ WarpX::ClearLevel (int lev)
 
     charge_buf[lev].reset();
 
+    if (m_london) m_london->Clear(lev);
+
     current_buffer_masks[lev].reset();
     gather_buffer_masks[lev].reset();
 
@@ -1787,6 +1833,37 @@ WarpX::AllocLevelData (int lev, const BoxArray& ba, const DistributionMapping& d
     amrex::RealVect dx = {WarpX::CellSize(lev)[0], WarpX::CellSize(lev)[1], WarpX::CellSize(lev)[2]};
 #endif
 
+#ifdef WARPX_MAG_LLG
+    const bool do_mag_exchange_coupling = (mag_LLG_exchange_coupling == 1);
+#else
+    const bool do_mag_exchange_coupling = false;
+#endif
+
+    // Thin periodic directions along which no box is cut, with a single level
+    IntVect reduced_halo_dims(0);
+    if (do_thin_dim_reduced_halo && maxLevel() == 0) {
+        const Box& domain = Geom(lev).Domain();
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (!m_thin_dims[idim] || !Geom(lev).isPeriodic(idim)) continue;
+            bool is_cut = false;
+            for (int i = 0; i < ba.size(); ++i) {
+                if (ba[i].length(idim) != domain.length(idim)) is_cut = true;
+            }
+            reduced_halo_dims[idim] = is_cut ? 0 : 1;
+        }
+    }
+
+    if (lev == 0 && do_thin_dim_decomposition) {
+        // Tiles of the largest box, with the thin directions not tiled and
+        // the OpenMP threads balanced along the longest tiled direction
+        Box largest_box;
+        for (int i = 0; i < ba.size(); ++i) {
+            if (ba[i].numPts() > largest_box.numPts()) largest_box = ba[i];
+        }
+        FabArrayBase::mfiter_tile_size = DomainLayout::TileSize(
+            largest_box, m_thin_dims, FabArrayBase::mfiter_tile_size, OpenMP::get_max_threads());
+    }
+
     guard_cells.Init(
         dt[lev],
         dx,
@@ -1809,7 +1886,9 @@ WarpX::AllocLevelData (int lev, const BoxArray& ba, const DistributionMapping& d
         WarpX::isAnyBoundaryPML(),
         WarpX::do_pml_in_domain,
         WarpX::pml_ncell,
-        this->refRatio());
+        this->refRatio(),
+        do_mag_exchange_coupling,
+        reduced_halo_dims);
 
 
 #ifdef AMREX_USE_EB
@@ -1847,6 +1926,11 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
                       const IntVect& ngEB, const IntVect& ngJ, const IntVect& ngRho,
                       const IntVect& ngF, const IntVect& ngG, const bool aux_is_nodal)
 {
+#ifdef WARPX_MAG_LLG
+    // H and M have their own number of guard cells, derived from the stencils that read them
+    const IntVect& ngH = guard_cells.ng_alloc_H;
+    const IntVect& ngM = guard_cells.ng_alloc_M;
+#endif
     // Declare nodal flags
     IntVect Ex_nodal_flag, Ey_nodal_flag, Ez_nodal_flag;
     IntVect Bx_nodal_flag, By_nodal_flag, Bz_nodal_flag;
@@ -1997,17 +2081,17 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
 
 #ifdef WARPX_MAG_LLG
     // each Mfield[] is three components
-    Mfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Mx_nodal_flag),dm,3     ,ngEB);
-    Mfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,My_nodal_flag),dm,3     ,ngEB);
-    Mfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Mz_nodal_flag),dm,3     ,ngEB);
+    Mfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Mx_nodal_flag),dm,3     ,ngM);
+    Mfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,My_nodal_flag),dm,3     ,ngM);
+    Mfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Mz_nodal_flag),dm,3     ,ngM);
 
-    Hfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_nodal_flag),dm,ncomps,ngEB);
-    Hfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_nodal_flag),dm,ncomps,ngEB);
-    Hfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_nodal_flag),dm,ncomps,ngEB);
+    Hfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_nodal_flag),dm,ncomps,ngH);
+    Hfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_nodal_flag),dm,ncomps,ngH);
+    Hfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_nodal_flag),dm,ncomps,ngH);
 
-    H_biasfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_bias_nodal_flag),dm,ncomps,ngEB);
-    H_biasfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_bias_nodal_flag),dm,ncomps,ngEB);
-    H_biasfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_bias_nodal_flag),dm,ncomps,ngEB);
+    H_biasfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_bias_nodal_flag),dm,ncomps,ngH);
+    H_biasfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_bias_nodal_flag),dm,ncomps,ngH);
+    H_biasfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_bias_nodal_flag),dm,ncomps,ngH);
 #endif
 
     Efield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Ex_nodal_flag),dm,ncomps,ngEB,tag("Efield_fp[x]"));
@@ -2197,17 +2281,17 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
         BoxArray const nba = amrex::convert(ba,IntVect::TheNodeVector());
 
 #ifdef WARPX_MAG_LLG
-        Mfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,3     ,ngEB);
-        Mfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,3     ,ngEB);
-        Mfield_aux[lev][2] = std::make_unique<MultiFab>(nba,dm,3     ,ngEB);
+        Mfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,3     ,ngM);
+        Mfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,3     ,ngM);
+        Mfield_aux[lev][2] = std::make_unique<MultiFab>(nba,dm,3     ,ngM);
 
-        Hfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
-        Hfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
-        Hfield_aux[lev][2] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
+        Hfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,ncomps,ngH);
+        Hfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,ncomps,ngH);
+        Hfield_aux[lev][2] = std::make_unique<MultiFab>(nba,dm,ncomps,ngH);
 
-        H_biasfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
-        H_biasfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
-        H_biasfield_aux[lev][2] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
+        H_biasfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,ncomps,ngH);
+        H_biasfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,ncomps,ngH);
+        H_biasfield_aux[lev][2] = std::make_unique<MultiFab>(nba,dm,ncomps,ngH);
 #endif
         Bfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB,tag("Bfield_aux[x]"));
         Bfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB,tag("Bfield_aux[y]"));
@@ -2259,17 +2343,17 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
         Efield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Ez_nodal_flag),dm,ncomps,ngEB,tag("Efield_aux[z]"));
 
 #ifdef WARPX_MAG_LLG
-        Mfield_aux[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Mx_nodal_flag),dm,3     ,ngEB);
-        Mfield_aux[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,My_nodal_flag),dm,3     ,ngEB);
-        Mfield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Mz_nodal_flag),dm,3     ,ngEB);
+        Mfield_aux[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Mx_nodal_flag),dm,3     ,ngM);
+        Mfield_aux[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,My_nodal_flag),dm,3     ,ngM);
+        Mfield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Mz_nodal_flag),dm,3     ,ngM);
 
-        Hfield_aux[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_nodal_flag),dm,ncomps,ngEB);
-        Hfield_aux[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_nodal_flag),dm,ncomps,ngEB);
-        Hfield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_nodal_flag),dm,ncomps,ngEB);
+        Hfield_aux[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_nodal_flag),dm,ncomps,ngH);
+        Hfield_aux[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_nodal_flag),dm,ncomps,ngH);
+        Hfield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_nodal_flag),dm,ncomps,ngH);
 
-        H_biasfield_aux[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_bias_nodal_flag),dm,ncomps,ngEB);
-        H_biasfield_aux[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_bias_nodal_flag),dm,ncomps,ngEB);
-        H_biasfield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_bias_nodal_flag),dm,ncomps,ngEB);
+        H_biasfield_aux[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_bias_nodal_flag),dm,ncomps,ngH);
+        H_biasfield_aux[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_bias_nodal_flag),dm,ncomps,ngH);
+        H_biasfield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_bias_nodal_flag),dm,ncomps,ngH);
 #endif
     }
 
@@ -2284,19 +2368,19 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
 
 #ifdef WARPX_MAG_LLG
     // Create the MultiFabs for M
-        Mfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Mx_nodal_flag),dm,3     ,ngEB);
-        Mfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,My_nodal_flag),dm,3     ,ngEB);
-        Mfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Mz_nodal_flag),dm,3     ,ngEB);
+        Mfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Mx_nodal_flag),dm,3     ,ngM);
+        Mfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,My_nodal_flag),dm,3     ,ngM);
+        Mfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Mz_nodal_flag),dm,3     ,ngM);
 
         // Create the MultiFabs for H
-        Hfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_nodal_flag),dm,ncomps,ngEB);
-        Hfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_nodal_flag),dm,ncomps,ngEB);
-        Hfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_nodal_flag),dm,ncomps,ngEB);
+        Hfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_nodal_flag),dm,ncomps,ngH);
+        Hfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_nodal_flag),dm,ncomps,ngH);
+        Hfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_nodal_flag),dm,ncomps,ngH);
 
         // Create the MultiFabs for H_bias
-        H_biasfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_bias_nodal_flag),dm,ncomps,ngEB);
-        H_biasfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_bias_nodal_flag),dm,ncomps,ngEB);
-        H_biasfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_bias_nodal_flag),dm,ncomps,ngEB);
+        H_biasfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_bias_nodal_flag),dm,ncomps,ngH);
+        H_biasfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_bias_nodal_flag),dm,ncomps,ngH);
+        H_biasfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_bias_nodal_flag),dm,ncomps,ngH);
 
 #endif
 
@@ -2472,6 +2556,34 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
         costs[lev] = std::make_unique<LayoutData<Real>>(ba, dm);
         load_balance_efficiency[lev] = -1;
     }
+
+#ifndef AMREX_USE_GPU
+    if (do_numa_first_touch) {
+        // No MultiFab of this level has been written yet: place their pages with the threads
+        // that update the tiles in the field kernels
+        auto first_touch = [] (std::array<std::unique_ptr<MultiFab>,3>& mfs) {
+            for (auto& mf : mfs) {
+                if (mf) ThreadPlacement::FirstTouch(*mf);
+            }
+        };
+        for (auto* mfs : {&Efield_fp[lev], &Bfield_fp[lev], &current_fp[lev],
+                          &Efield_cp[lev], &Bfield_cp[lev], &current_cp[lev],
+                          &Efield_aux[lev], &Bfield_aux[lev], &Bfield_sc_fp[lev],
+                          &Efield_avg_fp[lev], &Bfield_avg_fp[lev], &current_store[lev]}) {
+            first_touch(*mfs);
+        }
+#ifdef WARPX_MAG_LLG
+        for (auto* mfs : {&Mfield_fp[lev], &Hfield_fp[lev], &H_biasfield_fp[lev],
+                          &Mfield_cp[lev], &Hfield_cp[lev], &H_biasfield_cp[lev],
+                          &Mfield_aux[lev], &Hfield_aux[lev], &H_biasfield_aux[lev]}) {
+            first_touch(*mfs);
+        }
+#endif
+        for (auto* mf : {&rho_fp[lev], &rho_cp[lev], &F_fp[lev], &F_cp[lev], &G_fp[lev], &G_cp[lev], &phi_fp[lev]}) {
+            if (*mf) ThreadPlacement::FirstTouch(**mf);
+        }
+    }
+#endif
 }
 
 #ifdef WARPX_USE_PSATD
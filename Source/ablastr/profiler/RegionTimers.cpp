@@ -0,0 +1,52 @@
+/* Copyright 2022
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "RegionTimers.H"
+
+#include <map>
+#include <mutex>
+
+namespace
+{
+    /** Time of all the registered regions (the elements of a map are never moved) */
+    std::map<std::string, ablastr::profiler::RegionTime>& Regions ()
+    {
+        static std::map<std::string, ablastr::profiler::RegionTime> regions;
+        return regions;
+    }
+
+    std::mutex regions_mutex;
+}
+
+namespace ablastr::profiler {
+
+std::atomic<bool> RegionTimers::m_enabled{false};
+
+void
+RegionTimers::Enable ()
+{
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+RegionTime*
+RegionTimers::Register (std::string const& name)
+{
+    std::lock_guard<std::mutex> lock(regions_mutex);
+    return &Regions()[name];
+}
+
+double
+RegionTimers::Total (std::string const& name)
+{
+    std::lock_guard<std::mutex> lock(regions_mutex);
+    auto const it = Regions().find(name);
+    if (it == Regions().end()) return 0.;
+    const RegionTime& region = it->second;
+    return region.depth > 0 ? region.time + (amrex::second() - region.start) : region.time;
+}
+
+} // namespace ablastr::profiler
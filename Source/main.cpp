@@ -25,6 +25,10 @@
 #  include <mpi.h>
 #endif
 
+#if defined(__linux__)
+#  include <sys/resource.h>
+#endif
+
 #if defined(AMREX_USE_HIP) && defined(WARPX_USE_PSATD)
 // cstddef: work-around for ROCm/rocFFT <=4.3.0
 // https://github.com/ROCmSoftwarePlatform/rocFFT/blob/rocm-4.3.0/library/include/rocfft.h#L36-L42
@@ -70,6 +74,14 @@ int main(int argc, char* argv[])
             auto end_total = static_cast<Real>(amrex::second()) - strt_total;
             ParallelDescriptor::ReduceRealMax(end_total, ParallelDescriptor::IOProcessorNumber());
             Print() << "Total Time                     : " << end_total << '\n';
+#if defined(__linux__)
+            // Peak resident memory of the process, in kB on Linux
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            auto max_rss_mb = static_cast<Real>(usage.ru_maxrss) / 1024._rt;
+            ParallelDescriptor::ReduceRealMax(max_rss_mb, ParallelDescriptor::IOProcessorNumber());
+            Print() << "Memory High-Water Mark (MB)    : " << max_rss_mb << '\n';
+#endif
         }
 
         WARPX_PROFILE_VAR_STOP(pmain);
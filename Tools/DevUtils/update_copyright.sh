@@ -34,6 +34,7 @@ for i in $(find . \
                 -not -path "*/inputs*" \
                 -not -path "*/PICMI_inputs*" \
                 -not -path "./Tools/PerformanceTests/performance_log.txt" \
+                -not -path "./Tools/PerformanceTests/performance_log_artemis.txt" \
                 -type f | \
                grep -P "${pattern}")
 do
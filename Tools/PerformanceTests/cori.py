@@ -12,9 +12,10 @@ from functions_perftest import test_element
 
 module_name = {'cpu': 'haswell.', 'knl': 'mic-knl.', 'gpu':'.'}
 
-def executable_name(compiler, architecture):
+def executable_name(compiler, architecture, use_llg=False):
+    llg_suffix = '.LLG' if use_llg else ''
     return 'perf_tests3d.' + compiler + \
-        '.' + module_name[architecture] + 'TPROF.MTMPI.OMP.QED.ex'
+        '.' + module_name[architecture] + 'TPROF.MTMPI.OMP' + llg_suffix + '.QED.ex'
 
 def get_config_command(compiler, architecture):
     config_command = ''
@@ -42,7 +43,7 @@ def get_config_command(compiler, architecture):
 # This function runs a batch script with
 # dependencies to perform the analysis
 # after all performance tests are done.
-def process_analysis(automated, cwd, compiler, architecture, n_node_list, start_date, path_source, path_results):
+def process_analysis(automated, cwd, compiler, architecture, n_node_list, start_date, path_source, path_results, suite='pic'):
     dependencies = ''
     f_log = open(cwd + 'log_jobids_tmp.txt' ,'r')
     for line in f_log.readlines():
@@ -67,7 +68,8 @@ module load h5py-parallel
         ' --n_node_list=' + '"' + n_node_list + '"' + \
         ' --start_date=' + start_date + \
         ' --path_source=' + path_source + \
-        ' --path_results=' + path_results
+        ' --path_results=' + path_results + \
+        ' --suite=' + suite
     if automated == True:
         batch_string += ' --automated'
     batch_string += '\n'
@@ -169,3 +171,42 @@ def get_test_list(n_repeat):
                                        n_step=1) )
     test_list = [copy.deepcopy(item) for item in test_list_unq for _ in range(n_repeat) ]
     return test_list
+
+# ARTEMIS suite: scaled-down LLG, London and macroscopic field solver tests.
+# Tests with use_llg=True run with the executable compiled with USE_LLG=TRUE.
+def get_artemis_test_list(n_repeat):
+    test_list_unq = []
+    test_list_unq.append( test_element(input_file='automated_test_7_llg_filter',
+                                       n_mpi_per_node=8,
+                                       n_omp=8,
+                                       n_cell=[512, 8, 256],
+                                       max_grid_size=64,
+                                       blocking_factor=8,
+                                       n_step=20,
+                                       use_llg=True) )
+    test_list_unq.append( test_element(input_file='automated_test_8_magnon_photon',
+                                       n_mpi_per_node=8,
+                                       n_omp=8,
+                                       n_cell=[64, 256, 32],
+                                       max_grid_size=64,
+                                       blocking_factor=16,
+                                       n_step=20,
+                                       use_llg=True) )
+    test_list_unq.append( test_element(input_file='automated_test_9_london',
+                                       n_mpi_per_node=8,
+                                       n_omp=8,
+                                       n_cell=[64, 64, 640],
+                                       max_grid_size=64,
+                                       blocking_factor=32,
+                                       n_step=50,
+                                       use_llg=False) )
+    test_list_unq.append( test_element(input_file='automated_test_10_macroscopic',
+                                       n_mpi_per_node=8,
+                                       n_omp=8,
+                                       n_cell=[128, 128, 1024],
+                                       max_grid_size=64,
+                                       blocking_factor=32,
+                                       n_step=20,
+                                       use_llg=False) )
+    test_list = [copy.deepcopy(item) for item in test_list_unq for _ in range(n_repeat) ]
+    return test_list
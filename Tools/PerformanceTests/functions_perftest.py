@@ -21,7 +21,7 @@ import pandas as pd
 class test_element():
     def __init__(self, input_file=None, n_node=None, n_mpi_per_node=None,
                  n_omp=None, n_cell=None, n_step=None, max_grid_size=None,
-                 blocking_factor=None):
+                 blocking_factor=None, use_llg=False):
         self.input_file = input_file
         self.n_node = n_node
         self.n_mpi_per_node = n_mpi_per_node
@@ -30,6 +30,8 @@ class test_element():
         self.n_step = n_step
         self.max_grid_size = max_grid_size
         self.blocking_factor = blocking_factor
+        # Whether the test runs with the executable compiled with USE_LLG=TRUE
+        self.use_llg = use_llg
 
     def scale_n_cell(self, n_node=0):
         n_cell_scaled = copy.deepcopy(self.n_cell)
@@ -105,14 +107,15 @@ def run_batch(run_name, res_dir, bin_name, config_command, architecture='knl',\
     os.system(config_command + 'sbatch ' + batch_file + ' >> ' + cwd + 'log_jobids_tmp.txt')
     return 0
 
-def run_batch_nnode(test_list, res_dir, cwd, bin_name, config_command, batch_string, submit_job_command):
+def run_batch_nnode(test_list, res_dir, cwd, bin_names, config_command, batch_string, submit_job_command):
     # Clean res_dir
     if os.path.exists(res_dir):
          shutil.rmtree(res_dir, ignore_errors=True)
     os.makedirs(res_dir)
     # Copy files to res_dir
     bin_dir = cwd + 'Bin/'
-    shutil.copy(bin_dir + bin_name, res_dir)
+    for bin_name in bin_names:
+        shutil.copy(bin_dir + bin_name, res_dir)
     os.chdir(res_dir)
 
     for count, current_test in enumerate(test_list):
@@ -121,7 +124,8 @@ def run_batch_nnode(test_list, res_dir, cwd, bin_name, config_command, batch_str
     f_exe = open(batch_file,'w')
     f_exe.write(batch_string)
     f_exe.close()
-    os.system('chmod 700 ' + bin_name)
+    for bin_name in bin_names:
+        os.system('chmod 700 ' + bin_name)
     os.system(config_command + submit_job_command + batch_file +\
                    ' >> ' + cwd + 'log_jobids_tmp.txt')
 
@@ -168,6 +172,57 @@ def read_run_perf(filename, n_steps):
         timing_list += timing
     return timing_list
 
+# Exclusive timers of the ARTEMIS field solvers, written in this order in
+# performance_log_artemis.txt
+artemis_kernel_list = ['WarpX::MacroscopicEvolveE()',
+                       'WarpX::MacroscopicEvolveHM()',
+                       'WarpX::MacroscopicEvolveHM_2nd()',
+                       'WarpX::EvolveE()',
+                       'WarpX::EvolveB()',
+                       'WarpX::EvolveBLondon()',
+                       'London::EvolveLondonJ()',
+                       'WarpX::ApplyExternalFieldExcitationOnGrid()',
+                       'PML::Exchange',
+                       'FabArray::FillBoundary()',
+                       'FabArray::ParallelCopy()',
+                       'MultiReducedDiags::ComputeDiags()']
+
+# Read output file of an ARTEMIS test and return init time, 1-step time,
+# the time per step of each routine in artemis_kernel_list, the memory
+# high-water mark (MB, max over ranks) and the number of LLG iterations
+# per step (second-order scheme only, 0 otherwise)
+def read_artemis_perf(filename, n_steps):
+    with open(filename) as file_handler:
+        output_text = file_handler.read()
+    # Get total simulation time and time performing steps
+    line_match_totaltime = re.search('TinyProfiler total time across processes.*', output_text)
+    total_time = float(line_match_totaltime.group(0).split()[8])
+    partition_limit1 = 'NCalls  Excl. Min  Excl. Avg  Excl. Max   Max %'
+    partition_limit2 = 'NCalls  Incl. Min  Incl. Avg  Incl. Max   Max %'
+    search_area = output_text.partition(partition_limit2)[2]
+    line_match_looptime = re.search('\nWarpX::Evolve\(\).*', search_area)
+    time_wo_initialization = float(line_match_looptime.group(0).split()[3])
+    timing_list = [str(total_time - time_wo_initialization)]
+    timing_list += [str(time_wo_initialization/n_steps)]
+    # Search EXCLUSIVE routine timings
+    search_area = output_text.partition(partition_limit1)[2].partition(partition_limit2)[0]
+    for kernel in artemis_kernel_list:
+        timing = '0'
+        line_match = re.search('\n' + re.escape(kernel) + ' .*', search_area)
+        if line_match is not None:
+            timing = str(float(line_match.group(0).split()[3])/n_steps)
+        timing_list += [timing]
+    # Memory high-water mark, printed by main() with warpx.verbose = 1
+    memory = '0'
+    line_match_memory = re.search('Memory High-Water Mark \(MB\).*', output_text)
+    if line_match_memory is not None:
+        memory = line_match_memory.group(0).split()[-1]
+    timing_list += [memory]
+    # The second-order LLG scheme prints one line per M iteration
+    n_llg_iterations = len(re.findall('\nFinish [0-9]+ times iteration', output_text))
+    timing_list += [str(n_llg_iterations/n_steps)]
+    return timing_list
+
 # Write time into logfile
 def write_perf_logfile(log_file, log_line):
     f_log = open(log_file, 'a')
@@ -222,6 +277,13 @@ def extract_dataframe(filename, n_steps):
     df['time_initialization'] = total_time - time_wo_initialization
     df['time_running'] = time_wo_initialization
     df['time_WritePlotFile'] = time_WritePlotFile
+    # Memory high-water mark and LLG iterations, see read_artemis_perf
+    line_match_memory = re.search('Memory High-Water Mark \(MB\).*', output_text)
+    if line_match_memory is not None:
+        df['memory_hwm_MB'] = float(line_match_memory.group(0).split()[-1])
+    else:
+        df['memory_hwm_MB'] = 0.
+    df['llg_iterations'] = len(re.findall('\nFinish [0-9]+ times iteration', output_text))/n_steps
     # df['string_output'] = partition_limit_start + '\n' + search_area
     return df
 
@@ -14,7 +14,8 @@ import sys
 import time
 
 from functions_perftest import (extract_dataframe, get_file_content,
-                                run_batch_nnode, store_git_hash)
+                                read_artemis_perf, run_batch_nnode,
+                                store_git_hash, write_perf_logfile)
 import git
 import pandas as pd
 
@@ -22,16 +23,21 @@ import pandas as pd
 # machine-specific file
 if os.getenv("LMOD_SYSTEM_NAME") == 'summit':
     machine = 'summit'
-    from summit import (executable_name, get_batch_string, get_config_command,
-                        get_run_string, get_submit_job_command, get_test_list,
+    from summit import (executable_name, get_artemis_test_list,
+                        get_batch_string, get_config_command, get_run_string,
+                        get_submit_job_command, get_test_list,
                         process_analysis, time_min)
 if os.getenv("NERSC_HOST") == 'cori':
     machine = 'cori'
-    from cori import (executable_name, get_batch_string, get_config_command,
-                      get_run_string, get_submit_job_command, get_test_list,
+    from cori import (executable_name, get_artemis_test_list,
+                      get_batch_string, get_config_command, get_run_string,
+                      get_submit_job_command, get_test_list,
                       process_analysis, time_min)
 
 # typical use: python run_automated.py --n_node_list='1,8,16,32' --automated
+# ARTEMIS solvers (LLG, London, macroscopic): add --suite=artemis. The timers
+# of the field solvers, memory high-water mark and LLG iterations per step are
+# also appended to performance_log_artemis.txt
 # Assume warpx, picsar, amrex and perf_logs repos ar in the same directory and
 # environment variable AUTOMATED_PERF_TESTS contains the path to this directory
 
@@ -90,6 +96,10 @@ parser.add_argument('--path_source',
 parser.add_argument('--path_results',
                     default=None,
                     help='path to result directory, where simulations run')
+parser.add_argument('--suite',
+                    choices=['pic', 'artemis'],
+                    default='pic',
+                    help='which test list to run: particle-in-cell tests or ARTEMIS field solver tests')
 
 args = parser.parse_args()
 n_node_list_string   = args.n_node_list.split(',')
@@ -132,13 +142,18 @@ if args.automated == True:
     if machine == 'summit':
         compiler = 'gnu'
         architecture = 'gpu'
+    if args.suite == 'artemis':
+        perf_database_file = machine + '_artemis_results.h5'
 
 # List of tests to perform
 # ------------------------
 # Each test runs n_repeat times
 n_repeat = 2
 # test_list is machine-specific
-test_list = get_test_list(n_repeat)
+if args.suite == 'artemis':
+    test_list = get_artemis_test_list(n_repeat)
+else:
+    test_list = get_test_list(n_repeat)
 
 # Define directories
 # ------------------
@@ -160,7 +175,10 @@ if args.automated:
     path_hdf5 = perf_logs_repo + '/logs_hdf5/'
 
 bin_dir = cwd + 'Bin/'
-bin_name = executable_name(compiler, architecture)
+# One executable for the tests with USE_LLG=FALSE, one for USE_LLG=TRUE
+bin_name = {}
+for current_run in test_list:
+    bin_name[current_run.use_llg] = executable_name(compiler, architecture, current_run.use_llg)
 
 log_dir  = cwd
 day = time.strftime('%d')
@@ -196,11 +214,15 @@ if args.mode == 'run':
         make_realclean_command = " make realclean WARPX_HOME=../.. " \
             "AMREX_HOME=../../../amrex/ PICSAR_HOME=../../../picsar/ " \
             "EBASE=perf_tests COMP=%s" %compiler_name[compiler] + ";"
-        make_command = "make -j 16 WARPX_HOME=../.. " \
-            "AMREX_HOME=../../../amrex/ PICSAR_HOME=../../../picsar/ " \
-            "EBASE=perf_tests COMP=%s" %compiler_name[compiler]
-        if machine == 'summit':
-            make_command += ' USE_GPU=TRUE '
+        make_command = ''
+        for use_llg in bin_name:
+            make_command += "make -j 16 WARPX_HOME=../.. " \
+                "AMREX_HOME=../../../amrex/ PICSAR_HOME=../../../picsar/ " \
+                "EBASE=perf_tests COMP=%s" %compiler_name[compiler]
+            make_command += ' USE_LLG=TRUE ' if use_llg else ' USE_LLG=FALSE '
+            if machine == 'summit':
+                make_command += ' USE_GPU=TRUE '
+            make_command += ';'
         os.system(config_command + make_realclean_command + \
                   "rm -r tmp_build_dir *.mod; " + make_command )
 
@@ -237,13 +259,13 @@ if args.mode == 'run':
             runtime_param_string += ' amr.blocking_factor=' + str(current_run.blocking_factor)
             runtime_param_string += ' max_step=' + str( current_run.n_step )
             # runtime_param_list.append( runtime_param_string )
-            run_string = get_run_string(current_run, architecture, n_node, count, bin_name, runtime_param_string)
+            run_string = get_run_string(current_run, architecture, n_node, count, bin_name[current_run.use_llg], runtime_param_string)
             batch_string += run_string
             batch_string += 'rm -rf plotfiles lab_frame_data diags\n'
 
         submit_job_command = get_submit_job_command()
         # Run the simulations.
-        run_batch_nnode(test_list_n_node, res_dir, cwd, bin_name, config_command, batch_string, submit_job_command)
+        run_batch_nnode(test_list_n_node, res_dir, cwd, list(bin_name.values()), config_command, batch_string, submit_job_command)
     os.chdir(cwd)
     # submit batch for analysis
     if os.path.exists( 'read_error.txt' ):
@@ -251,7 +273,8 @@ if args.mode == 'run':
     if os.path.exists( 'read_output.txt' ):
         os.remove( 'read_output.txt' )
     process_analysis(args.automated, cwd, compiler, architecture,
-                     args.n_node_list, start_date, source_dir_base, res_dir_base)
+                     args.n_node_list, start_date, source_dir_base, res_dir_base,
+                     args.suite)
 
 # read the output file from each test and store timers in
 # hdf5 file with pandas format
@@ -292,6 +315,13 @@ for n_node in n_node_list:
             # Write dataframe to file perf_database_file
             # (overwrite if file exists)
             updated_df.to_hdf(path_hdf5 + perf_database_file, key='all_data', mode='w', format='table')
+            # Append the field solver timers to performance_log_artemis.txt
+            if args.suite == 'artemis':
+                log_line = ' '.join([year, month, day, current_run.input_file, compiler,
+                                     architecture, str(n_node), str(current_run.n_mpi_per_node),
+                                     str(current_run.n_omp)] +
+                                    read_artemis_perf(res_dir + output_filename, current_run.n_step)) + '\n'
+                write_perf_logfile(log_dir + 'performance_log_artemis.txt', log_line)
 
 # Extract sub-set of pandas data frame, write it to
 # csv file and copy this file to perf_logs repo
@@ -14,8 +14,9 @@ import os
 from functions_perftest import test_element
 
 
-def executable_name(compiler,architecture):
-    return 'perf_tests3d.' + compiler + '.TPROF.MTMPI.CUDA.QED.GPUCLOCK.ex'
+def executable_name(compiler,architecture,use_llg=False):
+    llg_suffix = '.LLG' if use_llg else ''
+    return 'perf_tests3d.' + compiler + '.TPROF.MTMPI.CUDA' + llg_suffix + '.QED.GPUCLOCK.ex'
 
 def get_config_command(compiler, architecture):
     config_command = ''
@@ -26,7 +27,7 @@ def get_config_command(compiler, architecture):
 # This function runs a batch script with
 # dependencies to perform the analysis
 # after all performance tests are done.
-def process_analysis(automated, cwd, compiler, architecture, n_node_list, start_date, path_source, path_results):
+def process_analysis(automated, cwd, compiler, architecture, n_node_list, start_date, path_source, path_results, suite='pic'):
 
     batch_string = '''#!/bin/bash
 #BSUB -P APH114
@@ -47,7 +48,8 @@ def process_analysis(automated, cwd, compiler, architecture, n_node_list, start_
         ' --n_node_list=' + '"' + n_node_list + '"' + \
         ' --start_date=' + start_date + \
         ' --path_source=' + path_source + \
-        ' --path_results=' + path_results
+        ' --path_results=' + path_results + \
+        ' --suite=' + suite
     if automated == True:
         batch_string += ' --automated'
     batch_string += '\n'
@@ -144,3 +146,42 @@ def get_test_list(n_repeat):
                                        n_step=1) )
     test_list = [copy.deepcopy(item) for item in test_list_unq for _ in range(n_repeat) ]
     return test_list
+
+# ARTEMIS suite: scaled-down LLG, London and macroscopic field solver tests.
+# Tests with use_llg=True run with the executable compiled with USE_LLG=TRUE.
+def get_artemis_test_list(n_repeat):
+    test_list_unq = []
+    test_list_unq.append( test_element(input_file='automated_test_7_llg_filter',
+                                       n_mpi_per_node=6,
+                                       n_omp=1,
+                                       n_cell=[1024, 8, 512],
+                                       max_grid_size=256,
+                                       blocking_factor=8,
+                                       n_step=20,
+                                       use_llg=True) )
+    test_list_unq.append( test_element(input_file='automated_test_8_magnon_photon',
+                                       n_mpi_per_node=6,
+                                       n_omp=1,
+                                       n_cell=[128, 512, 64],
+                                       max_grid_size=128,
+                                       blocking_factor=32,
+                                       n_step=20,
+                                       use_llg=True) )
+    test_list_unq.append( test_element(input_file='automated_test_9_london',
+                                       n_mpi_per_node=6,
+                                       n_omp=1,
+                                       n_cell=[128, 128, 1280],
+                                       max_grid_size=256,
+                                       blocking_factor=64,
+                                       n_step=50,
+                                       use_llg=False) )
+    test_list_unq.append( test_element(input_file='automated_test_10_macroscopic',
+                                       n_mpi_per_node=6,
+                                       n_omp=1,
+                                       n_cell=[256, 256, 2048],
+                                       max_grid_size=256,
+                                       blocking_factor=64,
+                                       n_step=20,
+                                       use_llg=False) )
+    test_list = [copy.deepcopy(item) for item in test_list_unq for _ in range(n_repeat) ]
+    return test_list
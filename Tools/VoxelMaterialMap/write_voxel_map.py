@@ -0,0 +1,95 @@
+# Copyright 2022
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+Write and read the voxel material maps used by material_map.file.
+
+The ids are given as a numpy array of shape (nx, ny, nz), indexed as ids[ix, iy, iz].
+
+Example: a sapphire substrate (id 1) below a niobium film (id 2), in vacuum (id 0),
+    ids = np.zeros((200, 100, 50), dtype=np.uint8)
+    ids[:, :, :20] = 1
+    ids[50:150, 40:60, 20:22] = 2
+    write_voxel_map('circuit.vmap', ids, lo=(-1e-3, -5e-4, -2.5e-4), hi=(1e-3, 5e-4, 2.5e-4))
+"""
+
+import argparse
+
+import numpy as np
+
+
+def write_voxel_map(filename, ids, lo, hi, encoding='rle'):
+    """Write the material ids to filename, raw or run-length encoded ('rle')."""
+    ids = np.asarray(ids)
+    if ids.ndim != 3:
+        raise ValueError('ids must be a 3D array indexed as ids[ix, iy, iz]')
+    if ids.min() < 0 or ids.max() > np.iinfo(np.uint16).max:
+        raise ValueError('ids must be in [0, 65535]')
+    dtype = np.dtype('<u1') if ids.max() <= np.iinfo(np.uint8).max else np.dtype('<u2')
+    vtype = 'uint8' if dtype.itemsize == 1 else 'uint16'
+    nx, ny, nz = ids.shape
+    # x is the fastest index in the file
+    data = np.ascontiguousarray(np.transpose(ids, (2, 1, 0)), dtype=dtype)
+    with open(filename, 'wb') as f:
+        f.write(b'WARPX_VOXEL_MAP 1\n')
+        f.write(f'{nx} {ny} {nz}\n'.encode())
+        f.write(' '.join(repr(float(v)) for v in list(lo) + list(hi)).encode() + b'\n')
+        f.write(f'{vtype} {encoding}\n'.encode())
+        if encoding == 'raw':
+            f.write(data.tobytes())
+        elif encoding == 'rle':
+            run_dtype = np.dtype([('count', '<u4'), ('id', dtype)])
+            rows = []
+            offsets = np.zeros(ny*nz + 1, dtype='<u8')
+            for irow, row in enumerate(data.reshape(ny*nz, nx)):
+                starts = np.flatnonzero(np.r_[True, row[1:] != row[:-1]])
+                runs = np.empty(len(starts), dtype=run_dtype)
+                runs['count'] = np.diff(np.append(starts, nx))
+                runs['id'] = row[starts]
+                rows.append(runs.tobytes())
+                offsets[irow + 1] = offsets[irow] + len(rows[-1])
+            f.write(offsets.tobytes())
+            for row in rows:
+                f.write(row)
+        else:
+            raise ValueError("encoding must be 'raw' or 'rle'")
+
+
+def read_voxel_map(filename):
+    """Return the ids, as an array indexed as ids[ix, iy, iz], and the bounds lo, hi."""
+    with open(filename, 'rb') as f:
+        magic = f.readline().split()
+        if magic != [b'WARPX_VOXEL_MAP', b'1']:
+            raise ValueError(f'{filename} is not a version 1 voxel material map')
+        nx, ny, nz = (int(v) for v in f.readline().split())
+        bounds = [float(v) for v in f.readline().split()]
+        vtype, encoding = (v.decode() for v in f.readline().split())
+        dtype = np.dtype('<u1') if vtype == 'uint8' else np.dtype('<u2')
+        if encoding == 'raw':
+            data = np.frombuffer(f.read(), dtype=dtype).reshape(nz, ny, nx)
+        else:
+            offsets = np.frombuffer(f.read(8*(ny*nz + 1)), dtype='<u8')
+            rows = f.read()
+            run_dtype = np.dtype([('count', '<u4'), ('id', dtype)])
+            data = np.empty((ny*nz, nx), dtype=dtype)
+            for irow in range(ny*nz):
+                runs = np.frombuffer(rows[offsets[irow]:offsets[irow + 1]], dtype=run_dtype)
+                data[irow] = np.repeat(runs['id'], runs['count'])
+            data = data.reshape(nz, ny, nx)
+    return np.transpose(data, (2, 1, 0)), bounds[:3], bounds[3:]
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(
+        description='Convert a numpy array of material ids (.npy, indexed as ids[ix, iy, iz]) '
+                    'to a voxel material map')
+    parser.add_argument('input', help='.npy file of the material ids')
+    parser.add_argument('output', help='voxel material map to write')
+    parser.add_argument('--lo', type=float, nargs=3, required=True, help='xmin ymin zmin')
+    parser.add_argument('--hi', type=float, nargs=3, required=True, help='xmax ymax zmax')
+    parser.add_argument('--encoding', choices=['raw', 'rle'], default='rle')
+    args = parser.parse_args()
+    write_voxel_map(args.output, np.load(args.input), args.lo, args.hi, args.encoding)
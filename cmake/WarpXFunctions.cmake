@@ -186,8 +186,15 @@ function(set_warpx_binary_name)
     if(WarpX_LIB)
         list(APPEND warpx_bin_names shared)
     endif()
+    if(WarpX_KERNEL_BENCHMARKS)
+        list(APPEND warpx_bin_names kernel_benchmarks)
+    endif()
     foreach(tgt IN LISTS warpx_bin_names)
-        set_target_properties(${tgt} PROPERTIES OUTPUT_NAME "warpx")
+        if(tgt STREQUAL kernel_benchmarks)
+            set_target_properties(${tgt} PROPERTIES OUTPUT_NAME "warpx_kernel_benchmarks")
+        else()
+            set_target_properties(${tgt} PROPERTIES OUTPUT_NAME "warpx")
+        endif()
         if(WarpX_DIMS STREQUAL RZ)
             set_property(TARGET ${tgt} APPEND_STRING PROPERTY OUTPUT_NAME ".RZ")
         else()
@@ -371,6 +378,7 @@ function(warpx_print_summary)
     message("    Embedded Boundary: ${WarpX_EB}")
     message("    GPU clock timers: ${WarpX_GPUCLOCK}")
     message("    IPO/LTO: ${WarpX_IPO}")
+    message("    Kernel benchmarks: ${WarpX_KERNEL_BENCHMARKS}")
     message("    LIB: ${WarpX_LIB}${LIB_TYPE}")
     message("    MPI: ${WarpX_MPI}")
     if(MPI)